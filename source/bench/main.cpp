@@ -0,0 +1,312 @@
+#include "return_engine/input_manager.h"
+#include "return_engine/input_recording.h"
+#include "return_engine/profiler.h"
+#include "return_engine/render_packet.h"
+#include "return_engine/scene.h"
+#include "return_engine/task_manager.h"
+
+#include "gfx/batch_renderer.h"
+#include "gfx/gl_recorder.h"
+#include "gfx/graphics_manager.h"
+#include "gfx/shader.h"
+#include "gfx/vertex_array_object.h"
+#include "gfx/vertex_buffer.h"
+#include "physics/bvh.h"
+#include "physics/rigid_body_world.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+//headless benchmarks of the engine's per frame stages on generated scenes
+//  gl goes through the recorder, so nothing needs a window or gpu and draw timings are the cpu side of submission
+//  prints one json object per line per scene and stage, to be compared between builds
+//  bench [--entities N] [--materials M] [--spheres fraction] [--frames F], otherwise a fixed set of scenes
+
+namespace
+{
+    constexpr float c_dt = 1.f / 60.f;
+    constexpr int c_mesh_count = 4;
+    //the rest are debug shapes, drawn one by one rather than batched
+    constexpr float c_mesh_fraction = 0.8f;
+
+    struct SceneConfig
+    {
+        int entities = 1000;
+        int materials = 8;
+        float sphere_fraction = 0.5f; //of colliders, the rest are boxes
+    };
+
+    struct SyntheticScene
+    {
+        std::vector<re::Entity> entities;
+        std::vector<bool> spheres; //collider of each entity
+    };
+
+    //entities scattered through a cube sized to keep density the same whatever the count
+    SyntheticScene generate_scene(const SceneConfig& config)
+    {
+        std::mt19937 random{7};
+        const float extent = 2.f * std::cbrt((float)config.entities);
+        std::uniform_real_distribution<float> position{-extent, extent};
+        std::uniform_real_distribution<float> unit{0.f, 1.f};
+        std::uniform_real_distribution<float> size{0.3f, 1.f};
+
+        SyntheticScene scene;
+        for (int i = 0; i < config.entities; ++i)
+        {
+            re::Entity entity;
+            entity.pos = {position(random), position(random) + extent + 1.f, position(random)};
+            const bool sphere = unit(random) < config.sphere_fraction;
+            const float radius = 0.5f * size(random);
+            if (unit(random) < c_mesh_fraction)
+            {
+                entity.scale = maths::Vector3::one() * radius;
+                entity.visual_component = std::make_unique<re::VAOComponent>(
+                    "mesh_" + std::to_string(random() % c_mesh_count), "material_" + std::to_string(random() % config.materials));
+            }
+            else if (sphere)
+            {
+                entity.visual_component = std::make_unique<re::SphereComponent>(radius, maths::Vector3{unit(random), unit(random), unit(random)}, 12);
+            }
+            else
+            {
+                entity.visual_component = std::make_unique<re::CubeComponent>(maths::Vector3::one() * (2.f * radius), maths::Vector3{unit(random), unit(random), unit(random)});
+            }
+            scene.entities.push_back(std::move(entity));
+            scene.spheres.push_back(sphere);
+        }
+        return scene;
+    }
+
+    //the meshes and materials entities refer to, with placeholder contents since nothing is really drawn
+    void add_resources(gfx::GraphicsManager& manager, const gfx::VertexBuffer& vertex_buffer, int materials)
+    {
+        gfx::VertexShader vertex_shader("vertex");
+        gfx::FragmentShader fragment_shader("fragment");
+        for (int i = 0; i < c_mesh_count; ++i)
+        {
+            manager.add(("mesh_" + std::to_string(i)).c_str(), std::make_unique<gfx::VertexArray>(vertex_buffer, nullptr, gfx::PrimitiveType::Triangle));
+        }
+        for (int i = 0; i < materials; ++i)
+        {
+            manager.add(("material_" + std::to_string(i)).c_str(), std::make_unique<gfx::ShaderProgram>(vertex_shader, fragment_shader));
+        }
+    }
+
+    void build_world(phys::RigidBodyWorld& world, const SyntheticScene& scene)
+    {
+        world.add_box({{-1000.f, -1.f, -1000.f}, {1000.f, 0.f, 1000.f}}, 0.f);
+        for (size_t i = 0; i < scene.entities.size(); ++i)
+        {
+            auto bounds = scene.entities[i].bounds();
+            if (scene.spheres[i])
+            {
+                world.add_sphere({(bounds.min + bounds.max) * 0.5f, 0.5f * (bounds.max.x - bounds.min.x)}, 1.f);
+            }
+            else
+            {
+                world.add_box(bounds, 1.f);
+            }
+        }
+    }
+
+    //bounds of the corners of the camera's view out to distance, the bvh only takes boxes
+    phys::AABB3 view_bounds(const re::Camera& camera, float distance)
+    {
+        phys::AABB3 bounds = {camera.pos, camera.pos};
+        for (maths::Vector2 corner : {maths::Vector2{-1.f, -1.f}, maths::Vector2{1.f, -1.f}, maths::Vector2{-1.f, 1.f}, maths::Vector2{1.f, 1.f}})
+        {
+            const auto ray = camera.ray(corner);
+            bounds = phys::merge(bounds, phys::AABB3{ray.origin + ray.direction * distance, ray.origin + ray.direction * distance});
+        }
+        return bounds;
+    }
+
+    double seconds_since(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    //times each call to function, returns its frame time summary
+    template<typename Function>
+    re::FrameTimeSummary measure(int frames, Function&& function)
+    {
+        std::vector<float> seconds;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            auto start = std::chrono::steady_clock::now();
+            function();
+            seconds.push_back((float)seconds_since(start));
+            re::profiler_next_frame();
+        }
+        return re::summarize_frame_times(seconds);
+    }
+
+    void report(const SceneConfig& config, const char* stage, const re::FrameTimeSummary& summary, const char* extra_name = nullptr, double extra = 0.0)
+    {
+        std::printf("{\"build\":\"%s\",\"stage\":\"%s\",\"entities\":%d,\"materials\":%d,\"sphere_fraction\":%.2f,"
+            "\"frames\":%d,\"min_ms\":%.4f,\"mean_ms\":%.4f,\"p99_ms\":%.4f",
+            CONFIGURATION_STR, stage, config.entities, config.materials, config.sphere_fraction,
+            summary.count, 1e3 * summary.min, 1e3 * summary.average, 1e3 * summary.p99);
+        if (extra_name)
+        {
+            std::printf(",\"%s\":%.6g", extra_name, extra);
+        }
+        std::printf("}\n");
+        std::fflush(stdout);
+    }
+
+    void run(const SceneConfig& config, int frames, re::TaskManager& tasks)
+    {
+        auto synthetic = generate_scene(config);
+
+        //gl objects have to go before the recorder does
+        gfx::GLRecorder recorder;
+        {
+            gfx::GraphicsManager manager;
+            maths::Vector3 vertices[3] = {};
+            gfx::VertexBuffer vertex_buffer(vertices, 3, {gfx::BufferAttributeType::Translation});
+            add_resources(manager, vertex_buffer, config.materials);
+
+            re::InputManager input;
+            re::Scene scene(manager, input);
+            for (auto& entity : synthetic.entities)
+            {
+                re::Entity copy;
+                copy.pos = entity.pos;
+                copy.scale = entity.scale;
+                copy.orientation = entity.orientation;
+                copy.visual_component = entity.visual_component->clone();
+                scene.add_entity(std::move(copy));
+            }
+            scene.relink_assets();
+
+            //simulating the scene and building its render packet, as a frame's task does
+            report(config, "scene_step", measure(frames, [&]
+            {
+                scene.begin_simulation(c_dt, tasks);
+                tasks.finish_tasks();
+            }));
+
+            //submitting the last packet built
+            input.update();
+            scene.begin_simulation(c_dt, tasks);
+            tasks.finish_tasks();
+            //extras are read once measuring is done, so each is worked out before its report
+            const auto draw = measure(frames, [&]
+            {
+                recorder.begin_frame();
+                scene.draw(1.f);
+            });
+            report(config, "draw", draw, "draw_calls", recorder.stats().draw_calls);
+
+            //sorting instances into batches on its own, relinked against the same resources
+            for (auto& entity : synthetic.entities)
+            {
+                entity.visual_component->relink(scene);
+            }
+            re::RenderPacket packet;
+            const auto batching = measure(frames, [&]
+            {
+                packet.clear();
+                for (auto& entity : synthetic.entities)
+                {
+                    entity.visual_component->draw(entity.transform(), scene, packet);
+                }
+                packet.finish();
+            });
+            report(config, "batching", batching, "batches", (double)packet.batches().size());
+
+            //refitting entity bounds and finding what's in view, the engine has no frustum culling of its own yet
+            phys::BVH bvh;
+            std::vector<phys::AABB3> bounds;
+            for (auto& entity : synthetic.entities)
+            {
+                bounds.push_back(entity.bounds());
+            }
+            bvh.build(bounds);
+            //looking in from the side at the middle of the cloud, seeing about half way through it
+            const float extent = 2.f * std::cbrt((float)config.entities);
+            re::Camera camera;
+            camera.pos = {0.f, extent + 1.f, 2.f * extent};
+            std::vector<int> visible;
+            const auto culling = measure(frames, [&]
+            {
+                for (size_t i = 0; i < synthetic.entities.size(); ++i)
+                {
+                    bounds[i] = synthetic.entities[i].bounds();
+                }
+                bvh.refit(bounds);
+                visible.clear();
+                bvh.query(view_bounds(camera, 2.f * extent), visible);
+            });
+            report(config, "culling", culling, "visible", (double)visible.size());
+
+            //saving and loading the scene through a file
+            const auto path = std::filesystem::temp_directory_path() / "return_bench.scene";
+            const auto save = measure(frames, [&] { scene.save(path); });
+            report(config, "save", save, "bytes", (double)std::filesystem::file_size(path));
+            report(config, "load", measure(frames, [&] { scene.load(path); }));
+            std::filesystem::remove(path);
+        }
+
+        //stepping a world with a body per entity, falling onto a floor
+        phys::RigidBodyWorld world;
+        build_world(world, synthetic);
+        world.set_parallel_for([&tasks](int count, const std::function<void(int)>& task)
+        {
+            tasks.run_tasks(task, 0, count);
+        });
+        size_t contacts = 0;
+        const auto physics = measure(frames, [&]
+        {
+            world.step(c_dt);
+            contacts += world.contacts().size();
+        });
+        report(config, "physics", physics, "manifolds_per_step", (double)contacts / std::max(frames, 1));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    SceneConfig single;
+    bool configured = false;
+    int frames = 60;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--entities") == 0)       { single.entities = atoi(argv[i + 1]); configured = true; }
+        else if (strcmp(argv[i], "--materials") == 0) { single.materials = std::max(1, atoi(argv[i + 1])); configured = true; }
+        else if (strcmp(argv[i], "--spheres") == 0)   { single.sphere_fraction = (float)atof(argv[i + 1]); configured = true; }
+        else if (strcmp(argv[i], "--frames") == 0)    { frames = std::max(1, atoi(argv[i + 1])); }
+        else
+        {
+            std::fprintf(stderr, "Unknown argument %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::vector<SceneConfig> configs = {{1000, 8, 0.5f}, {5000, 8, 0.5f}, {5000, 64, 0.5f}, {5000, 8, 0.f}, {5000, 8, 1.f}};
+    if (configured)
+    {
+        configs = {single};
+    }
+
+    //a worker per core besides the main thread, for the simulation task and physics islands
+    re::TaskManager tasks(std::max(1, (int)std::thread::hardware_concurrency() - 1));
+    re::profiler_set_thread_name("Main");
+    for (auto& config : configs)
+    {
+        run(config, frames, tasks);
+    }
+    return 0;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace re
+{
+    struct ContentQuery
+    {
+        std::string_view term;
+        int max_results = 50;
+        //relative to the root with / separators, only entries below it are searched
+        std::string_view directory;
+        //files without it are left out, directories are kept so they can be browsed into
+        std::string_view extension;
+        //score the file name rather than the whole relative path
+        bool filenames_only = false;
+    };
+
+    struct ContentResult
+    {
+        std::string relative_path; //with / separators
+        float score = 0.f; //as FuzzyMatcher::score, lower is better
+        bool directory = false;
+    };
+
+    //every file and directory under a root, for fuzzy searching without scoring every path
+    //  paths are kept in a trie of their components, so listing a directory doesn't touch the disk
+    //  every three character sequence of the case folded paths indexes the entries containing it, which bounds how
+    //  well an entry could score, so a search only scores entries that could still make the top results
+    //  the first scan runs on a background thread, until it's finished searches find nothing
+    class ContentIndex
+    {
+    public:
+        explicit ContentIndex(const std::filesystem::path& root);
+        ~ContentIndex();
+        ContentIndex(const ContentIndex&) = delete;
+        ContentIndex& operator=(const ContentIndex&) = delete;
+
+        bool ready() const;
+        const std::filesystem::path& root() const;
+        int entry_count() const;
+
+        //re-reads these paths from disk, as reported by a file watcher, paths outside the root are ignored
+        //  changes before the first scan finishes are applied after it
+        void update(const std::vector<std::filesystem::path>& changed);
+
+        //best results first, ties in path order
+        std::vector<ContentResult> search(const ContentQuery&) const;
+        //entries directly in a directory, in name order
+        std::vector<ContentResult> list(std::string_view directory) const;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> m_impl;
+    };
+}
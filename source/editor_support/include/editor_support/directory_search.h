@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace re
+{
+    struct DirectorySearchResult
+    {
+        std::filesystem::path path;
+        float score = 0.f; //as FuzzyMatcher::score of the file name, lower is better
+        bool directory = false;
+    };
+
+    //fuzzy searches a directory's file names on a background thread, handing results over as they're scored
+    //  every start() gets a new generation, the walk in progress notices and stops, and anything it had
+    //  already found is dropped when taken rather than mixed into the new search
+    //  the last completed walk is kept, so searching the same directory for a different term only rescores
+    class DirectorySearch
+    {
+    public:
+        DirectorySearch();
+        ~DirectorySearch();
+        DirectorySearch(const DirectorySearch&) = delete;
+        DirectorySearch& operator=(const DirectorySearch&) = delete;
+
+        //files without the extension are left out, directories are kept so they can be browsed into
+        void start(const std::filesystem::path& directory, std::string term, bool recursive, std::string extension = {});
+        void cancel();
+
+        //merges results found since the last call into results, which stays sorted by score, returns true if any were added
+        //  results from an older generation are cleared first
+        bool take_results(std::vector<DirectorySearchResult>& results);
+
+        bool searching() const;
+        uint64_t generation() const { return m_generation; }
+
+    private:
+        struct Job
+        {
+            std::filesystem::path directory;
+            std::string term;
+            bool recursive = false;
+            std::string extension;
+        };
+        struct Entry
+        {
+            std::filesystem::path path;
+            bool directory;
+        };
+
+        void thread_loop();
+        void run(const Job& job, uint64_t generation);
+        //returns false if a newer search has started
+        bool publish(std::vector<DirectorySearchResult>& batch, uint64_t generation);
+
+        std::thread m_thread;
+        bool m_running = true;
+        std::atomic<uint64_t> m_generation = 0;
+
+        //guards everything below, found only holds results for the current generation
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        Job m_job;
+        uint64_t m_started_generation = 0;
+        uint64_t m_finished_generation = 0;
+        std::vector<DirectorySearchResult> m_found;
+
+        //only touched by the caller
+        uint64_t m_taken_generation = 0;
+
+        //only touched by the search thread
+        Job m_walked;
+        std::vector<Entry> m_walked_entries;
+        bool m_walk_complete = false;
+    };
+}
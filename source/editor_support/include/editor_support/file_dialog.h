@@ -20,4 +20,6 @@ namespace re
     void open_file_dialog(const FileDialogContext&);
     std::optional<FileDialogResult> update_file_dialog();
     bool file_dialog_open();
+    //keeps the index recursive searches use up to date, with changes from a file watcher
+    void file_dialog_files_changed(const std::vector<std::filesystem::path>& paths);
 }
\ No newline at end of file
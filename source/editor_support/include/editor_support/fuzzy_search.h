@@ -1,5 +1,12 @@
 #pragma once
 
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
 namespace re
 {
     //substitution cost is relative to addition/subtraction cost of 1
@@ -7,4 +14,36 @@ namespace re
     
     //substitution cost is relative to addition/subtraction cost of 1
     float adjusted_levenshtein_distance(const char* text, const char* search_term, float substitution_cost = 1.f);
-}
\ No newline at end of file
+
+    //runs task(i) for every i in [0, count), in any order on any threads, and returns once they've all finished
+    using ParallelFor = std::function<void(int count, const std::function<void(int)>& task)>;
+
+    //a search term prepared once for scoring against many candidates
+    //  scores like adjusted_levenshtein_distance with unit costs, but ignoring case for the substring test too
+    //  terms up to 64 characters use Myers' bit-parallel distance, one pass of a few word operations per text character
+    //  nothing is allocated unless the term or text is very long
+    class FuzzyMatcher
+    {
+    public:
+        explicit FuzzyMatcher(std::string_view search_term);
+
+        //scores above max_score are returned as infinity, stopping as soon as the distance is known to exceed it
+        float score(std::string_view text, float max_score = INFINITY) const;
+        //case insensitive edit distance, or max_distance + 1 once it's known to be further than that
+        int distance(std::string_view text, int max_distance = INT32_MAX) const;
+
+        //scores[i] = score(texts[i]), split into tasks of a few thousand texts when given a parallel_for
+        void score_all(const std::vector<std::string_view>& texts, std::vector<float>& scores,
+            float max_score = INFINITY, const ParallelFor& parallel_for = {}) const;
+
+        const std::string& search_term() const { return m_term; }
+
+    private:
+        int distance_folded(std::string_view folded_text, int max_distance) const;
+
+        std::string m_term; //case folded
+        //bit i of m_masks[c] is set where character i of the term folds to the same as c
+        uint64_t m_masks[256] = {};
+        bool m_bit_parallel = false;
+    };
+}
@@ -0,0 +1,494 @@
+#include "content_index.h"
+
+#include "fuzzy_search.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace re
+{
+    //Private functions
+
+    namespace
+    {
+        //one per file or directory, node 0 is the root
+        struct Node
+        {
+            std::string name;
+            std::string path; //relative to the root
+            int parent = -1;
+            std::vector<int> children; //in name order
+            bool directory = false;
+            bool used = false;
+        };
+
+        //three case folded characters
+        using Trigram = uint32_t;
+
+        std::vector<Trigram> trigrams_of(std::string_view text)
+        {
+            std::vector<Trigram> trigrams;
+            for (size_t i = 0; i + 3 <= text.size(); ++i)
+            {
+                trigrams.push_back(
+                    (Trigram)(unsigned char)tolower((unsigned char)text[i]) << 16 |
+                    (Trigram)(unsigned char)tolower((unsigned char)text[i + 1]) << 8 |
+                    (Trigram)(unsigned char)tolower((unsigned char)text[i + 2]));
+            }
+            std::sort(trigrams.begin(), trigrams.end());
+            trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+            return trigrams;
+        }
+
+        //the trie and trigram index, not thread safe
+        class Tree
+        {
+        public:
+            Tree()
+            {
+                m_nodes.push_back({});
+                m_nodes[0].directory = true;
+                m_nodes[0].used = true;
+            }
+
+            //adds the entry and any missing directories above it
+            int add(std::string_view relative_path, bool directory)
+            {
+                int node = 0;
+                size_t start = 0;
+                while (start < relative_path.size())
+                {
+                    size_t end = relative_path.find('/', start);
+                    if (end == std::string_view::npos)
+                    {
+                        end = relative_path.size();
+                    }
+                    const bool last = end == relative_path.size();
+                    node = add_child(node, relative_path.substr(start, end - start), !last || directory);
+                    start = end + 1;
+                }
+                return node;
+            }
+
+            //the node for a path, -1 if there isn't one
+            int find(std::string_view relative_path) const
+            {
+                int node = 0;
+                size_t start = 0;
+                while (node != -1 && start < relative_path.size())
+                {
+                    size_t end = relative_path.find('/', start);
+                    if (end == std::string_view::npos)
+                    {
+                        end = relative_path.size();
+                    }
+                    node = find_child(node, relative_path.substr(start, end - start));
+                    start = end + 1;
+                }
+                return node;
+            }
+
+            //removes a node and everything under it
+            void remove(int node)
+            {
+                if (node <= 0)
+                {
+                    return;
+                }
+                while (!m_nodes[node].children.empty())
+                {
+                    remove(m_nodes[node].children.back());
+                }
+
+                auto& entry = m_nodes[node];
+                for (auto trigram : trigrams_of(entry.path))
+                {
+                    auto& list = m_trigrams[trigram];
+                    auto it = std::find(list.begin(), list.end(), node);
+                    *it = list.back();
+                    list.pop_back();
+                    if (list.empty())
+                    {
+                        m_trigrams.erase(trigram);
+                    }
+                }
+
+                auto& siblings = m_nodes[entry.parent].children;
+                siblings.erase(std::find(siblings.begin(), siblings.end(), node));
+                entry = {};
+                m_free_nodes.push_back(node);
+                --m_entry_count;
+            }
+
+            //everything under a directory, recursively
+            void add_tree(const std::filesystem::path& root, const std::filesystem::path& directory)
+            {
+                std::error_code error;
+                for (auto it = std::filesystem::recursive_directory_iterator(directory, error);
+                    !error && it != std::filesystem::recursive_directory_iterator();
+                    it.increment(error))
+                {
+                    //files can vanish mid scan, the watcher reports them later
+                    std::error_code entry_error;
+                    const bool is_directory = it->is_directory(entry_error);
+                    if (!entry_error)
+                    {
+                        add(it->path().lexically_relative(root).generic_string(), is_directory);
+                    }
+                }
+            }
+
+            const Node& node(int index) const { return m_nodes[index]; }
+            int node_count() const { return (int)m_nodes.size(); }
+            int entry_count() const { return m_entry_count; }
+
+            const std::vector<int>* entries_with(Trigram trigram) const
+            {
+                auto it = m_trigrams.find(trigram);
+                return it == m_trigrams.end() ? nullptr : &it->second;
+            }
+
+        private:
+            int find_child(int parent, std::string_view name) const
+            {
+                auto& children = m_nodes[parent].children;
+                auto it = std::lower_bound(children.begin(), children.end(), name, [&](int child, std::string_view name)
+                {
+                    return m_nodes[child].name < name;
+                });
+                return it != children.end() && m_nodes[*it].name == name ? *it : -1;
+            }
+
+            int add_child(int parent, std::string_view name, bool directory)
+            {
+                int child = find_child(parent, name);
+                if (child != -1)
+                {
+                    m_nodes[child].directory = directory;
+                    return child;
+                }
+
+                if (m_free_nodes.empty())
+                {
+                    child = (int)m_nodes.size();
+                    m_nodes.emplace_back();
+                }
+                else
+                {
+                    child = m_free_nodes.back();
+                    m_free_nodes.pop_back();
+                }
+
+                auto& entry = m_nodes[child];
+                entry.name = name;
+                entry.path = parent == 0 ? std::string(name) : m_nodes[parent].path + "/" + std::string(name);
+                entry.parent = parent;
+                entry.directory = directory;
+                entry.used = true;
+                for (auto trigram : trigrams_of(entry.path))
+                {
+                    m_trigrams[trigram].push_back(child);
+                }
+
+                auto& children = m_nodes[parent].children;
+                auto position = std::lower_bound(children.begin(), children.end(), name, [&](int other, std::string_view name)
+                {
+                    return m_nodes[other].name < name;
+                });
+                children.insert(position, child);
+                ++m_entry_count;
+                return child;
+            }
+
+            std::vector<Node> m_nodes;
+            std::vector<int> m_free_nodes;
+            std::unordered_map<Trigram, std::vector<int>> m_trigrams;
+            int m_entry_count = 0;
+        };
+
+        bool has_extension(std::string_view name, std::string_view extension)
+        {
+            return name.size() >= extension.size() && name.substr(name.size() - extension.size()) == extension;
+        }
+    }
+
+    //ContentIndex =====================================================================
+
+    struct ContentIndex::Impl
+    {
+        std::filesystem::path root;
+        std::thread thread;
+        std::atomic<bool> ready = false;
+
+        mutable std::mutex mutex;
+        Tree tree;
+        std::vector<std::filesystem::path> pending; //changes reported before the scan finished
+
+        void scan();
+        void apply_change(const std::filesystem::path& path);
+        //relative path with / separators, empty if outside the root
+        std::string relative(const std::filesystem::path& path) const;
+    };
+
+    void ContentIndex::Impl::scan()
+    {
+        Tree scanned;
+        scanned.add_tree(root, root);
+
+        std::lock_guard lock(mutex);
+        tree = std::move(scanned);
+        for (auto& path : pending)
+        {
+            apply_change(path);
+        }
+        pending.clear();
+        ready = true;
+    }
+
+    void ContentIndex::Impl::apply_change(const std::filesystem::path& path)
+    {
+        const auto relative_path = relative(path);
+        if (relative_path.empty())
+        {
+            return;
+        }
+
+        std::error_code error;
+        const auto status = std::filesystem::status(path, error);
+        if (std::filesystem::exists(status))
+        {
+            const bool directory = std::filesystem::is_directory(status);
+            tree.add(relative_path, directory);
+            if (directory)
+            {
+                //moved in with its contents
+                tree.add_tree(root, path);
+            }
+            return;
+        }
+
+        tree.remove(tree.find(relative_path));
+
+        //a directory deleted with its files is only reported through its files
+        auto parent = std::filesystem::path(relative_path).parent_path();
+        while (!parent.empty() && !std::filesystem::exists(root / parent, error))
+        {
+            tree.remove(tree.find(parent.generic_string()));
+            parent = parent.parent_path();
+        }
+    }
+
+    std::string ContentIndex::Impl::relative(const std::filesystem::path& path) const
+    {
+        auto relative_path = path.lexically_normal().lexically_relative(root).generic_string();
+        if (relative_path.empty() || relative_path == "." || relative_path.starts_with(".."))
+        {
+            return {};
+        }
+        return relative_path;
+    }
+
+    ContentIndex::ContentIndex(const std::filesystem::path& root)
+        : m_impl(std::make_unique<Impl>())
+    {
+        m_impl->root = root.lexically_normal();
+        m_impl->thread = std::thread(&Impl::scan, m_impl.get());
+    }
+
+    ContentIndex::~ContentIndex()
+    {
+        m_impl->thread.join();
+    }
+
+    bool ContentIndex::ready() const
+    {
+        return m_impl->ready;
+    }
+
+    const std::filesystem::path& ContentIndex::root() const
+    {
+        return m_impl->root;
+    }
+
+    int ContentIndex::entry_count() const
+    {
+        std::lock_guard lock(m_impl->mutex);
+        return m_impl->tree.entry_count();
+    }
+
+    void ContentIndex::update(const std::vector<std::filesystem::path>& changed)
+    {
+        std::lock_guard lock(m_impl->mutex);
+        if (!m_impl->ready)
+        {
+            m_impl->pending.insert(m_impl->pending.end(), changed.begin(), changed.end());
+            return;
+        }
+        for (auto& path : changed)
+        {
+            m_impl->apply_change(path);
+        }
+    }
+
+    std::vector<ContentResult> ContentIndex::search(const ContentQuery& query) const
+    {
+        std::lock_guard lock(m_impl->mutex);
+        const auto& tree = m_impl->tree;
+        std::vector<ContentResult> results;
+        const int start = tree.find(query.directory);
+        if (!m_impl->ready || query.max_results <= 0 || start == -1)
+        {
+            return results;
+        }
+
+        //how many of the term's trigrams each entry has
+        const FuzzyMatcher matcher(query.term);
+        const auto term_trigrams = trigrams_of(matcher.search_term());
+        std::vector<uint16_t> shared(tree.node_count(), 0);
+        for (auto trigram : term_trigrams)
+        {
+            if (auto entries = tree.entries_with(trigram))
+            {
+                for (int entry : *entries)
+                {
+                    ++shared[entry];
+                }
+            }
+        }
+
+        //the best score each entry could have without scoring it
+        //  only one with every trigram could contain the term, otherwise the score is a whole edit distance, which is
+        //  at least the difference in length, and each edit removes at most three of the term's trigrams
+        struct Candidate
+        {
+            int lower_bound;
+            int node;
+        };
+        std::vector<Candidate> candidates;
+        const int term_length = (int)query.term.size();
+        const int trigram_count = (int)term_trigrams.size();
+        auto add_candidate = [&](int index)
+        {
+            const auto& node = tree.node(index);
+            if (!node.directory && !has_extension(node.name, query.extension))
+            {
+                return;
+            }
+
+            const int text_length = (int)(query.filenames_only ? node.name.size() : node.path.size());
+            int lower_bound = 0;
+            if (text_length < term_length || shared[index] < trigram_count)
+            {
+                const int missing_trigrams = trigram_count - shared[index];
+                lower_bound = std::max({1, std::abs(text_length - term_length), (missing_trigrams + 2) / 3});
+            }
+            candidates.push_back({lower_bound, index});
+        };
+        if (start == 0)
+        {
+            for (int index = 1; index < tree.node_count(); ++index)
+            {
+                if (tree.node(index).used)
+                {
+                    add_candidate(index);
+                }
+            }
+        }
+        else
+        {
+            std::vector<int> stack(tree.node(start).children);
+            while (!stack.empty())
+            {
+                const int index = stack.back();
+                stack.pop_back();
+                stack.insert(stack.end(), tree.node(index).children.begin(), tree.node(index).children.end());
+                add_candidate(index);
+            }
+        }
+
+        //counting sort by lower bound, they're small
+        std::vector<Candidate> sorted(candidates.size());
+        {
+            int max_bound = 0;
+            for (auto& candidate : candidates)
+            {
+                max_bound = std::max(max_bound, candidate.lower_bound);
+            }
+            std::vector<int> offsets(max_bound + 2, 0);
+            for (auto& candidate : candidates)
+            {
+                ++offsets[candidate.lower_bound + 1];
+            }
+            for (int bound = 1; bound < (int)offsets.size(); ++bound)
+            {
+                offsets[bound] += offsets[bound - 1];
+            }
+            for (auto& candidate : candidates)
+            {
+                sorted[offsets[candidate.lower_bound]++] = candidate;
+            }
+        }
+
+        //keep the best so far in a heap with the worst on top, its score caps the rest
+        auto worse = [](const ContentResult& lhs, const ContentResult& rhs)
+        {
+            return lhs.score != rhs.score ? lhs.score < rhs.score : lhs.relative_path < rhs.relative_path;
+        };
+        for (auto& candidate : sorted)
+        {
+            const bool full = (int)results.size() == query.max_results;
+            if (full && (float)candidate.lower_bound > results.front().score)
+            {
+                //sorted, nothing left can do better
+                break;
+            }
+
+            const auto& node = tree.node(candidate.node);
+            const float score = matcher.score(query.filenames_only ? node.name : node.path, full ? results.front().score : INFINITY);
+            if (score == INFINITY)
+            {
+                continue;
+            }
+            ContentResult result = {node.path, score, node.directory};
+            if (full)
+            {
+                if (!worse(result, results.front()))
+                {
+                    continue;
+                }
+                std::pop_heap(results.begin(), results.end(), worse);
+                results.back() = std::move(result);
+            }
+            else
+            {
+                results.push_back(std::move(result));
+            }
+            std::push_heap(results.begin(), results.end(), worse);
+        }
+
+        std::sort(results.begin(), results.end(), worse);
+        return results;
+    }
+
+    std::vector<ContentResult> ContentIndex::list(std::string_view directory) const
+    {
+        std::lock_guard lock(m_impl->mutex);
+        std::vector<ContentResult> results;
+        const int node = m_impl->tree.find(directory);
+        if (node == -1)
+        {
+            return results;
+        }
+        for (int child : m_impl->tree.node(node).children)
+        {
+            auto& entry = m_impl->tree.node(child);
+            results.push_back({entry.path, 0.f, entry.directory});
+        }
+        return results;
+    }
+}
@@ -0,0 +1,210 @@
+#include "directory_search.h"
+
+#include "fuzzy_search.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace re
+{
+    namespace
+    {
+        //results are handed over in batches, at least this often while a search is running
+        constexpr int c_batch_size = 256;
+        constexpr auto c_batch_interval = std::chrono::milliseconds(15);
+    }
+
+    //Private functions
+
+    static bool better(const DirectorySearchResult& lhs, const DirectorySearchResult& rhs)
+    {
+        return lhs.score != rhs.score ? lhs.score < rhs.score : lhs.path < rhs.path;
+    }
+
+    //DirectorySearch =====================================================================
+
+    DirectorySearch::DirectorySearch()
+    {
+        m_thread = std::thread(&DirectorySearch::thread_loop, this);
+    }
+
+    DirectorySearch::~DirectorySearch()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_running = false;
+            ++m_generation;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+
+    void DirectorySearch::start(const std::filesystem::path& directory, std::string term, bool recursive, std::string extension)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_job = {directory, std::move(term), recursive, std::move(extension)};
+            ++m_generation;
+            m_found.clear();
+        }
+        m_wake.notify_one();
+    }
+
+    void DirectorySearch::cancel()
+    {
+        std::lock_guard lock(m_mutex);
+        ++m_generation;
+        //nothing will run for it, so it's already finished
+        m_started_generation = m_generation;
+        m_finished_generation = m_generation;
+        m_job = {};
+        m_found.clear();
+    }
+
+    bool DirectorySearch::take_results(std::vector<DirectorySearchResult>& results)
+    {
+        std::vector<DirectorySearchResult> found;
+        uint64_t generation;
+        {
+            std::lock_guard lock(m_mutex);
+            generation = m_generation;
+            found.swap(m_found);
+        }
+
+        if (m_taken_generation != generation)
+        {
+            results.clear();
+            m_taken_generation = generation;
+        }
+        if (found.empty())
+        {
+            return false;
+        }
+
+        std::sort(found.begin(), found.end(), better);
+        const auto middle = results.insert(results.end(), std::make_move_iterator(found.begin()), std::make_move_iterator(found.end()));
+        std::inplace_merge(results.begin(), middle, results.end(), better);
+        return true;
+    }
+
+    bool DirectorySearch::searching() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_finished_generation != m_generation;
+    }
+
+    void DirectorySearch::thread_loop()
+    {
+        std::unique_lock lock(m_mutex);
+        while (true)
+        {
+            m_wake.wait(lock, [this] { return !m_running || m_started_generation != m_generation; });
+            if (!m_running)
+            {
+                return;
+            }
+
+            const Job job = m_job;
+            const uint64_t generation = m_generation;
+            m_started_generation = generation;
+
+            lock.unlock();
+            run(job, generation);
+            lock.lock();
+
+            if (m_generation == generation)
+            {
+                m_finished_generation = generation;
+            }
+        }
+    }
+
+    void DirectorySearch::run(const Job& job, uint64_t generation)
+    {
+        const FuzzyMatcher matcher(job.term);
+        std::vector<DirectorySearchResult> batch;
+        auto last_publish = std::chrono::steady_clock::now();
+        auto add = [&](const Entry& entry)
+        {
+            batch.push_back({entry.path, matcher.score(entry.path.filename().string()), entry.directory});
+            if ((int)batch.size() >= c_batch_size || std::chrono::steady_clock::now() - last_publish > c_batch_interval)
+            {
+                last_publish = std::chrono::steady_clock::now();
+                return publish(batch, generation);
+            }
+            return m_generation == generation;
+        };
+
+        //same listing as last time, only the term changed
+        const bool same_listing = m_walk_complete && m_walked.directory == job.directory &&
+            m_walked.recursive == job.recursive && m_walked.extension == job.extension;
+        if (same_listing)
+        {
+            for (auto& entry : m_walked_entries)
+            {
+                if (!add(entry))
+                {
+                    return;
+                }
+            }
+            publish(batch, generation);
+            return;
+        }
+
+        m_walked = job;
+        m_walked_entries.clear();
+        m_walk_complete = false;
+
+        auto visit = [&](const std::filesystem::directory_entry& file)
+        {
+            std::error_code error;
+            const bool directory = file.is_directory(error);
+            if (error || (!directory && !job.extension.empty() && file.path().extension() != job.extension))
+            {
+                return true;
+            }
+            m_walked_entries.push_back({file.path(), directory});
+            return add(m_walked_entries.back());
+        };
+
+        std::error_code error;
+        if (job.recursive)
+        {
+            for (auto it = std::filesystem::recursive_directory_iterator(job.directory, error);
+                !error && it != std::filesystem::recursive_directory_iterator();
+                it.increment(error))
+            {
+                if (!visit(*it))
+                {
+                    return;
+                }
+            }
+        }
+        else
+        {
+            for (auto it = std::filesystem::directory_iterator(job.directory, error);
+                !error && it != std::filesystem::directory_iterator();
+                it.increment(error))
+            {
+                if (!visit(*it))
+                {
+                    return;
+                }
+            }
+        }
+        m_walk_complete = true;
+        publish(batch, generation);
+    }
+
+    bool DirectorySearch::publish(std::vector<DirectorySearchResult>& batch, uint64_t generation)
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_generation != generation)
+        {
+            return false;
+        }
+        m_found.insert(m_found.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+        batch.clear();
+        return true;
+    }
+}
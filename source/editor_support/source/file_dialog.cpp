@@ -1,11 +1,13 @@
 #include "file_dialog.h"
 
-#include "fuzzy_search.h"
+#include "content_index.h"
+#include "directory_search.h"
 
 #include "imgui/imgui.h"
 #include "imgui/imgui_stdlib.h"
 
 #include <algorithm>
+#include <memory>
 
 namespace re
 {
@@ -14,21 +16,22 @@ namespace re
         Open,
         Save
     };
-    struct SearchResult
-    {
-        std::filesystem::path path;
-        float levenshtein_distance;
-    };
+    //recursive searches only score the best few of everything under the root
+    constexpr int c_max_recursive_results = 100;
 
     static FileDialogMode g_mode;
 
     static std::string g_search_string;
     static bool g_recursive_search;
-    static std::vector<SearchResult> g_search_results;
+    static std::vector<DirectorySearchResult> g_search_results;
 
     static std::filesystem::path g_current_path;
     static std::string g_file_name;
     static FileDialogContext g_context;
+    static std::unique_ptr<ContentIndex> g_index;
+    //walks directories off the main thread when the index can't answer
+    static std::unique_ptr<DirectorySearch> g_directory_search;
+    static bool g_streaming_results = false;
     
 
     bool current_path_is_sub_path_of_root(std::filesystem::path root_path)
@@ -43,10 +46,15 @@ namespace re
         g_context = context;
         g_search_string = "";
         g_search_results.clear();
+        g_streaming_results = false;
         if(!current_path_is_sub_path_of_root(context.root_path))
         {
             g_current_path = context.root_path;
         }
+        if(!g_index || g_index->root() != context.root_path.lexically_normal())
+        {
+            g_index = std::make_unique<ContentIndex>(context.root_path);
+        }
         ImGui::OpenPopup("File");
     }
     void save_file_dialog(const FileDialogContext& context)
@@ -61,37 +69,42 @@ namespace re
     }
 
     //update function
-    static void apply_search_to_path(const std::filesystem::path& path)
-    {
-        bool is_directory = std::filesystem::is_directory(path);
-        if (!is_directory && !g_context.extension.empty() && path.extension() != g_context.extension)
-        {
-            return;
-        }
-        g_search_results.push_back({
-            path,
-            adjusted_levenshtein_distance(path.filename().string().c_str(), g_search_string.c_str())
-            });
-    }
     static void apply_search()
     {
         g_search_results.clear();
-        if(g_recursive_search)
+        if(!g_directory_search)
         {
-            for(auto entry : std::filesystem::recursive_directory_iterator(g_current_path))
-            {
-                apply_search_to_path(entry.path());
-            }
+            g_directory_search = std::make_unique<DirectorySearch>();
         }
-        else
+        if(g_search_string.empty())
+        {
+            g_directory_search->cancel();
+            g_streaming_results = false;
+            return;
+        }
+
+        if(g_recursive_search && g_index && g_index->ready())
         {
-            for(auto entry : std::filesystem::directory_iterator(g_current_path))
+            g_directory_search->cancel();
+            g_streaming_results = false;
+
+            auto directory = std::filesystem::relative(g_current_path, g_index->root()).generic_string();
+            ContentQuery query;
+            query.term = g_search_string;
+            query.max_results = c_max_recursive_results;
+            query.directory = directory == "." ? "" : directory;
+            query.extension = g_context.extension;
+            query.filenames_only = true;
+            for(auto& found : g_index->search(query))
             {
-                apply_search_to_path(entry.path());
+                g_search_results.push_back({g_index->root() / found.relative_path, found.score, found.directory});
             }
+            return;
         }
 
-        std::sort(g_search_results.begin(), g_search_results.end(), [](auto& lhs, auto& rhs){ return lhs.levenshtein_distance < rhs.levenshtein_distance; });
+        //the index is still being built, or this is just one directory
+        g_directory_search->start(g_current_path, g_search_string, g_recursive_search, g_context.extension);
+        g_streaming_results = true;
     }
 
     std::optional<FileDialogResult> update_file_dialog()
@@ -110,19 +123,30 @@ namespace re
             if(ImGui::Button("^"))
             {
                 g_current_path = g_current_path.parent_path();
+                apply_search();
             }
             ImGui::EndDisabled();
 
             //search
-            bool search_string_updated = ImGui::InputText("Search", &g_search_string);
+            bool search_updated = ImGui::InputText("Search", &g_search_string);
             ImGui::SameLine();
-            ImGui::Checkbox("Recursive", &g_recursive_search);
-            if(search_string_updated)
+            search_updated |= ImGui::Checkbox("Recursive", &g_recursive_search);
+            if(search_updated)
             {
                 apply_search();
             }
+            if(g_streaming_results)
+            {
+                g_directory_search->take_results(g_search_results);
+                if(g_directory_search->searching())
+                {
+                    ImGui::SameLine();
+                    ImGui::TextUnformatted("Searching...");
+                }
+            }
 
             //list files/folders in current directory OR search results
+            bool directory_changed = false;
             if(ImGui::BeginListBox("files"))
             {
                 auto display_entry = [&](const std::filesystem::path& entry, bool is_directory)
@@ -134,7 +158,9 @@ namespace re
                     {
                         if(is_directory)
                         {
+                            //searched again after the list, which is iterating the results
                             g_current_path = entry;
+                            directory_changed = true;
                         }
                         else
                         {
@@ -160,13 +186,17 @@ namespace re
                 {
                     for(auto search_result : g_search_results)
                     {
-                        display_entry(search_result.path, std::filesystem::is_directory(search_result.path));
+                        display_entry(search_result.path, search_result.directory);
                         ImGui::SameLine();
-                        ImGui::Text("%f", search_result.levenshtein_distance);
+                        ImGui::Text("%f", search_result.score);
                     }
                 }
                 ImGui::EndListBox();
             }
+            if(directory_changed)
+            {
+                apply_search();
+            }
             
             //resolve and display full filename
             ImGui::InputText("Filename", &g_file_name);
@@ -210,4 +240,12 @@ namespace re
     {
         return ImGui::IsPopupOpen("File");
     }
+
+    void file_dialog_files_changed(const std::vector<std::filesystem::path>& paths)
+    {
+        if(g_index)
+        {
+            g_index->update(paths);
+        }
+    }
 }
\ No newline at end of file
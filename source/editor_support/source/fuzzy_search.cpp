@@ -1,5 +1,7 @@
 #include "fuzzy_search.h"
 
+#include <algorithm>
+#include <array>
 #include <assert.h>
 #include <cctype>
 #include <cstring>
@@ -7,45 +9,65 @@
 
 namespace re
 {
-    float levenshtein_distance(const char* s1, const char* s2, float substitution_cost)
+    namespace
     {
-        //see wikipedia page for explanation and original algorithm
-        const auto l1 = strlen(s1);
-        const auto columns = l1 + 1;
-        const auto l2 = strlen(s2);
-        const auto rows = l2 + 1;
+        //longer strings fall back to the heap
+        constexpr size_t c_stack_length = 256;
+        constexpr int c_texts_per_task = 2048;
+    }
 
-        //create a matrix of distances
-        std::vector<float> distances;
-        distances.resize(columns*rows, 0.f);
-        auto distance = [&distances, columns](int column, int row) -> float&
-        {
-            return distances[column + row * columns];
-        };
+    //Private functions
 
-        for(int column = 0; column < columns; ++column)
+    static char fold(char c)
+    {
+        return (char)tolower((unsigned char)c);
+    }
+
+    //distances between every prefix of s1 and the whole of s2 need only the previous row of the matrix
+    //  returns as soon as every entry in a row is above max_distance, as the final distance can only be larger
+    template<typename Equal>
+    static float two_row_distance(std::string_view s1, std::string_view s2, float substitution_cost, float max_distance, const Equal& equal)
+    {
+        std::array<float, c_stack_length * 2> stack_rows;
+        std::vector<float> heap_rows;
+        float* previous = stack_rows.data();
+        if (s2.size() + 1 > c_stack_length)
         {
-            distance(column, 0) = (float)column;
+            heap_rows.resize((s2.size() + 1) * 2);
+            previous = heap_rows.data();
         }
-        for(int row = 0; row < rows; ++row)
+        float* current = previous + s2.size() + 1;
+
+        for (size_t row = 0; row <= s2.size(); ++row)
         {
-            distance(0, row) = (float)row;
+            previous[row] = (float)row;
         }
-        
-        for(int column = 1; column < columns; ++column)
+        for (size_t column = 1; column <= s1.size(); ++column)
         {
-            for(int row = 1; row < rows; ++row)
+            current[0] = (float)column;
+            float row_min = current[0];
+            for (size_t row = 1; row <= s2.size(); ++row)
             {
-                const bool match = tolower(s1[column - 1]) == tolower(s2[row-1]);
-                const float row_shift = distance(column, row-1) + 1;
-                const float col_shift = distance(column-1, row) + 1;
-                const float d_shift = distance(column-1, row-1) + (match ? 0.f : substitution_cost);
-                distance(column, row) = 
-                    std::min(std::min(row_shift, col_shift), d_shift);
+                const bool match = equal(s1[column - 1], s2[row - 1]);
+                const float row_shift = current[row - 1] + 1;
+                const float col_shift = previous[row] + 1;
+                const float d_shift = previous[row - 1] + (match ? 0.f : substitution_cost);
+                current[row] = std::min(std::min(row_shift, col_shift), d_shift);
+                row_min = std::min(row_min, current[row]);
             }
+            if (row_min > max_distance)
+            {
+                return row_min;
+            }
+            std::swap(previous, current);
         }
+        return previous[s2.size()];
+    }
 
-        return distances.back();
+    float levenshtein_distance(const char* s1, const char* s2, float substitution_cost)
+    {
+        //see wikipedia page for explanation and original algorithm
+        return two_row_distance(s1, s2, substitution_cost, INFINITY, [](char a, char b) { return fold(a) == fold(b); });
     }
 
     float adjusted_levenshtein_distance(const char* text, const char* search_term, float substitution_cost)
@@ -60,4 +82,147 @@ namespace re
         }
         return levenshtein_distance(text, search_term, substitution_cost);
     }
-}
\ No newline at end of file
+
+    //FuzzyMatcher =====================================================================
+
+    FuzzyMatcher::FuzzyMatcher(std::string_view search_term)
+        : m_term(search_term)
+    {
+        std::transform(m_term.begin(), m_term.end(), m_term.begin(), fold);
+
+        m_bit_parallel = m_term.size() <= 64;
+        if (m_bit_parallel)
+        {
+            //both cases, so texts don't need folding first
+            for (size_t i = 0; i < m_term.size(); ++i)
+            {
+                const unsigned char c = (unsigned char)m_term[i];
+                m_masks[c] |= uint64_t(1) << i;
+                m_masks[(unsigned char)toupper(c)] |= uint64_t(1) << i;
+            }
+        }
+    }
+
+    float FuzzyMatcher::score(std::string_view text, float max_score) const
+    {
+        //fold the text once for both the substring test and the distance
+        std::array<char, c_stack_length> stack_text;
+        std::string heap_text;
+        char* folded = stack_text.data();
+        if (text.size() > c_stack_length)
+        {
+            heap_text.resize(text.size());
+            folded = heap_text.data();
+        }
+        std::transform(text.begin(), text.end(), folded, fold);
+        const std::string_view folded_text(folded, text.size());
+
+        if (folded_text.find(m_term) != std::string_view::npos)
+        {
+            //if search term is a substring then use alternative scoring, based on how much of the text we matched
+            const float score = text.empty() ? 0.f : 1.f - (float)m_term.size() / (float)text.size();
+            return score <= max_score ? score : INFINITY;
+        }
+
+        const int max_distance = max_score >= (float)INT32_MAX ? INT32_MAX - 1 : (int)std::floor(max_score);
+        const int distance = distance_folded(folded_text, max_distance);
+        return distance <= max_distance ? (float)distance : INFINITY;
+    }
+
+    int FuzzyMatcher::distance(std::string_view text, int max_distance) const
+    {
+        if (m_bit_parallel)
+        {
+            //the masks already match either case
+            return distance_folded(text, max_distance);
+        }
+
+        std::string folded(text);
+        std::transform(folded.begin(), folded.end(), folded.begin(), fold);
+        return distance_folded(folded, max_distance);
+    }
+
+    int FuzzyMatcher::distance_folded(std::string_view text, int max_distance) const
+    {
+        const int term_length = (int)m_term.size();
+        const int text_length = (int)text.size();
+        if (max_distance < INT32_MAX && std::abs(text_length - term_length) > max_distance)
+        {
+            return max_distance + 1;
+        }
+
+        if (!m_bit_parallel)
+        {
+            const float distance = two_row_distance(text, m_term, 1.f, (float)max_distance, std::equal_to<char>());
+            return distance > (float)max_distance ? max_distance + 1 : (int)distance;
+        }
+        if (term_length == 0)
+        {
+            return text_length;
+        }
+
+        //Myers' algorithm as Hyyrö formulated it for edit distance
+        //  one column of the distance matrix at a time, stored as bit vectors of whether each entry is one more
+        //  (positive) or one less (negative) than the one above, score tracks the bottom entry
+        const uint64_t last_bit = uint64_t(1) << (term_length - 1);
+        uint64_t positive = ~uint64_t(0);
+        uint64_t negative = 0;
+        int score = term_length;
+        for (int column = 0; column < text_length; ++column)
+        {
+            const uint64_t match = m_masks[(unsigned char)text[column]];
+            const uint64_t vertical = match | negative;
+            const uint64_t diagonal = (((match & positive) + positive) ^ positive) | match;
+            uint64_t horizontal_positive = negative | ~(diagonal | positive);
+            uint64_t horizontal_negative = positive & diagonal;
+
+            if (horizontal_positive & last_bit)
+            {
+                ++score;
+            }
+            else if (horizontal_negative & last_bit)
+            {
+                --score;
+            }
+
+            //the top row counts up across the columns
+            horizontal_positive = (horizontal_positive << 1) | 1;
+            horizontal_negative <<= 1;
+            positive = horizontal_negative | ~(vertical | horizontal_positive);
+            negative = horizontal_positive & vertical;
+
+            //each remaining column can lower the score by at most one
+            if (score - (text_length - column - 1) > max_distance)
+            {
+                return max_distance + 1;
+            }
+        }
+        return score;
+    }
+
+    void FuzzyMatcher::score_all(const std::vector<std::string_view>& texts, std::vector<float>& scores,
+        float max_score, const ParallelFor& parallel_for) const
+    {
+        scores.resize(texts.size());
+        const int count = (int)texts.size();
+        auto score_range = [&](int task)
+        {
+            const int end = std::min(count, (task + 1) * c_texts_per_task);
+            for (int i = task * c_texts_per_task; i < end; ++i)
+            {
+                scores[i] = score(texts[i], max_score);
+            }
+        };
+
+        const int task_count = (count + c_texts_per_task - 1) / c_texts_per_task;
+        if (!parallel_for || task_count <= 1)
+        {
+            for (int task = 0; task < task_count; ++task)
+            {
+                score_range(task);
+            }
+            return;
+        }
+        parallel_for(task_count, score_range);
+    }
+}
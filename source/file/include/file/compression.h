@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace file
+{
+    //lz4 style compression, fast to decompress rather than small
+    //  data is split into blocks compressed on their own, so blocks can be decompressed in any order or in parallel
+    //  a stream is a header then each block prefixed with its compressed and decompressed sizes
+    //  blocks that don't get smaller are stored as they are
+
+    constexpr size_t c_max_block_size = 64 * 1024;
+
+    //runs task(i) for every i in [0, count), in any order on any threads, and returns once they've all finished
+    using ParallelFor = std::function<void(int count, const std::function<void(int)>& task)>;
+
+    //appends input compressed to output, input must be no bigger than c_max_block_size
+    void compress_block(std::span<const uint8_t> input, std::vector<uint8_t>& output);
+    //output must be exactly the decompressed size, returns false if input is corrupt
+    bool decompress_block(std::span<const uint8_t> input, std::span<uint8_t> output);
+
+    //writes a stream header to output, then append blocks to it
+    void begin_compressed_stream(std::vector<uint8_t>& output);
+    void append_compressed_block(std::span<const uint8_t> input, std::vector<uint8_t>& output);
+
+    //true if bytes start with a stream header
+    bool is_compressed_stream(std::span<const uint8_t> bytes);
+    //nothing if the stream is corrupt, without parallel_for blocks are decompressed on the calling thread
+    std::optional<std::vector<uint8_t>> decompress_stream(std::span<const uint8_t> stream, const ParallelFor& parallel_for = {});
+}
@@ -5,6 +5,7 @@
 #include <filesystem>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -38,12 +39,21 @@ namespace file
     bool write_string_to_appdata(const char* relative_path, const char* string);
     bool write_string_to_absolute(const char* path, const char* string);
 
+    //Blocks writes a compressed stream (see compression.h), FileIn recognizes one and decompresses it whichever way it was opened
+    enum class Compression
+    {
+        None,
+        Blocks,
+    };
+
     class FileOut
     {
     public:
-        static FileOut from_data(const char* relative_path);
-        static FileOut from_app_data(const char* relative_path);
-        static FileOut from_absolute(const char* path);
+        static FileOut from_data(const char* relative_path, Compression compression = Compression::None);
+        static FileOut from_app_data(const char* relative_path, Compression compression = Compression::None);
+        static FileOut from_absolute(const char* path, Compression compression = Compression::None);
+        //appends to buffer rather than writing a file, buffer must outlive the FileOut
+        static FileOut to_memory(std::vector<uint8_t>& buffer, Compression compression = Compression::None);
         
         ~FileOut();
 
@@ -78,7 +88,8 @@ namespace file
         void write(const void*, size_t size);
 
     private:
-        FileOut(const char*);
+        FileOut(const char*, Compression);
+        FileOut(std::vector<uint8_t>&, Compression);
 
         template<typename T>
         void write(const T&);
@@ -93,6 +104,8 @@ namespace file
         static FileIn from_data(const char* relative_path);
         static FileIn from_app_data(const char* relative_path);
         static FileIn from_absolute(const char* path);
+        //reads bytes in place, they must outlive the FileIn unless they're a compressed stream
+        static FileIn from_memory(std::span<const uint8_t> bytes);
 
         ~FileIn();
 
@@ -128,6 +141,7 @@ namespace file
 
     private:
         FileIn(const char*);
+        FileIn(std::span<const uint8_t>);
 
         template<typename T>
         bool read(T&);
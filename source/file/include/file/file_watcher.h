@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace file
+{
+    struct FileWatcherSettings
+    {
+        //a file is only reported once it has gone this long without changing, so a save that writes in several
+        //steps is reported once when it's finished
+        std::chrono::milliseconds debounce{100};
+
+        //polling is used where native notifications aren't available, or when forced
+        bool force_polling = false;
+        std::chrono::milliseconds poll_interval{500};
+    };
+
+    //watches every file under a directory, recursively, from a background thread
+    //native notifications are used on linux (inotify), otherwise the directory is rescanned periodically
+    class FileWatcher
+    {
+    public:
+        FileWatcher(const std::filesystem::path& directory, FileWatcherSettings settings = {});
+        ~FileWatcher();
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+        //files created, modified or removed since the last call that have settled, never waits on the watcher thread
+        std::vector<std::filesystem::path> take_changes();
+
+        bool polling() const;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> m_impl;
+    };
+}
@@ -0,0 +1,298 @@
+#include "compression.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace file
+{
+    namespace
+    {
+        //"RECZ", then a version bumped whenever the block format changes
+        constexpr uint32_t c_magic = 0x5a434552;
+        constexpr uint32_t c_version = 1;
+        constexpr size_t c_header_size = 8;
+        constexpr size_t c_block_header_size = 8;
+        //set in a block's compressed size when it's stored uncompressed
+        constexpr uint32_t c_stored_flag = 0x80000000u;
+
+        constexpr size_t c_min_match = 4;
+        constexpr int c_hash_bits = 13;
+        //each run of this many positions without a match makes the search skip one more byte, so incompressible data is passed over quickly
+        constexpr int c_skip_shift = 5;
+    }
+
+    //Private functions
+
+    static uint32_t read_u32(const uint8_t* bytes)
+    {
+        uint32_t value;
+        memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+
+    static void append_u32(std::vector<uint8_t>& output, uint32_t value)
+    {
+        const size_t offset = output.size();
+        output.resize(offset + sizeof(value));
+        memcpy(output.data() + offset, &value, sizeof(value));
+    }
+
+    static uint32_t hash_sequence(uint32_t sequence)
+    {
+        return (sequence * 2654435761u) >> (32 - c_hash_bits);
+    }
+
+    //lengths that don't fit their 4 bits carry on in bytes of 255 and a final byte under it
+    static void append_length(std::vector<uint8_t>& output, size_t length)
+    {
+        for (; length >= 255; length -= 255)
+        {
+            output.push_back(255);
+        }
+        output.push_back((uint8_t)length);
+    }
+
+    static bool read_length(const uint8_t*& in, const uint8_t* in_end, size_t& length)
+    {
+        uint8_t byte;
+        do
+        {
+            if (in == in_end)
+            {
+                return false;
+            }
+            byte = *in++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    //a token of literal count and match length, the literals, then the match offset
+    //  the last sequence is only literals, the decompressor knows it's last by reaching the end of the input
+    static void append_sequence(std::vector<uint8_t>& output, const uint8_t* literals, size_t literal_count, size_t offset, size_t match_length)
+    {
+        const bool last = match_length == 0;
+        const size_t match_extra = last ? 0 : match_length - c_min_match;
+        output.push_back((uint8_t)((std::min<size_t>(literal_count, 15) << 4) | std::min<size_t>(match_extra, 15)));
+        if (literal_count >= 15)
+        {
+            append_length(output, literal_count - 15);
+        }
+        output.insert(output.end(), literals, literals + literal_count);
+        if (last)
+        {
+            return;
+        }
+
+        output.push_back((uint8_t)(offset & 0xff));
+        output.push_back((uint8_t)(offset >> 8));
+        if (match_extra >= 15)
+        {
+            append_length(output, match_extra - 15);
+        }
+    }
+
+    //Public functions
+
+    void compress_block(std::span<const uint8_t> input, std::vector<uint8_t>& output)
+    {
+        assert(input.size() <= c_max_block_size);
+        const uint8_t* source = input.data();
+        const size_t size = input.size();
+
+        //last position each hashed sequence was seen, blocks are small enough for positions to fit 16 bits
+        uint16_t table[1 << c_hash_bits] = {};
+        size_t anchor = 0;
+        size_t position = 0;
+        int misses = 0;
+        while (position + c_min_match <= size)
+        {
+            const uint32_t sequence = read_u32(source + position);
+            auto& entry = table[hash_sequence(sequence)];
+            const size_t candidate = entry;
+            entry = (uint16_t)position;
+            if (candidate >= position || read_u32(source + candidate) != sequence)
+            {
+                position += 1 + (misses++ >> c_skip_shift);
+                continue;
+            }
+
+            size_t length = c_min_match;
+            while (position + length < size && source[candidate + length] == source[position + length])
+            {
+                ++length;
+            }
+            append_sequence(output, source + anchor, position - anchor, position - candidate, length);
+            position += length;
+            anchor = position;
+            misses = 0;
+        }
+        append_sequence(output, source + anchor, size - anchor, 0, 0);
+    }
+
+    bool decompress_block(std::span<const uint8_t> input, std::span<uint8_t> output)
+    {
+        const uint8_t* in = input.data();
+        const uint8_t* const in_end = in + input.size();
+        uint8_t* out = output.data();
+        uint8_t* const out_end = out + output.size();
+
+        while (in < in_end)
+        {
+            const uint8_t token = *in++;
+            size_t literal_count = token >> 4;
+            if (literal_count == 15 && !read_length(in, in_end, literal_count))
+            {
+                return false;
+            }
+            if (literal_count > (size_t)(in_end - in) || literal_count > (size_t)(out_end - out))
+            {
+                return false;
+            }
+            memcpy(out, in, literal_count);
+            in += literal_count;
+            out += literal_count;
+            if (in == in_end)
+            {
+                break;
+            }
+
+            if (in_end - in < 2)
+            {
+                return false;
+            }
+            const size_t offset = in[0] | (in[1] << 8);
+            in += 2;
+            size_t length = token & 15;
+            if (length == 15 && !read_length(in, in_end, length))
+            {
+                return false;
+            }
+            length += c_min_match;
+            if (offset == 0 || offset > (size_t)(out - output.data()) || length > (size_t)(out_end - out))
+            {
+                return false;
+            }
+
+            //a match can overlap what it's copying, repeating a short run
+            const uint8_t* match = out - offset;
+            if (offset >= length)
+            {
+                memcpy(out, match, length);
+            }
+            else
+            {
+                for (size_t i = 0; i < length; ++i)
+                {
+                    out[i] = match[i];
+                }
+            }
+            out += length;
+        }
+        return out == out_end;
+    }
+
+    void begin_compressed_stream(std::vector<uint8_t>& output)
+    {
+        append_u32(output, c_magic);
+        append_u32(output, c_version);
+    }
+
+    void append_compressed_block(std::span<const uint8_t> input, std::vector<uint8_t>& output)
+    {
+        const size_t header = output.size();
+        output.resize(header + c_block_header_size);
+        compress_block(input, output);
+
+        uint32_t stored_size = (uint32_t)(output.size() - header - c_block_header_size);
+        if (stored_size >= input.size())
+        {
+            output.resize(header + c_block_header_size);
+            output.insert(output.end(), input.begin(), input.end());
+            stored_size = (uint32_t)input.size() | c_stored_flag;
+        }
+        const uint32_t raw_size = (uint32_t)input.size();
+        memcpy(output.data() + header, &stored_size, sizeof(stored_size));
+        memcpy(output.data() + header + sizeof(stored_size), &raw_size, sizeof(raw_size));
+    }
+
+    bool is_compressed_stream(std::span<const uint8_t> bytes)
+    {
+        return bytes.size() >= c_header_size && read_u32(bytes.data()) == c_magic;
+    }
+
+    std::optional<std::vector<uint8_t>> decompress_stream(std::span<const uint8_t> stream, const ParallelFor& parallel_for)
+    {
+        if (!is_compressed_stream(stream) || read_u32(stream.data() + 4) != c_version)
+        {
+            return {};
+        }
+
+        //find every block first, so each knows where it goes and they can be decompressed independently
+        struct Block
+        {
+            size_t input;
+            size_t output;
+            uint32_t stored_size;
+            uint32_t raw_size;
+        };
+        std::vector<Block> blocks;
+        size_t total = 0;
+        for (size_t offset = c_header_size; offset < stream.size();)
+        {
+            if (stream.size() - offset < c_block_header_size)
+            {
+                return {};
+            }
+            Block block;
+            block.stored_size = read_u32(stream.data() + offset);
+            block.raw_size = read_u32(stream.data() + offset + 4);
+            block.input = offset + c_block_header_size;
+            block.output = total;
+            const size_t stored_size = block.stored_size & ~c_stored_flag;
+            if (block.raw_size > c_max_block_size || stored_size > stream.size() - block.input ||
+                ((block.stored_size & c_stored_flag) && stored_size != block.raw_size))
+            {
+                return {};
+            }
+            blocks.push_back(block);
+            total += block.raw_size;
+            offset = block.input + stored_size;
+        }
+
+        std::vector<uint8_t> output(total);
+        std::vector<uint8_t> failed(blocks.size(), false);
+        auto decompress = [&](int index)
+        {
+            auto& block = blocks[index];
+            const auto input = stream.subspan(block.input, block.stored_size & ~c_stored_flag);
+            const auto destination = std::span(output).subspan(block.output, block.raw_size);
+            if (block.stored_size & c_stored_flag)
+            {
+                std::copy(input.begin(), input.end(), destination.begin());
+            }
+            else if (!decompress_block(input, destination))
+            {
+                failed[index] = true;
+            }
+        };
+        if (parallel_for)
+        {
+            parallel_for((int)blocks.size(), decompress);
+        }
+        else
+        {
+            for (int i = 0; i < (int)blocks.size(); ++i)
+            {
+                decompress(i);
+            }
+        }
+
+        if (std::find(failed.begin(), failed.end(), (uint8_t)true) != failed.end())
+        {
+            return {};
+        }
+        return output;
+    }
+}
@@ -1,9 +1,12 @@
 #include "file.h"
+#include "compression.h"
 
 #include "maths/maths.h"
 #include "maths/vector2.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <cstdlib>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
@@ -15,13 +18,67 @@ namespace file
 
     void create_missing_directories(const std::filesystem::path& path)
     {
+        //failing here leaves opening the file to fail and report it
         auto parent_path = path.parent_path();
-        if (!std::filesystem::exists(parent_path))
+        std::error_code error;
+        if (!parent_path.empty() && !std::filesystem::exists(parent_path, error))
         {
-            std::filesystem::create_directories(parent_path);
+            std::filesystem::create_directories(parent_path, error);
         }
     }
 
+    static std::optional<std::string> get_environment_variable(const char* name)
+    {
+#if defined(_MSC_VER)
+        //getenv is flagged as unsafe by msvc
+        char* value = nullptr;
+        size_t length = 0;
+        if (_dupenv_s(&value, &length, name) != 0 || value == nullptr)
+        {
+            return {};
+        }
+        std::string result = value;
+        free(value);
+        return result;
+#else
+        const char* value = std::getenv(name);
+        if (value == nullptr)
+        {
+            return {};
+        }
+        return std::string(value);
+#endif
+    }
+
+    static std::filesystem::path get_appdata_root()
+    {
+        //per user location for files the engine generates itself, e.g caches
+#if defined(_WIN32)
+        auto base = get_environment_variable("APPDATA");
+#else
+        auto base = get_environment_variable("XDG_DATA_HOME");
+        if (!base || base->empty())
+        {
+            base = get_environment_variable("HOME");
+            if (base && !base->empty())
+            {
+                *base += "/.local/share";
+            }
+        }
+#endif
+        if (!base || base->empty())
+        {
+            //nowhere better to put it, keep it next to the data folder
+            auto fallback = std::filesystem::current_path();
+            fallback += "/appdata";
+            return fallback;
+        }
+
+        std::filesystem::path result = *base;
+        result += "/Return";
+        return result;
+    }
+
     //Public functions
 
     std::filesystem::path get_data_path(const char* relative_path)
@@ -31,10 +88,14 @@ namespace file
         result += relative_path;
         return result;
     }
-    std::filesystem::path get_appdata_path(const char* /*relative_path*/)
+    std::filesystem::path get_appdata_path(const char* relative_path)
     {
-        assert(!"get_appdata_path() not implemented yet!");
-        return std::filesystem::path();
+        static const auto root = get_appdata_root();
+
+        auto result = root;
+        result += "/";
+        result += relative_path;
+        return result;
     }
 
     std::optional<std::string> read_string_from_data(const char* relative_path)
@@ -72,6 +133,7 @@ namespace file
     }
     bool write_string_to_absolute(const char* path, const char* string)
     {
+        create_missing_directories(path);
         std::ofstream file(path);
         if(!file.good())
         {
@@ -87,36 +149,96 @@ namespace file
     struct FileOut::Impl
     {
         std::ofstream file;
+        std::vector<uint8_t>* memory = nullptr; //written to instead of the file when set
+        //when compressing, writes gather in block and go out a block at a time, the last when closed
+        bool compressed = false;
+        std::vector<uint8_t> block;
+        std::vector<uint8_t> compressed_block;
+
+        ~Impl()
+        {
+            if (compressed)
+            {
+                flush_block();
+            }
+        }
+
+        void begin(Compression compression)
+        {
+            if (compression == Compression::Blocks)
+            {
+                compressed = true;
+                block.reserve(c_max_block_size);
+                begin_compressed_stream(compressed_block);
+                write_through(compressed_block.data(), compressed_block.size());
+            }
+        }
+
+        void write_through(const void* data, size_t size)
+        {
+            if (memory)
+            {
+                const size_t offset = memory->size();
+                memory->resize(offset + size);
+                memcpy(memory->data() + offset, data, size);
+                return;
+            }
+            file.write(reinterpret_cast<const char*>(data), size);
+        }
+
+        void flush_block()
+        {
+            if (block.empty())
+            {
+                return;
+            }
+            compressed_block.clear();
+            append_compressed_block(block, compressed_block);
+            write_through(compressed_block.data(), compressed_block.size());
+            block.clear();
+        }
     };
-    FileOut FileOut::from_data(const char *relative_path)
+    FileOut FileOut::from_data(const char *relative_path, Compression compression)
     {
         auto path = get_data_path(relative_path);
         create_missing_directories(path);
-        return FileOut(path.string().c_str());
+        return FileOut(path.string().c_str(), compression);
     }
-    FileOut FileOut::from_app_data(const char *relative_path)
+    FileOut FileOut::from_app_data(const char *relative_path, Compression compression)
     {
         auto path = get_appdata_path(relative_path);
         create_missing_directories(path);
-        return FileOut(path.string().c_str());
+        return FileOut(path.string().c_str(), compression);
     }
-    FileOut FileOut::from_absolute(const char *absolute_path)
+    FileOut FileOut::from_absolute(const char *absolute_path, Compression compression)
     {
         auto path = std::filesystem::path(absolute_path);
         create_missing_directories(path);
-        return FileOut(path.string().c_str());
+        return FileOut(path.string().c_str(), compression);
+    }
+    FileOut FileOut::to_memory(std::vector<uint8_t>& buffer, Compression compression)
+    {
+        return FileOut(buffer, compression);
     }
     FileOut::~FileOut() = default;
 
-    FileOut::FileOut(const char *path)
+    FileOut::FileOut(const char *path, Compression compression)
     {
         m_impl = std::make_unique<Impl>();
         m_impl->file.open(path, std::ios::binary | std::ios::out | std::ios::trunc);
+        m_impl->begin(compression);
+    }
+
+    FileOut::FileOut(std::vector<uint8_t>& buffer, Compression compression)
+    {
+        m_impl = std::make_unique<Impl>();
+        m_impl->memory = &buffer;
+        m_impl->begin(compression);
     }
 
     bool FileOut::valid() const
     {
-        return m_impl->file.good();
+        return m_impl->memory || m_impl->file.good();
     }
 
     FileOut& FileOut::operator<<(const int8_t& value)     { write(value); return *this; }
@@ -153,13 +275,31 @@ namespace file
 
     void FileOut::write(const void* data, size_t size)
     {
-        m_impl->file.write(reinterpret_cast<const char*>(data), size);
+        if (!m_impl->compressed)
+        {
+            m_impl->write_through(data, size);
+            return;
+        }
+
+        auto& block = m_impl->block;
+        auto bytes = reinterpret_cast<const uint8_t*>(data);
+        while (size > 0)
+        {
+            const size_t count = std::min(size, c_max_block_size - block.size());
+            block.insert(block.end(), bytes, bytes + count);
+            bytes += count;
+            size -= count;
+            if (block.size() == c_max_block_size)
+            {
+                m_impl->flush_block();
+            }
+        }
     }
 
     template<typename T>
     void FileOut::write(const T& value)
     {
-        m_impl->file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        write(&value, sizeof(T));
     }
 
     //FileIn ==========================================================================
@@ -167,6 +307,26 @@ namespace file
     struct FileIn::Impl
     {
         std::ifstream file;
+        //read from instead of the file when from_memory is set, failed once a read runs past the end like the stream
+        std::span<const uint8_t> memory;
+        size_t position = 0;
+        bool from_memory = false;
+        bool failed = false;
+        //a compressed stream is decompressed whole when opened and then read from memory
+        std::vector<uint8_t> decompressed;
+
+        void decompress(std::span<const uint8_t> stream)
+        {
+            auto result = decompress_stream(stream);
+            if (result)
+            {
+                decompressed = std::move(*result);
+            }
+            memory = decompressed;
+            position = 0;
+            from_memory = true;
+            failed = !result;
+        }
     };
     FileIn FileIn::from_data(const char* relative_path)
     {
@@ -180,20 +340,55 @@ namespace file
     {
         return FileIn(path);
     }
+    FileIn FileIn::from_memory(std::span<const uint8_t> bytes)
+    {
+        return FileIn(bytes);
+    }
     FileIn::~FileIn() = default;
 
     FileIn::FileIn(const char* path)
     {
         m_impl = std::make_unique<Impl>();
-        if(std::filesystem::exists(path))
+        if(!std::filesystem::exists(path))
+        {
+            return;
+        }
+        m_impl->file.open(path, std::ios::binary | std::ios::in);
+
+        //uncompressed files are read as they stream in, so only a header is checked for here
+        uint8_t header[8];
+        auto& file = m_impl->file;
+        file.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (!is_compressed_stream(std::span(header, (size_t)file.gcount())))
+        {
+            file.clear();
+            file.seekg(0);
+            return;
+        }
+
+        file.seekg(0, std::ios::end);
+        std::vector<uint8_t> stream((size_t)file.tellg());
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(stream.data()), stream.size());
+        m_impl->decompress(stream);
+        file.close();
+    }
+
+    FileIn::FileIn(std::span<const uint8_t> bytes)
+    {
+        m_impl = std::make_unique<Impl>();
+        if (is_compressed_stream(bytes))
         {
-            m_impl->file.open(path, std::ios::binary | std::ios::in);
+            m_impl->decompress(bytes);
+            return;
         }
+        m_impl->memory = bytes;
+        m_impl->from_memory = true;
     }
 
     bool FileIn::valid() const
     {
-        return m_impl->file.good();
+        return m_impl->from_memory ? !m_impl->failed : m_impl->file.good();
     }
 
     FileIn& FileIn::operator>>(int8_t& value)   { read(value); return *this; }
@@ -226,6 +421,20 @@ namespace file
 
     bool FileIn::read(void* data, size_t size)
     {
+        if (m_impl->from_memory)
+        {
+            auto& impl = *m_impl;
+            const size_t available = std::min(size, impl.memory.size() - impl.position);
+            memcpy(data, impl.memory.data() + impl.position, available);
+            impl.position += available;
+            if (available < size)
+            {
+                impl.failed = true;
+                return false;
+            }
+            return true;
+        }
+
         m_impl->file.read(reinterpret_cast<char*>(data), size);
         if ((size_t)m_impl->file.gcount() < size)
         {
@@ -237,8 +446,7 @@ namespace file
     template <typename T>
     bool FileIn::read(T& value)
     {
-        m_impl->file.read(reinterpret_cast<char*>(&value), sizeof(T));
-        if (m_impl->file.gcount() < sizeof(T))
+        if (!read(&value, sizeof(T)))
         {
             value = T();
             return false;
@@ -0,0 +1,284 @@
+#include "file_watcher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace file
+{
+    using Clock = std::chrono::steady_clock;
+
+    //Private functions
+
+    struct FileStamp
+    {
+        std::filesystem::file_time_type time;
+        uintmax_t size;
+
+        bool operator==(const FileStamp&) const = default;
+    };
+
+    static std::unordered_map<std::string, FileStamp> scan_directory(const std::filesystem::path& directory)
+    {
+        std::unordered_map<std::string, FileStamp> files;
+        std::error_code error;
+        for (auto it = std::filesystem::recursive_directory_iterator(directory, error);
+            !error && it != std::filesystem::recursive_directory_iterator();
+            it.increment(error))
+        {
+            //files can vanish mid scan, anything that errors is picked up next scan
+            std::error_code file_error;
+            if (it->is_regular_file(file_error))
+            {
+                FileStamp stamp = {it->last_write_time(file_error), it->file_size(file_error)};
+                if (!file_error)
+                {
+                    files[it->path().lexically_normal().string()] = stamp;
+                }
+            }
+        }
+        return files;
+    }
+
+    //FileWatcher =====================================================================
+
+    struct FileWatcher::Impl
+    {
+        std::filesystem::path directory;
+        FileWatcherSettings settings;
+        bool polling = false;
+
+        std::thread thread;
+        std::atomic<bool> running = true;
+
+        //changed path -> time of its latest change
+        std::mutex mutex;
+        std::unordered_map<std::string, Clock::time_point> pending;
+
+        void mark_changed(const std::filesystem::path& path)
+        {
+            std::lock_guard lock(mutex);
+            pending[path.lexically_normal().string()] = Clock::now();
+        }
+
+        void poll_loop();
+
+#if defined(__linux__)
+        int inotify_fd = -1;
+        std::unordered_map<int, std::filesystem::path> watched_directories;
+
+        bool start_inotify();
+        void watch_directory_tree(const std::filesystem::path& root, bool report_files);
+        void inotify_loop();
+#endif
+    };
+
+    void FileWatcher::Impl::poll_loop()
+    {
+        using namespace std::chrono_literals;
+
+        auto files = scan_directory(directory);
+        auto next_scan = Clock::now() + settings.poll_interval;
+        while (running)
+        {
+            //sleep in short steps so shutting down doesn't wait out a whole interval
+            std::this_thread::sleep_for(std::min<Clock::duration>(settings.poll_interval, 10ms));
+            if (Clock::now() < next_scan)
+            {
+                continue;
+            }
+            next_scan = Clock::now() + settings.poll_interval;
+
+            auto scanned = scan_directory(directory);
+            for (auto& [path, stamp] : scanned)
+            {
+                auto previous = files.find(path);
+                if (previous == files.end() || !(previous->second == stamp))
+                {
+                    mark_changed(path);
+                }
+            }
+            for (auto& [path, stamp] : files)
+            {
+                if (!scanned.contains(path))
+                {
+                    mark_changed(path);
+                }
+            }
+            files = std::move(scanned);
+        }
+    }
+
+#if defined(__linux__)
+    bool FileWatcher::Impl::start_inotify()
+    {
+        inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotify_fd < 0)
+        {
+            return false;
+        }
+
+        watch_directory_tree(directory, false);
+        if (watched_directories.empty())
+        {
+            close(inotify_fd);
+            inotify_fd = -1;
+            return false;
+        }
+        return true;
+    }
+
+    //inotify isn't recursive, every directory needs its own watch
+    void FileWatcher::Impl::watch_directory_tree(const std::filesystem::path& root, bool report_files)
+    {
+        constexpr uint32_t mask = IN_CLOSE_WRITE | IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+
+        int watch = inotify_add_watch(inotify_fd, root.c_str(), mask);
+        if (watch >= 0)
+        {
+            watched_directories[watch] = root;
+        }
+
+        std::error_code error;
+        for (auto it = std::filesystem::recursive_directory_iterator(root, error);
+            !error && it != std::filesystem::recursive_directory_iterator();
+            it.increment(error))
+        {
+            std::error_code entry_error;
+            if (it->is_directory(entry_error))
+            {
+                watch = inotify_add_watch(inotify_fd, it->path().c_str(), mask);
+                if (watch >= 0)
+                {
+                    watched_directories[watch] = it->path();
+                }
+            }
+            else if (report_files)
+            {
+                //a directory moved in or filled before its watch existed, its files haven't been reported yet
+                mark_changed(it->path());
+            }
+        }
+    }
+
+    void FileWatcher::Impl::inotify_loop()
+    {
+        alignas(inotify_event) char buffer[4096];
+        while (running)
+        {
+            //time out regularly to notice shutdown
+            pollfd descriptor = {inotify_fd, POLLIN, 0};
+            if (::poll(&descriptor, 1, 50) <= 0)
+            {
+                continue;
+            }
+
+            ssize_t length = read(inotify_fd, buffer, sizeof(buffer));
+            for (char* next = buffer; length > 0 && next < buffer + length;)
+            {
+                auto* event = reinterpret_cast<inotify_event*>(next);
+                next += sizeof(inotify_event) + event->len;
+
+                if (event->mask & IN_IGNORED)
+                {
+                    watched_directories.erase(event->wd);
+                    continue;
+                }
+
+                auto watched = watched_directories.find(event->wd);
+                if (watched == watched_directories.end() || event->len == 0)
+                {
+                    continue;
+                }
+
+                auto path = watched->second / event->name;
+                if (event->mask & IN_ISDIR)
+                {
+                    if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                    {
+                        watch_directory_tree(path, true);
+                    }
+                    continue;
+                }
+                mark_changed(path);
+            }
+        }
+    }
+#endif
+
+    FileWatcher::FileWatcher(const std::filesystem::path& directory, FileWatcherSettings settings)
+        : m_impl(std::make_unique<Impl>())
+    {
+        m_impl->directory = directory.lexically_normal();
+        m_impl->settings = settings;
+        m_impl->polling = settings.force_polling;
+
+#if defined(__linux__)
+        if (!m_impl->polling && !m_impl->start_inotify())
+        {
+            m_impl->polling = true;
+        }
+        m_impl->thread = std::thread(m_impl->polling ? &Impl::poll_loop : &Impl::inotify_loop, m_impl.get());
+#else
+        m_impl->polling = true;
+        m_impl->thread = std::thread(&Impl::poll_loop, m_impl.get());
+#endif
+    }
+
+    FileWatcher::~FileWatcher()
+    {
+        m_impl->running = false;
+        m_impl->thread.join();
+
+#if defined(__linux__)
+        if (m_impl->inotify_fd >= 0)
+        {
+            close(m_impl->inotify_fd);
+        }
+#endif
+    }
+
+    std::vector<std::filesystem::path> FileWatcher::take_changes()
+    {
+        std::vector<std::filesystem::path> changes;
+
+        //if the watcher thread is recording a change, leave it for next time rather than wait
+        std::unique_lock lock(m_impl->mutex, std::try_to_lock);
+        if (!lock.owns_lock())
+        {
+            return changes;
+        }
+
+        const auto settled = Clock::now() - m_impl->settings.debounce;
+        for (auto it = m_impl->pending.begin(); it != m_impl->pending.end();)
+        {
+            if (it->second <= settled)
+            {
+                changes.push_back(it->first);
+                it = m_impl->pending.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        lock.unlock();
+
+        std::sort(changes.begin(), changes.end());
+        return changes;
+    }
+
+    bool FileWatcher::polling() const
+    {
+        return m_impl->polling;
+    }
+}
@@ -1,9 +1,19 @@
 #include "return_engine/main_loop.h"
 
-int main()
+#include <cstring>
+
+int main(int argc, char** argv)
 {
     //majority of functionality is handled by the engine itself hence calling straight into the engine main loop here
     //to customize the functionality of the engine for the game we use callbacks, virtual functions, and data
-    const re::EngineConfig config;
+    re::EngineConfig config;
+
+    //--scene <file> --record <file> --replay <file>, for repeatable profiling runs
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--scene") == 0)       config.scene_path = argv[i + 1];
+        else if (strcmp(argv[i], "--record") == 0) config.record_input_path = argv[i + 1];
+        else if (strcmp(argv[i], "--replay") == 0) config.replay_input_path = argv[i + 1];
+    }
     re::main_loop(config);
-}
\ No newline at end of file
+}
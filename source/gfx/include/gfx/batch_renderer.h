@@ -12,6 +12,8 @@ namespace gfx
     {
     public:
         void add_instance(const VertexArray&, const ShaderProgram&, const Texture*, const maths::Matrix44& transform);
+        //batches are found once for the whole array, cheapest when instances sharing everything are added together
+        void add_instances(const VertexArray&, const ShaderProgram&, const Texture*, const maths::Matrix44* transforms, int count);
         void add_light();
         
         void draw_all(float time, const maths::Matrix44& camera_view, const maths::Matrix44& camera_projection) const;
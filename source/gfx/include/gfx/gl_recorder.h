@@ -0,0 +1,77 @@
+#pragma once
+
+#include "gfx_forward.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace gfx
+{
+    //headless gl backend. while a recorder exists the loaded gl functions are swapped for ones that record the command
+    //stream instead of calling into a driver, so renderer code can run and be measured on machines without a gpu or window
+    //only one recorder can exist at a time, gl objects created while it exists must be destroyed before it is
+
+    enum class GLCommandType
+    {
+        UseProgram,
+        BindVertexArray,
+        BindBuffer,
+        BindTexture,
+        ActiveTexture,
+        BufferUpload,
+        TextureUpload,
+        VertexAttribute,
+        Uniform,
+        Draw,
+        Create,
+        Delete,
+    };
+
+    struct GLCommand
+    {
+        GLCommandType type;
+        GLuint object = 0;   //object bound/created/deleted, uniform location, draw primitive count
+        uint64_t bytes = 0;  //bytes uploaded for uploads
+        int instances = 0;   //instance count for draws, 0 for non-instanced draws
+    };
+
+    struct GLStats
+    {
+        int draw_calls = 0;
+        int instances = 0;
+        int state_changes = 0;
+        int uniforms = 0;
+        int objects_created = 0;
+        int objects_deleted = 0;
+        uint64_t bytes_uploaded = 0;
+    };
+
+    class GLRecorder
+    {
+    public:
+        GLRecorder();
+        ~GLRecorder();
+        GLRecorder(const GLRecorder&) = delete;
+        GLRecorder& operator=(const GLRecorder&) = delete;
+
+        //clears recorded commands and stats, call at the start of each frame being measured
+        void begin_frame();
+
+        const std::vector<GLCommand>& commands() const { return m_commands; }
+        const GLStats& stats() const { return m_stats; }
+
+        //if false, only stats are kept, for long running benchmarks
+        bool record_commands = true;
+        //if set, shader compiles and program links fail with this as their info log
+        const char* failure_log = nullptr;
+
+        //used by the recording backend
+        void record(const GLCommand&);
+        GLuint generate_name() { return m_next_name++; }
+
+    private:
+        std::vector<GLCommand> m_commands;
+        GLStats m_stats;
+        GLuint m_next_name = 1;
+    };
+}
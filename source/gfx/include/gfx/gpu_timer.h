@@ -0,0 +1,34 @@
+#pragma once
+
+#include "gfx_forward.h"
+
+namespace gfx
+{
+    //measures gpu time spent on the commands issued between begin and end using GL_TIME_ELAPSED queries
+    //queries are double buffered, each frame's result is read back the next time that query comes around
+    //so reading never stalls waiting on the gpu. results therefore lag a frame behind
+    //timer queries can't nest, only one timer may be between begin and end at once
+
+    class GpuTimer
+    {
+    public:
+        GpuTimer();
+        ~GpuTimer();
+        GpuTimer(const GpuTimer&) = delete;
+        GpuTimer& operator=(const GpuTimer&) = delete;
+
+        void begin();
+        void end();
+
+        //most recent completed measurement, negative until the first result arrives
+        double seconds() const { return m_seconds; }
+
+    private:
+        static constexpr int c_query_count = 2;
+
+        GLuint m_queries[c_query_count] = {};
+        bool m_pending[c_query_count] = {};
+        int m_current = 0;
+        double m_seconds = -1.0;
+    };
+}
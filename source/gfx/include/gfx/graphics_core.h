@@ -8,4 +8,6 @@ namespace gfx
     void clear(float r, float g, float b, float a);
 
     void resize_viewport(int width, int height);
+
+    bool has_extension(const char* name);
 }
\ No newline at end of file
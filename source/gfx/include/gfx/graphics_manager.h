@@ -5,51 +5,68 @@
 #include "vertex_array_object.h"
 #include "shader.h"
 #include "texture.h"
+#include "resource_slots.h"
 
 #include <memory>
-#include <string>
-#include <unordered_map>
+#include <tuple>
 
 namespace gfx
 {
     void report_gl_error();
 
+    using VertexBufferHandle   = Handle<VertexBuffer>;
+    using ElementBufferHandle  = Handle<ElementBuffer>;
+    using VertexArrayHandle    = Handle<VertexArray>;
+    using VertexShaderHandle   = Handle<VertexShader>;
+    using FragmentShaderHandle = Handle<FragmentShader>;
+    using ShaderProgramHandle  = Handle<ShaderProgram>;
+    using TextureHandle        = Handle<Texture>;
+
+    //owns compiled gfx objects by name. find a handle once, then resolve it each use with get
     class GraphicsManager
     {
     public:
+        //destroys every object, handles stay valid and resolve to whatever is next added under the same name
         void clear();
+        //invalidates handles to names that weren't added again since the last clear
+        void remove_empty();
+
+        VertexBufferHandle   add(const char* name, std::unique_ptr<gfx::VertexBuffer>&& obj);
+        ElementBufferHandle  add(const char* name, std::unique_ptr<gfx::ElementBuffer>&& obj);
+        VertexArrayHandle    add(const char* name, std::unique_ptr<gfx::VertexArray>&& obj);
+        VertexShaderHandle   add(const char* name, std::unique_ptr<gfx::VertexShader>&& obj);
+        FragmentShaderHandle add(const char* name, std::unique_ptr<gfx::FragmentShader>&& obj);
+        ShaderProgramHandle  add(const char* name, std::unique_ptr<gfx::ShaderProgram>&& obj);
+        TextureHandle        add(const char* name, std::unique_ptr<gfx::Texture>&& obj);
+
+        //for reloading a single object, anything holding a pointer to the old object must drop it
+        template<typename T>
+        Handle<T> replace(const char* name, std::unique_ptr<T>&& obj) { return std::get<ResourceSlots<T>>(m_resources).replace(name, std::move(obj)); }
+
+        template<typename T>
+        Handle<T> find(const char* name) const { return resources<T>().find(name); }
+        template<typename T>
+        const T* get(Handle<T> handle) const { return resources<T>().get(handle); }
+        template<typename T>
+        const ResourceSlots<T>& resources() const { return std::get<ResourceSlots<T>>(m_resources); }
 
-        void add(const char* name, std::unique_ptr<gfx::VertexBuffer>&& obj);
-        void add(const char* name, std::unique_ptr<gfx::ElementBuffer>&& obj);
-        void add(const char* name, std::unique_ptr<gfx::VertexArray>&& obj);
-        void add(const char* name, std::unique_ptr<gfx::VertexShader>&& obj);
-        void add(const char* name, std::unique_ptr<gfx::FragmentShader>&& obj);
-        void add(const char* name, std::unique_ptr<gfx::ShaderProgram>&& obj);
-        void add(const char* name, std::unique_ptr<gfx::Texture>&& obj);
-
-        std::vector<std::string> vertex_buffer_names() const;
-        std::vector<std::string> element_buffer_names() const;
-        std::vector<std::string> vertex_array_names() const;
-        std::vector<std::string> vertex_shader_names() const;
-        std::vector<std::string> fragment_shader_names() const;
-        std::vector<std::string> shader_program_names() const;
-        std::vector<std::string> texture_names() const;
-
-        const gfx::VertexBuffer*   vertex_buffer(const char* name) const;
-        const gfx::ElementBuffer*  element_buffer(const char* name) const;
-        const gfx::VertexArray*    vertex_array(const char* name) const;
-        const gfx::VertexShader*   vertex_shader(const char* name) const;
-        const gfx::FragmentShader* fragment_shader(const char* name) const;
-        const gfx::ShaderProgram*  shader_program(const char* name) const;
-        const gfx::Texture*        texture(const char* name) const;
+        const gfx::VertexBuffer*   vertex_buffer(const char* name) const   { return get(find<gfx::VertexBuffer>(name)); }
+        const gfx::ElementBuffer*  element_buffer(const char* name) const  { return get(find<gfx::ElementBuffer>(name)); }
+        const gfx::VertexArray*    vertex_array(const char* name) const    { return get(find<gfx::VertexArray>(name)); }
+        const gfx::VertexShader*   vertex_shader(const char* name) const   { return get(find<gfx::VertexShader>(name)); }
+        const gfx::FragmentShader* fragment_shader(const char* name) const { return get(find<gfx::FragmentShader>(name)); }
+        const gfx::ShaderProgram*  shader_program(const char* name) const  { return get(find<gfx::ShaderProgram>(name)); }
+        const gfx::Texture*        texture(const char* name) const         { return get(find<gfx::Texture>(name)); }
 
     private:
-        std::unordered_map<std::string, std::unique_ptr<gfx::VertexBuffer>>   m_vertex_buffers;
-        std::unordered_map<std::string, std::unique_ptr<gfx::ElementBuffer>>  m_element_buffers;
-        std::unordered_map<std::string, std::unique_ptr<gfx::VertexArray>>    m_vertex_arrays;
-        std::unordered_map<std::string, std::unique_ptr<gfx::VertexShader>>   m_vertex_shaders;
-        std::unordered_map<std::string, std::unique_ptr<gfx::FragmentShader>> m_fragment_shaders;
-        std::unordered_map<std::string, std::unique_ptr<gfx::ShaderProgram>>  m_shader_programs;
-        std::unordered_map<std::string, std::unique_ptr<gfx::Texture>>        m_textures;
+        std::tuple<
+            ResourceSlots<gfx::VertexBuffer>,
+            ResourceSlots<gfx::ElementBuffer>,
+            ResourceSlots<gfx::VertexArray>,
+            ResourceSlots<gfx::VertexShader>,
+            ResourceSlots<gfx::FragmentShader>,
+            ResourceSlots<gfx::ShaderProgram>,
+            ResourceSlots<gfx::Texture>
+        > m_resources;
     };
 }
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "gfx_forward.h"
+
+#include <cstdint>
+
+namespace gfx
+{
+    //linked program binaries are cached in the appdata folder so unchanged programs can skip compiling and linking
+    //entries are keyed on a hash of the shader sources and the driver, so a driver update invalidates the cache
+
+    struct ProgramCacheStats
+    {
+        int hits = 0;
+        int misses = 0;
+    };
+
+    uint64_t hash_shader_source(const char* source);
+    uint64_t program_cache_key(uint64_t vertex_source_hash, uint64_t fragment_source_hash);
+
+    //returns true if the program was loaded from the cache and linked successfully
+    bool load_program_binary(GLuint program, uint64_t key);
+    //program must have been linked successfully
+    void store_program_binary(GLuint program, uint64_t key);
+
+    const ProgramCacheStats& program_cache_stats();
+}
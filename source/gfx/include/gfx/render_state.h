@@ -0,0 +1,42 @@
+#pragma once
+
+#include "gfx_forward.h"
+
+namespace gfx
+{
+    //shadows the currently bound gl objects so that redundant binds can be skipped
+    //all binds in gfx should go through these functions, anything binding behind our back must invalidate afterwards
+
+    enum class BufferTarget
+    {
+        Array,
+        Element, //element buffer binding is stored per vertex array, so changing the vertex array forgets it
+
+        Count
+    };
+
+    struct RenderStateCounters
+    {
+        int issued = 0;
+        int skipped = 0;
+    };
+
+    void bind_program(GLuint program);
+    void bind_vertex_array(GLuint vertex_array);
+    void bind_texture(int unit, GLuint texture);
+    void bind_buffer(BufferTarget target, GLuint buffer);
+
+    //call before deleting an object, gl may reuse the name and we mustn't skip binding the new object
+    void forget_program(GLuint program);
+    void forget_vertex_array(GLuint vertex_array);
+    void forget_texture(GLuint texture);
+    void forget_buffer(GLuint buffer);
+
+    //forces every binding to be issued again next time
+    void invalidate_render_state();
+
+    //call once per frame, counters for the frame just finished are kept for display
+    void begin_render_state_frame();
+    const RenderStateCounters& render_state_counters();
+    const RenderStateCounters& last_frame_render_state_counters();
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace gfx
+{
+    //index into a ResourceSlots plus the generation of the slot when the handle was made
+    //a slot's generation changes when it's freed, so handles to removed names stop resolving instead of
+    //pointing at whatever reuses the slot
+    template<typename T>
+    struct Handle
+    {
+        static constexpr uint32_t c_invalid_index = ~0u;
+
+        uint32_t index = c_invalid_index;
+        uint32_t generation = 0;
+
+        bool operator==(const Handle&) const = default;
+    };
+
+    //named objects stored in a dense array of slots
+    //  a name is given a slot the first time it's added and keeps it until removed, so handles survive clearing
+    //  and re-adding objects under the same name, which is what happens every time assets are recompiled
+    //  looking up a handle is an array read, names are only hashed when finding a handle
+    template<typename T>
+    class ResourceSlots
+    {
+    public:
+        //the first object added under a name is kept until cleared
+        Handle<T> add(const char* name, std::unique_ptr<T>&& obj);
+        //swaps out the object under a name, handles to it stay valid
+        Handle<T> replace(const char* name, std::unique_ptr<T>&& obj);
+        Handle<T> find(std::string_view name) const;
+
+        const T* get(Handle<T>) const;
+        bool valid(Handle<T>) const;
+        const std::string& name(Handle<T>) const;
+
+        //destroys every object, names keep their slots
+        void clear_objects();
+        //frees the slots of names with no object, handles to them become invalid
+        void remove_empty();
+
+        //for iterating, slot_count includes free slots which have an invalid handle
+        int slot_count() const { return (int)m_slots.size(); }
+        Handle<T> handle_at(int index) const;
+
+    private:
+        struct Slot
+        {
+            std::unique_ptr<T> object;
+            std::string name;
+            uint32_t generation = 0;
+            bool used = false;
+        };
+
+        //allows finding by string_view without constructing a string
+        struct NameHash
+        {
+            using is_transparent = void;
+            size_t operator()(std::string_view name) const { return std::hash<std::string_view>()(name); }
+        };
+
+        std::vector<Slot> m_slots;
+        std::vector<uint32_t> m_free_slots;
+        std::unordered_map<std::string, uint32_t, NameHash, std::equal_to<>> m_indices;
+    };
+
+    //inline definitions
+
+    template<typename T>
+    inline Handle<T> ResourceSlots<T>::add(const char* name, std::unique_ptr<T>&& obj)
+    {
+        auto handle = find(name);
+        if (handle.index == Handle<T>::c_invalid_index)
+        {
+            if (m_free_slots.empty())
+            {
+                handle.index = (uint32_t)m_slots.size();
+                m_slots.emplace_back();
+            }
+            else
+            {
+                handle.index = m_free_slots.back();
+                m_free_slots.pop_back();
+            }
+
+            auto& slot = m_slots[handle.index];
+            slot.name = name;
+            slot.used = true;
+            handle.generation = slot.generation;
+            m_indices.emplace(slot.name, handle.index);
+        }
+
+        auto& slot = m_slots[handle.index];
+        if (!slot.object)
+        {
+            slot.object = std::move(obj);
+        }
+        return handle;
+    }
+
+    template<typename T>
+    inline Handle<T> ResourceSlots<T>::replace(const char* name, std::unique_ptr<T>&& obj)
+    {
+        auto handle = add(name, nullptr);
+        m_slots[handle.index].object = std::move(obj);
+        return handle;
+    }
+
+    template<typename T>
+    inline Handle<T> ResourceSlots<T>::find(std::string_view name) const
+    {
+        auto it = m_indices.find(name);
+        if (it == m_indices.end())
+        {
+            return {};
+        }
+        return {it->second, m_slots[it->second].generation};
+    }
+
+    template<typename T>
+    inline const T* ResourceSlots<T>::get(Handle<T> handle) const
+    {
+        return valid(handle) ? m_slots[handle.index].object.get() : nullptr;
+    }
+
+    template<typename T>
+    inline bool ResourceSlots<T>::valid(Handle<T> handle) const
+    {
+        return handle.index < m_slots.size() && m_slots[handle.index].used && m_slots[handle.index].generation == handle.generation;
+    }
+
+    template<typename T>
+    inline const std::string& ResourceSlots<T>::name(Handle<T> handle) const
+    {
+        assert(valid(handle));
+        return m_slots[handle.index].name;
+    }
+
+    template<typename T>
+    inline void ResourceSlots<T>::clear_objects()
+    {
+        for (auto& slot : m_slots)
+        {
+            slot.object.reset();
+        }
+    }
+
+    template<typename T>
+    inline void ResourceSlots<T>::remove_empty()
+    {
+        for (uint32_t i = 0; i < (uint32_t)m_slots.size(); ++i)
+        {
+            auto& slot = m_slots[i];
+            if (slot.used && !slot.object)
+            {
+                m_indices.erase(slot.name);
+                slot.name.clear();
+                slot.used = false;
+                ++slot.generation;
+                m_free_slots.push_back(i);
+            }
+        }
+    }
+
+    template<typename T>
+    inline Handle<T> ResourceSlots<T>::handle_at(int index) const
+    {
+        auto& slot = m_slots[index];
+        return slot.used ? Handle<T>{(uint32_t)index, slot.generation} : Handle<T>{};
+    }
+}
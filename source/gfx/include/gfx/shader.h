@@ -5,6 +5,7 @@
 #include "maths/maths.h"
 #include "maths/vector2.h"
 
+#include <cstdint>
 #include <string>
 
 namespace gfx
@@ -15,19 +16,37 @@ namespace gfx
         Fragment
     };
 
+    //compiling and linking are issued on construction but not waited on
+    //poll on later frames to find out whether they have finished, the error log is filled in whenever they've failed
+    enum class CompileStatus
+    {
+        Pending,
+        Succeeded,
+        Failed
+    };
+
     template<ShaderType shader_type>
     class Shader
     {
     public:
-        Shader(const char* source, std::string* error_log = nullptr);
+        Shader(const char* source);
         Shader(Shader&&);
         ~Shader();
 
         bool valid() const { return m_id != 0; }
         GLuint id() const { return m_id; }
+        uint64_t source_hash() const { return m_source_hash; }
+
+        //non-blocking where the driver supports KHR_parallel_shader_compile
+        CompileStatus poll(std::string* error_log = nullptr) const;
+        //blocks until compilation has finished
+        CompileStatus wait(std::string* error_log = nullptr) const;
 
     private:
         GLuint m_id = 0;
+        uint64_t m_source_hash = 0;
+        mutable CompileStatus m_status = CompileStatus::Pending;
+        mutable std::string m_error_log; //kept for every caller, not just the one that saw it fail
     };
 
     using VertexShader   = Shader<ShaderType::Vertex>;
@@ -37,7 +56,7 @@ namespace gfx
     {
     public:
         ShaderProgram() = default;
-        ShaderProgram(const VertexShader&, const FragmentShader&, std::string* error_log = nullptr);
+        ShaderProgram(const VertexShader&, const FragmentShader&);
         ShaderProgram(ShaderProgram&&);
         ~ShaderProgram();
         
@@ -46,8 +65,17 @@ namespace gfx
         void use() const;
         int uniform_location(const char* name) const;
 
+        //non-blocking where the driver supports KHR_parallel_shader_compile
+        CompileStatus poll(std::string* error_log = nullptr) const;
+        //blocks until linking has finished
+        CompileStatus wait(std::string* error_log = nullptr) const;
+        bool ready() const { return poll() == CompileStatus::Succeeded; }
+
     private:
         GLuint m_id = 0;
+        uint64_t m_cache_key = 0;
+        mutable CompileStatus m_status = CompileStatus::Failed;
+        mutable std::string m_error_log; //kept for every caller, not just the one that saw it fail
     };
 
     void set_uniform(GLint location, float);
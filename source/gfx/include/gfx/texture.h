@@ -18,7 +18,7 @@ namespace gfx
         void use() const;
 
     private:
-        GLuint m_id;
+        GLuint m_id = 0;
     };
 
     void unbind_texture();
@@ -11,7 +11,51 @@
 
 namespace gfx
 {
+    const char* g_fallback_vertex_shader =
+R"(#version 330 core
+
+layout (location = 0) in vec3 pos;
+layout (location = 10) in mat4 transform;
+
+uniform mat4 camera;
+
+void main()
+{
+    gl_Position = camera * transform * vec4(pos, 1.0f);
+}
+)";
+    const char* g_fallback_fragment_shader =
+R"(#version 330 core
+out vec4 FragColor;
+void main()
+{
+    FragColor = vec4(0.6f, 0.6f, 0.6f, 1.0f);
+}
+)";
+
+    //used in place of any program which is still compiling
+    static const ShaderProgram& fallback_shader_program()
+    {
+        //never destroyed, the context is gone by the time statics are torn down
+        static auto* sp = []()
+        {
+            auto* sp_ = new ShaderProgram(
+                VertexShader(g_fallback_vertex_shader),
+                FragmentShader(g_fallback_fragment_shader)
+                );
+            sp_->wait();
+            return sp_;
+        }();
+
+        return *sp;
+    }
+
     void BatchRenderer::add_instance(const VertexArray& vao, const ShaderProgram& program, const Texture* texture, const maths::Matrix44& transform)
+    {
+        add_instances(vao, program, texture, &transform, 1);
+    }
+
+    void BatchRenderer::add_instances(const VertexArray& vao, const ShaderProgram& program, const Texture* texture, const maths::Matrix44* transforms, int count)
     {
         ShaderBatch* sbatch = nullptr;
         VertexArrayBatch* abatch = nullptr;
@@ -58,7 +102,7 @@ namespace gfx
             tbatch = &tbatches.back();
         }
 
-        tbatch->transforms.push_back(transform);
+        tbatch->transforms.insert(tbatch->transforms.end(), transforms, transforms + count);
     }
 
     void BatchRenderer::add_light()
@@ -71,12 +115,18 @@ namespace gfx
         for(auto& sbatch : m_batches)
         {
             assert(sbatch.program != nullptr);
-            sbatch.program->use();
+            const ShaderProgram* program = sbatch.program;
+            if(!program->ready())
+            {
+                //don't stall waiting for the driver, draw with a placeholder until the program is ready
+                program = &fallback_shader_program();
+            }
+            program->use();
 
             //set lighting/other global uniforms
-            set_uniform(sbatch.program->uniform_location("camera"), camera);
-            set_uniform(sbatch.program->uniform_location("time"), time);
-            set_uniform(sbatch.program->uniform_location("tex"), 0);
+            set_uniform(program->uniform_location("camera"), camera);
+            set_uniform(program->uniform_location("time"), time);
+            set_uniform(program->uniform_location("tex"), 0);
             
             for(auto& abatch : sbatch.vao_batches)
             {
@@ -37,16 +37,19 @@ void main()
 
     static ShaderProgram& debug_lines_shader_program()
     {
-        static auto sp = []()
+        //never destroyed, the context is gone by the time statics are torn down
+        static auto* sp = []()
         {
-            auto sp_ = ShaderProgram(
+            auto* sp_ = new ShaderProgram(
                 VertexShader(g_debug_lines_vertex_shader),
                 FragmentShader(g_debug_lines_fragment_shader)
                 );
+            //needed immediately, nothing to fall back on
+            sp_->wait();
             return sp_;
         }();
 
-        return sp;
+        return *sp;
     }
 
     void draw_line_impl(
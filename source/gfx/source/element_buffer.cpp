@@ -1,5 +1,7 @@
 #include "element_buffer.h"
 
+#include "render_state.h"
+
 #include "glad/glad.h"
 
 namespace gfx
@@ -7,8 +9,10 @@ namespace gfx
     ElementBuffer::ElementBuffer(const void* data, int element_count)
         : m_element_count(element_count)
     {
+        //element buffer binding is vertex array state, make sure we don't clobber whichever one was drawn last
+        bind_vertex_array(0);
         glGenBuffers(1, &m_id);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
+        bind_buffer(BufferTarget::Element, m_id);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, element_count * sizeof(int) * 3, data, GL_STATIC_DRAW);
     }
     ElementBuffer::ElementBuffer(ElementBuffer&& other)
@@ -21,6 +25,7 @@ namespace gfx
     {
         if (m_id != 0)
         {
+            forget_buffer(m_id);
             glDeleteBuffers(1, &m_id);
         }
     }
@@ -0,0 +1,300 @@
+#include "gl_recorder.h"
+
+#include "render_state.h"
+
+#include "glad/glad.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cstring>
+
+//every gl function pointer used by gfx, paired with the recording replacement for it
+#define RECORDED_GL_FUNCTIONS(F)                                  \
+    F(glad_glGenBuffers,               gen_objects)               \
+    F(glad_glGenVertexArrays,          gen_objects)               \
+    F(glad_glGenTextures,              gen_objects)               \
+    F(glad_glDeleteBuffers,            delete_objects)            \
+    F(glad_glDeleteVertexArrays,       delete_objects)            \
+    F(glad_glDeleteTextures,           delete_objects)            \
+    F(glad_glGenQueries,               gen_objects)               \
+    F(glad_glDeleteQueries,            delete_objects)            \
+    F(glad_glCreateShader,             create_shader)             \
+    F(glad_glCreateProgram,            create_program)            \
+    F(glad_glDeleteShader,             delete_object)             \
+    F(glad_glDeleteProgram,            delete_object)             \
+    F(glad_glBindBuffer,               bind_buffer)               \
+    F(glad_glBindVertexArray,          bind_vertex_array)         \
+    F(glad_glBindTexture,              bind_texture)              \
+    F(glad_glActiveTexture,            active_texture)            \
+    F(glad_glUseProgram,               use_program)               \
+    F(glad_glBufferData,               buffer_data)               \
+    F(glad_glTexImage2D,               tex_image_2d)              \
+    F(glad_glTexParameteri,            tex_parameteri)            \
+    F(glad_glGenerateMipmap,           generate_mipmap)           \
+    F(glad_glVertexAttribPointer,      vertex_attrib_pointer)     \
+    F(glad_glEnableVertexAttribArray,  enable_attrib_array)       \
+    F(glad_glVertexAttribDivisor,      vertex_attrib_divisor)     \
+    F(glad_glShaderSource,             shader_source)             \
+    F(glad_glCompileShader,            compile_shader)            \
+    F(glad_glGetShaderiv,              get_shaderiv)              \
+    F(glad_glGetShaderInfoLog,         get_info_log)              \
+    F(glad_glAttachShader,             attach_shader)             \
+    F(glad_glProgramParameteri,        program_parameteri)        \
+    F(glad_glLinkProgram,              link_program)              \
+    F(glad_glGetProgramiv,             get_programiv)             \
+    F(glad_glGetProgramInfoLog,        get_info_log)              \
+    F(glad_glGetUniformLocation,       get_uniform_location)      \
+    F(glad_glUniform1f,                uniform_1f)                \
+    F(glad_glUniform1i,                uniform_1i)                \
+    F(glad_glUniform2f,                uniform_2f)                \
+    F(glad_glUniform3f,                uniform_3f)                \
+    F(glad_glUniformMatrix4fv,         uniform_matrix_4fv)        \
+    F(glad_glDrawArrays,               draw_arrays)               \
+    F(glad_glDrawElements,             draw_elements)             \
+    F(glad_glDrawArraysInstanced,      draw_arrays_instanced)     \
+    F(glad_glDrawElementsInstanced,    draw_elements_instanced)   \
+    F(glad_glGetError,                 get_error)                 \
+    F(glad_glGetString,                get_string)                \
+    F(glad_glGetStringi,               get_stringi)               \
+    F(glad_glGetIntegerv,              get_integerv)              \
+    F(glad_glProgramBinary,            program_binary)            \
+    F(glad_glGetProgramBinary,         get_program_binary)        \
+    F(glad_glBeginQuery,               begin_query)               \
+    F(glad_glEndQuery,                 end_query)                 \
+    F(glad_glGetQueryObjectiv,         get_query_objectiv)        \
+    F(glad_glGetQueryObjectui64v,      get_query_objectui64v)     \
+    F(glad_glClear,                    clear)                     \
+    F(glad_glClearColor,               clear_color)               \
+    F(glad_glViewport,                 viewport)                  \
+    F(glad_glEnable,                   enable)                    \
+    F(glad_glBlendFunc,                blend_func)
+
+namespace gfx
+{
+    namespace
+    {
+        GLRecorder* g_recorder = nullptr;
+
+        //driver functions that were loaded before the recorder was installed
+        struct SavedFunctions
+        {
+            #define SAVE_GL_FUNCTION(name, replacement) decltype(name) name##_saved;
+            RECORDED_GL_FUNCTIONS(SAVE_GL_FUNCTION)
+            #undef SAVE_GL_FUNCTION
+        };
+        SavedFunctions g_saved;
+    }
+
+    //recording replacements ====================================================
+
+    namespace recording
+    {
+        static void record(GLCommandType type, GLuint object = 0, uint64_t bytes = 0, int instances = 0)
+        {
+            g_recorder->record({type, object, bytes, instances});
+        }
+
+        static void APIENTRY gen_objects(GLsizei n, GLuint* names)
+        {
+            for(GLsizei i = 0; i < n; ++i)
+            {
+                names[i] = g_recorder->generate_name();
+                record(GLCommandType::Create, names[i]);
+            }
+        }
+        static void APIENTRY delete_objects(GLsizei n, const GLuint* names)
+        {
+            for(GLsizei i = 0; i < n; ++i)
+            {
+                record(GLCommandType::Delete, names[i]);
+            }
+        }
+        static GLuint APIENTRY create_shader(GLenum)
+        {
+            GLuint name = g_recorder->generate_name();
+            record(GLCommandType::Create, name);
+            return name;
+        }
+        static GLuint APIENTRY create_program()
+        {
+            GLuint name = g_recorder->generate_name();
+            record(GLCommandType::Create, name);
+            return name;
+        }
+        static void APIENTRY delete_object(GLuint name)                    { record(GLCommandType::Delete, name); }
+
+        static void APIENTRY bind_buffer(GLenum, GLuint buffer)             { record(GLCommandType::BindBuffer, buffer); }
+        static void APIENTRY bind_vertex_array(GLuint vertex_array)         { record(GLCommandType::BindVertexArray, vertex_array); }
+        static void APIENTRY bind_texture(GLenum, GLuint texture)           { record(GLCommandType::BindTexture, texture); }
+        static void APIENTRY active_texture(GLenum unit)                    { record(GLCommandType::ActiveTexture, unit - GL_TEXTURE0); }
+        static void APIENTRY use_program(GLuint program)                    { record(GLCommandType::UseProgram, program); }
+
+        static void APIENTRY buffer_data(GLenum, GLsizeiptr size, const void*, GLenum)
+        {
+            record(GLCommandType::BufferUpload, 0, (uint64_t)size);
+        }
+        static void APIENTRY tex_image_2d(GLenum, GLint, GLint, GLsizei width, GLsizei height, GLint, GLenum format, GLenum, const void*)
+        {
+            const uint64_t channels = format == GL_RGBA ? 4 : 3;
+            record(GLCommandType::TextureUpload, 0, (uint64_t)width * (uint64_t)height * channels);
+        }
+        static void APIENTRY tex_parameteri(GLenum, GLenum, GLint)        {}
+        static void APIENTRY generate_mipmap(GLenum)                      {}
+
+        static void APIENTRY vertex_attrib_pointer(GLuint index, GLint, GLenum, GLboolean, GLsizei, const void*)
+        {
+            record(GLCommandType::VertexAttribute, index);
+        }
+        static void APIENTRY enable_attrib_array(GLuint)                  {}
+        static void APIENTRY vertex_attrib_divisor(GLuint, GLuint)        {}
+
+        //shaders always compile and link successfully
+        static void APIENTRY shader_source(GLuint, GLsizei, const GLchar* const*, const GLint*) {}
+        static void APIENTRY compile_shader(GLuint)                       {}
+        static void APIENTRY attach_shader(GLuint, GLuint)                {}
+        static void APIENTRY program_parameteri(GLuint, GLenum, GLint)    {}
+        static void APIENTRY link_program(GLuint)                         {}
+        static void APIENTRY get_shaderiv(GLuint, GLenum pname, GLint* params)
+        {
+            *params = pname == GL_COMPILE_STATUS ? !g_recorder->failure_log : 1;
+        }
+        static void APIENTRY get_programiv(GLuint, GLenum pname, GLint* params)
+        {
+            if(pname == GL_LINK_STATUS)
+            {
+                *params = !g_recorder->failure_log;
+                return;
+            }
+            *params = pname == GL_PROGRAM_BINARY_LENGTH ? 0 : 1;
+        }
+        static void APIENTRY get_info_log(GLuint, GLsizei buf_size, GLsizei* length, GLchar* info_log)
+        {
+            const char* log = g_recorder->failure_log ? g_recorder->failure_log : "";
+            const GLsizei copied = buf_size > 0 ? std::min((GLsizei)strlen(log), buf_size - 1) : 0;
+            if(length) *length = copied;
+            if(buf_size > 0)
+            {
+                memcpy(info_log, log, copied);
+                info_log[copied] = '\0';
+            }
+        }
+        static void APIENTRY program_binary(GLuint, GLenum, const void*, GLsizei) {}
+        static void APIENTRY get_program_binary(GLuint, GLsizei, GLsizei* length, GLenum*, void*)
+        {
+            if(length) *length = 0;
+        }
+
+        //queries are always ready and always report a millisecond
+        static void APIENTRY begin_query(GLenum, GLuint)                  {}
+        static void APIENTRY end_query(GLenum)                            {}
+        static void APIENTRY get_query_objectiv(GLuint, GLenum, GLint* params) { *params = 1; }
+        static void APIENTRY get_query_objectui64v(GLuint, GLenum, GLuint64* params) { *params = 1000000; }
+
+        static GLint APIENTRY get_uniform_location(GLuint, const GLchar*) { return 0; }
+        static void APIENTRY uniform_1f(GLint location, GLfloat)          { record(GLCommandType::Uniform, location); }
+        static void APIENTRY uniform_1i(GLint location, GLint)            { record(GLCommandType::Uniform, location); }
+        static void APIENTRY uniform_2f(GLint location, GLfloat, GLfloat) { record(GLCommandType::Uniform, location); }
+        static void APIENTRY uniform_3f(GLint location, GLfloat, GLfloat, GLfloat) { record(GLCommandType::Uniform, location); }
+        static void APIENTRY uniform_matrix_4fv(GLint location, GLsizei, GLboolean, const GLfloat*) { record(GLCommandType::Uniform, location); }
+
+        static void APIENTRY draw_arrays(GLenum, GLint, GLsizei count)
+        {
+            record(GLCommandType::Draw, count);
+        }
+        static void APIENTRY draw_elements(GLenum, GLsizei count, GLenum, const void*)
+        {
+            record(GLCommandType::Draw, count);
+        }
+        static void APIENTRY draw_arrays_instanced(GLenum, GLint, GLsizei count, GLsizei instances)
+        {
+            record(GLCommandType::Draw, count, 0, instances);
+        }
+        static void APIENTRY draw_elements_instanced(GLenum, GLsizei count, GLenum, const void*, GLsizei instances)
+        {
+            record(GLCommandType::Draw, count, 0, instances);
+        }
+
+        static GLenum APIENTRY get_error()                                 { return GL_NO_ERROR; }
+        static const GLubyte* APIENTRY get_string(GLenum)                 { return reinterpret_cast<const GLubyte*>("gfx::GLRecorder"); }
+        static const GLubyte* APIENTRY get_stringi(GLenum, GLuint)        { return reinterpret_cast<const GLubyte*>(""); }
+        static void APIENTRY get_integerv(GLenum, GLint* data)            { *data = 0; }
+
+        static void APIENTRY clear(GLbitfield)                            {}
+        static void APIENTRY clear_color(GLfloat, GLfloat, GLfloat, GLfloat) {}
+        static void APIENTRY viewport(GLint, GLint, GLsizei, GLsizei)     {}
+        static void APIENTRY enable(GLenum)                               {}
+        static void APIENTRY blend_func(GLenum, GLenum)                   {}
+    }
+
+    //GLRecorder ================================================================
+
+    GLRecorder::GLRecorder()
+    {
+        assert(g_recorder == nullptr && "Only one GLRecorder can be installed at a time");
+
+        #define INSTALL_GL_FUNCTION(name, replacement) \
+            g_saved.name##_saved = name;             \
+            name = recording::replacement;
+        RECORDED_GL_FUNCTIONS(INSTALL_GL_FUNCTION)
+        #undef INSTALL_GL_FUNCTION
+
+        g_recorder = this;
+
+        //anything shadowed before now refers to the previous backend
+        invalidate_render_state();
+    }
+
+    GLRecorder::~GLRecorder()
+    {
+        #define RESTORE_GL_FUNCTION(name, replacement) name = g_saved.name##_saved;
+        RECORDED_GL_FUNCTIONS(RESTORE_GL_FUNCTION)
+        #undef RESTORE_GL_FUNCTION
+
+        g_recorder = nullptr;
+        invalidate_render_state();
+    }
+
+    void GLRecorder::begin_frame()
+    {
+        m_commands.clear();
+        m_stats = GLStats();
+    }
+
+    void GLRecorder::record(const GLCommand& command)
+    {
+        switch(command.type)
+        {
+        case GLCommandType::UseProgram:
+        case GLCommandType::BindVertexArray:
+        case GLCommandType::BindBuffer:
+        case GLCommandType::BindTexture:
+        case GLCommandType::ActiveTexture:
+            ++m_stats.state_changes;
+            break;
+        case GLCommandType::BufferUpload:
+        case GLCommandType::TextureUpload:
+            m_stats.bytes_uploaded += command.bytes;
+            break;
+        case GLCommandType::Uniform:
+            ++m_stats.uniforms;
+            break;
+        case GLCommandType::Draw:
+            ++m_stats.draw_calls;
+            m_stats.instances += command.instances == 0 ? 1 : command.instances;
+            break;
+        case GLCommandType::Create:
+            ++m_stats.objects_created;
+            break;
+        case GLCommandType::Delete:
+            ++m_stats.objects_deleted;
+            break;
+        case GLCommandType::VertexAttribute:
+            break;
+        }
+
+        if(record_commands)
+        {
+            m_commands.push_back(command);
+        }
+    }
+}
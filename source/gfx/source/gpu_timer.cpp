@@ -0,0 +1,43 @@
+#include "gpu_timer.h"
+
+#include "glad/glad.h"
+
+namespace gfx
+{
+    GpuTimer::GpuTimer()
+    {
+        glGenQueries(c_query_count, m_queries);
+    }
+
+    GpuTimer::~GpuTimer()
+    {
+        glDeleteQueries(c_query_count, m_queries);
+    }
+
+    void GpuTimer::begin()
+    {
+        //collect the result from the last time this query was used, if the gpu still hasn't got to it the sample is dropped
+        GLuint query = m_queries[m_current];
+        if(m_pending[m_current])
+        {
+            GLint available = 0;
+            glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if(available)
+            {
+                GLuint64 elapsed_ns = 0;
+                glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed_ns);
+                m_seconds = 1e-9 * (double)elapsed_ns;
+            }
+            m_pending[m_current] = false;
+        }
+
+        glBeginQuery(GL_TIME_ELAPSED, query);
+    }
+
+    void GpuTimer::end()
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        m_pending[m_current] = true;
+        m_current = (m_current + 1) % c_query_count;
+    }
+}
@@ -1,6 +1,8 @@
 #include "graphics_core.h"
 
 #include "glad/glad.h"
+
+#include <cstring>
 #include <iostream>
 
 namespace gfx
@@ -19,6 +21,17 @@ namespace gfx
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         glEnable( GL_BLEND );
 
+        //let the driver use as many threads as it likes for compiling shaders in the background
+        if(has_extension("GL_KHR_parallel_shader_compile"))
+        {
+            using MaxShaderCompilerThreadsProc = void(*)(GLuint);
+            auto max_shader_compiler_threads = (MaxShaderCompilerThreadsProc)proc_address("glMaxShaderCompilerThreadsKHR");
+            if(max_shader_compiler_threads)
+            {
+                max_shader_compiler_threads(0xFFFFFFFF);
+            }
+        }
+
         return true;
     }
 
@@ -36,4 +49,19 @@ namespace gfx
     {
         glViewport(0, 0, width, height);
     }
+
+    bool has_extension(const char* name)
+    {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for(GLint i = 0; i < count; ++i)
+        {
+            auto extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            if(extension && strcmp(extension, name) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
 }
\ No newline at end of file
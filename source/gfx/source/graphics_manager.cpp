@@ -36,95 +36,19 @@ namespace gfx
 
     void GraphicsManager::clear()
     {
-        m_vertex_buffers.clear();
-        m_element_buffers.clear();
-        m_vertex_arrays.clear();
-        m_vertex_shaders.clear();
-        m_fragment_shaders.clear();
-        m_shader_programs.clear();
-        m_textures.clear();
+        std::apply([](auto&... resources) { (resources.clear_objects(), ...); }, m_resources);
     }
 
-    void GraphicsManager::add(const char *name, std::unique_ptr<gfx::VertexBuffer> &&obj)   { m_vertex_buffers.emplace(name, std::move(obj)); }
-    void GraphicsManager::add(const char* name, std::unique_ptr<gfx::ElementBuffer>&& obj)  { m_element_buffers.emplace(name, std::move(obj)); }
-    void GraphicsManager::add(const char* name, std::unique_ptr<gfx::VertexArray>&& obj)    { m_vertex_arrays.emplace(name, std::move(obj)); }
-    void GraphicsManager::add(const char* name, std::unique_ptr<gfx::VertexShader>&& obj)   { m_vertex_shaders.emplace(name, std::move(obj)); }
-    void GraphicsManager::add(const char* name, std::unique_ptr<gfx::FragmentShader>&& obj) { m_fragment_shaders.emplace(name, std::move(obj)); }
-    void GraphicsManager::add(const char* name, std::unique_ptr<gfx::ShaderProgram>&& obj)  { m_shader_programs.emplace(name, std::move(obj)); }
-    void GraphicsManager::add(const char* name, std::unique_ptr<gfx::Texture>&& obj)        { m_textures.emplace(name, std::move(obj)); }
-
-    template<typename MapT>
-    static std::vector<std::string> get_map_keys(MapT&& m)
-    {
-        std::vector<std::string> keys;
-        for(auto& entry : m)
-        {
-            keys.push_back(entry.first);
-        }
-        return keys;
-    }
-    template<typename ValueT>
-    static const ValueT* get_map_value(const char* name, const std::unordered_map<std::string, std::unique_ptr<ValueT>>& map)
-    {
-        auto find_iter = map.find(name);
-        return find_iter == map.end() ? nullptr : find_iter->second.get();
-    }
-
-    std::vector<std::string> GraphicsManager::vertex_buffer_names() const
-    {
-        return get_map_keys(m_vertex_buffers);
-    }
-    std::vector<std::string> GraphicsManager::element_buffer_names() const
-    {
-        return get_map_keys(m_element_buffers);
-    }
-    std::vector<std::string> GraphicsManager::vertex_array_names() const
-    {
-        return get_map_keys(m_vertex_arrays);
-    }
-    std::vector<std::string> GraphicsManager::vertex_shader_names() const
-    {
-        return get_map_keys(m_vertex_shaders);
-    }
-    std::vector<std::string> GraphicsManager::fragment_shader_names() const
-    {
-        return get_map_keys(m_fragment_shaders);
-    }
-    std::vector<std::string> GraphicsManager::shader_program_names() const
-    {
-        return get_map_keys(m_shader_programs);
-    }
-    std::vector<std::string> GraphicsManager::texture_names() const
+    void GraphicsManager::remove_empty()
     {
-        return get_map_keys(m_textures);
+        std::apply([](auto&... resources) { (resources.remove_empty(), ...); }, m_resources);
     }
 
-    const gfx::VertexBuffer* GraphicsManager::vertex_buffer(const char* name) const
-    {
-        return get_map_value(name, m_vertex_buffers);
-    }
-    const gfx::ElementBuffer* GraphicsManager::element_buffer(const char* name) const
-    {
-        return get_map_value(name, m_element_buffers);
-    }
-    const gfx::VertexArray* GraphicsManager::vertex_array(const char* name) const
-    {
-        return get_map_value(name, m_vertex_arrays);
-    }
-    const gfx::VertexShader* GraphicsManager::vertex_shader(const char* name) const
-    {
-        return get_map_value(name, m_vertex_shaders);
-    }
-    const gfx::FragmentShader* GraphicsManager::fragment_shader(const char* name) const
-    {
-        return get_map_value(name, m_fragment_shaders);
-    }
-    const gfx::ShaderProgram* GraphicsManager::shader_program(const char* name) const
-    {
-        return get_map_value(name, m_shader_programs);
-    }
-    const gfx::Texture *GraphicsManager::texture(const char *name) const
-    {
-        return get_map_value(name, m_textures);
-    }
+    VertexBufferHandle   GraphicsManager::add(const char* name, std::unique_ptr<gfx::VertexBuffer>&& obj)   { return std::get<ResourceSlots<gfx::VertexBuffer>>(m_resources).add(name, std::move(obj)); }
+    ElementBufferHandle  GraphicsManager::add(const char* name, std::unique_ptr<gfx::ElementBuffer>&& obj)  { return std::get<ResourceSlots<gfx::ElementBuffer>>(m_resources).add(name, std::move(obj)); }
+    VertexArrayHandle    GraphicsManager::add(const char* name, std::unique_ptr<gfx::VertexArray>&& obj)    { return std::get<ResourceSlots<gfx::VertexArray>>(m_resources).add(name, std::move(obj)); }
+    VertexShaderHandle   GraphicsManager::add(const char* name, std::unique_ptr<gfx::VertexShader>&& obj)   { return std::get<ResourceSlots<gfx::VertexShader>>(m_resources).add(name, std::move(obj)); }
+    FragmentShaderHandle GraphicsManager::add(const char* name, std::unique_ptr<gfx::FragmentShader>&& obj) { return std::get<ResourceSlots<gfx::FragmentShader>>(m_resources).add(name, std::move(obj)); }
+    ShaderProgramHandle  GraphicsManager::add(const char* name, std::unique_ptr<gfx::ShaderProgram>&& obj)  { return std::get<ResourceSlots<gfx::ShaderProgram>>(m_resources).add(name, std::move(obj)); }
+    TextureHandle        GraphicsManager::add(const char* name, std::unique_ptr<gfx::Texture>&& obj)        { return std::get<ResourceSlots<gfx::Texture>>(m_resources).add(name, std::move(obj)); }
 }
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include "program_cache.h"
+
+#include "file/file.h"
+
+#include "glad/glad.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace gfx
+{
+    namespace
+    {
+        ProgramCacheStats g_stats;
+
+        constexpr uint32_t c_cache_version = 1;
+    }
+
+    static uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+    {
+        auto* bytes = reinterpret_cast<const uint8_t*>(data);
+        for(size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    static uint64_t hash_gl_string(GLenum name, uint64_t hash)
+    {
+        auto* string = reinterpret_cast<const char*>(glGetString(name));
+        return string ? fnv1a(string, strlen(string), hash) : hash;
+    }
+
+    static uint64_t driver_hash()
+    {
+        //requires a current context, so computed on first use rather than at startup
+        static const uint64_t hash = []()
+        {
+            uint64_t h = fnv1a(&c_cache_version, sizeof(c_cache_version));
+            h = hash_gl_string(GL_VENDOR, h);
+            h = hash_gl_string(GL_RENDERER, h);
+            h = hash_gl_string(GL_VERSION, h);
+            return h;
+        }();
+        return hash;
+    }
+
+    static bool program_binaries_supported()
+    {
+        static const bool supported = []()
+        {
+            if(glGetProgramBinary == nullptr || glProgramBinary == nullptr)
+            {
+                return false;
+            }
+            GLint num_formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+            return num_formats > 0;
+        }();
+        return supported;
+    }
+
+    static std::string cache_entry_path(uint64_t key)
+    {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "shader_cache/%016llx.bin", (unsigned long long)key);
+        return buf;
+    }
+
+    uint64_t hash_shader_source(const char* source)
+    {
+        return fnv1a(source, strlen(source));
+    }
+
+    uint64_t program_cache_key(uint64_t vertex_source_hash, uint64_t fragment_source_hash)
+    {
+        uint64_t key = fnv1a(&vertex_source_hash, sizeof(vertex_source_hash), driver_hash());
+        return fnv1a(&fragment_source_hash, sizeof(fragment_source_hash), key);
+    }
+
+    bool load_program_binary(GLuint program, uint64_t key)
+    {
+        if(!program_binaries_supported())
+        {
+            ++g_stats.misses;
+            return false;
+        }
+
+        auto file = file::FileIn::from_app_data(cache_entry_path(key).c_str());
+        uint64_t stored_key = 0;
+        uint32_t format = 0;
+        uint64_t length = 0;
+        file >> stored_key >> format >> length;
+
+        std::vector<uint8_t> binary;
+        if(file.valid() && stored_key == key && length != 0)
+        {
+            binary.resize(length);
+            file.read(binary.data(), length);
+        }
+        if(!file.valid() || binary.empty())
+        {
+            ++g_stats.misses;
+            return false;
+        }
+
+        glProgramBinary(program, format, binary.data(), (GLsizei)binary.size());
+
+        //the driver is free to reject binaries, in which case we fall back to compiling from source
+        GLint success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if(!success)
+        {
+            ++g_stats.misses;
+            return false;
+        }
+
+        ++g_stats.hits;
+        return true;
+    }
+
+    void store_program_binary(GLuint program, uint64_t key)
+    {
+        if(!program_binaries_supported())
+        {
+            return;
+        }
+
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if(length <= 0)
+        {
+            return;
+        }
+
+        GLenum format = 0;
+        std::vector<uint8_t> binary(length);
+        glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+        auto file = file::FileOut::from_app_data(cache_entry_path(key).c_str());
+        file << key << (uint32_t)format << (uint64_t)binary.size();
+        file.write(binary.data(), binary.size());
+    }
+
+    const ProgramCacheStats& program_cache_stats()
+    {
+        return g_stats;
+    }
+}
@@ -0,0 +1,154 @@
+#include "render_state.h"
+
+#include "glad/glad.h"
+
+#include <assert.h>
+
+namespace gfx
+{
+    namespace
+    {
+        //a name gl will never hand out, so the next bind is always issued
+        constexpr GLuint c_unknown = ~0u;
+        constexpr int c_max_texture_units = 16;
+
+        struct RenderState
+        {
+            GLuint program = c_unknown;
+            GLuint vertex_array = c_unknown;
+            int active_texture_unit = -1;
+            GLuint textures[c_max_texture_units];
+            GLuint buffers[(int)BufferTarget::Count];
+
+            RenderState()
+            {
+                for(auto& texture : textures) texture = c_unknown;
+                for(auto& buffer : buffers)   buffer = c_unknown;
+            }
+        };
+
+        RenderState g_state;
+        RenderStateCounters g_counters;
+        RenderStateCounters g_last_frame_counters;
+    }
+
+    //returns true if the caller should issue the gl call
+    static bool update_binding(GLuint& current, GLuint requested)
+    {
+        if(current == requested)
+        {
+            ++g_counters.skipped;
+            return false;
+        }
+
+        ++g_counters.issued;
+        current = requested;
+        return true;
+    }
+
+    static GLenum buffer_target_to_gl_type(BufferTarget target)
+    {
+        switch(target)
+        {
+            case BufferTarget::Array:   return GL_ARRAY_BUFFER;
+            case BufferTarget::Element: return GL_ELEMENT_ARRAY_BUFFER;
+            default:                    assert(false); return 0u;
+        }
+    }
+
+    void bind_program(GLuint program)
+    {
+        if(update_binding(g_state.program, program))
+        {
+            glUseProgram(program);
+        }
+    }
+
+    void bind_vertex_array(GLuint vertex_array)
+    {
+        if(update_binding(g_state.vertex_array, vertex_array))
+        {
+            glBindVertexArray(vertex_array);
+            g_state.buffers[(int)BufferTarget::Element] = c_unknown;
+        }
+    }
+
+    void bind_texture(int unit, GLuint texture)
+    {
+        assert(unit >= 0 && unit < c_max_texture_units);
+        if(g_state.textures[unit] == texture)
+        {
+            ++g_counters.skipped;
+            return;
+        }
+
+        if(g_state.active_texture_unit != unit)
+        {
+            ++g_counters.issued;
+            glActiveTexture(GL_TEXTURE0 + unit);
+            g_state.active_texture_unit = unit;
+        }
+        ++g_counters.issued;
+        g_state.textures[unit] = texture;
+        glBindTexture(GL_TEXTURE_2D, texture);
+    }
+
+    void bind_buffer(BufferTarget target, GLuint buffer)
+    {
+        if(update_binding(g_state.buffers[(int)target], buffer))
+        {
+            glBindBuffer(buffer_target_to_gl_type(target), buffer);
+        }
+    }
+
+    void forget_program(GLuint program)
+    {
+        if(g_state.program == program) g_state.program = c_unknown;
+    }
+
+    void forget_vertex_array(GLuint vertex_array)
+    {
+        if(g_state.vertex_array == vertex_array)
+        {
+            g_state.vertex_array = c_unknown;
+            g_state.buffers[(int)BufferTarget::Element] = c_unknown;
+        }
+    }
+
+    void forget_texture(GLuint texture)
+    {
+        for(auto& bound : g_state.textures)
+        {
+            if(bound == texture) bound = c_unknown;
+        }
+    }
+
+    void forget_buffer(GLuint buffer)
+    {
+        for(auto& bound : g_state.buffers)
+        {
+            if(bound == buffer) bound = c_unknown;
+        }
+    }
+
+    void invalidate_render_state()
+    {
+        g_state = RenderState();
+    }
+
+    void begin_render_state_frame()
+    {
+        g_last_frame_counters = g_counters;
+        g_counters = RenderStateCounters();
+    }
+
+    const RenderStateCounters& render_state_counters()
+    {
+        return g_counters;
+    }
+
+    const RenderStateCounters& last_frame_render_state_counters()
+    {
+        return g_last_frame_counters;
+    }
+}
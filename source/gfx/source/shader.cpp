@@ -1,7 +1,18 @@
 #include "shader.h"
 
+#include "graphics_core.h"
+#include "program_cache.h"
+#include "render_state.h"
+
 #include "glad/glad.h"
 
+#include <utility>
+
+//from KHR_parallel_shader_compile, glad was generated without extensions
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
 namespace gfx
 {
     static GLuint shader_type_to_gl_type(ShaderType t)
@@ -13,31 +24,29 @@ namespace gfx
             default:                   assert(false); return 0u;
         }
     }
+    static bool parallel_compile_supported()
+    {
+        static const bool supported = has_extension("GL_KHR_parallel_shader_compile");
+        return supported;
+    }
+
     template<ShaderType shader_type>
-    Shader<shader_type>::Shader(const char* source, std::string* error_log)
+    Shader<shader_type>::Shader(const char* source)
+        : m_source_hash(hash_shader_source(source))
     {
         m_id = glCreateShader(shader_type_to_gl_type(shader_type));
         glShaderSource(m_id, 1, &source, nullptr);
         glCompileShader(m_id);
-        
-        if(error_log)
-        {
-            //check for and report errors
-            int success = false;
-            glGetShaderiv(m_id, GL_COMPILE_STATUS, &success);
-            if(!success)
-            {
-                char buf[1024];
-                glGetShaderInfoLog(m_id, sizeof(buf), nullptr, buf);
-                *error_log = buf;
-            }
-        }
     }
     template<ShaderType shader_type>
     Shader<shader_type>::Shader(Shader&& other)
         : m_id(other.m_id)
+        , m_source_hash(other.m_source_hash)
+        , m_status(other.m_status)
+        , m_error_log(std::move(other.m_error_log))
     {
         other.m_id = 0;
+        other.m_status = CompileStatus::Failed;
     }
     template<ShaderType shader_type>
     Shader<shader_type>::~Shader()
@@ -47,44 +56,158 @@ namespace gfx
             glDeleteShader(m_id);
         }
     }
+    template<ShaderType shader_type>
+    CompileStatus Shader<shader_type>::poll(std::string* error_log) const
+    {
+        if(m_status != CompileStatus::Pending)
+        {
+            if(error_log && m_status == CompileStatus::Failed)
+            {
+                *error_log = m_error_log;
+            }
+            return m_status;
+        }
+
+        if(parallel_compile_supported())
+        {
+            int complete = 0;
+            glGetShaderiv(m_id, GL_COMPLETION_STATUS_KHR, &complete);
+            if(!complete)
+            {
+                return m_status;
+            }
+        }
+
+        return wait(error_log);
+    }
+    template<ShaderType shader_type>
+    CompileStatus Shader<shader_type>::wait(std::string* error_log) const
+    {
+        if(m_status != CompileStatus::Pending)
+        {
+            if(error_log && m_status == CompileStatus::Failed)
+            {
+                *error_log = m_error_log;
+            }
+            return m_status;
+        }
+
+        //check for and report errors
+        int success = 0;
+        glGetShaderiv(m_id, GL_COMPILE_STATUS, &success);
+        if(!success)
+        {
+            char buf[1024];
+            glGetShaderInfoLog(m_id, sizeof(buf), nullptr, buf);
+            m_error_log = buf;
+            if(error_log)
+            {
+                *error_log = m_error_log;
+            }
+            m_status = CompileStatus::Failed;
+        }
+        else
+        {
+            m_status = CompileStatus::Succeeded;
+        }
+        return m_status;
+    }
     template class Shader<ShaderType::Vertex>;
     template class Shader<ShaderType::Fragment>;
     
-    ShaderProgram::ShaderProgram(const VertexShader& vshader, const FragmentShader& fshader, std::string *error_log)
+    ShaderProgram::ShaderProgram(const VertexShader& vshader, const FragmentShader& fshader)
     {
         m_id = glCreateProgram();
-        glAttachShader(m_id, vshader.id());
-        glAttachShader(m_id, fshader.id());
-        glLinkProgram(m_id);
 
-        if(error_log)
+        //skip linking entirely if the driver has already given us a binary for these sources
+        m_cache_key = program_cache_key(vshader.source_hash(), fshader.source_hash());
+        if(load_program_binary(m_id, m_cache_key))
         {
-            //check for and report errors
-            int success = 0;
-            glGetProgramiv(m_id, GL_LINK_STATUS, &success);
-            if (!success)
-            {
-                char buf[1024];
-                glGetProgramInfoLog(m_id, sizeof(buf), nullptr, buf);
-                *error_log = buf;
-            }
+            m_status = CompileStatus::Succeeded;
+            return;
         }
+
+        //linking can be issued before the shaders have finished compiling, the driver resolves the ordering
+        glAttachShader(m_id, vshader.id());
+        glAttachShader(m_id, fshader.id());
+        glProgramParameteri(m_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glLinkProgram(m_id);
+        m_status = CompileStatus::Pending;
     }
     ShaderProgram::ShaderProgram(ShaderProgram&& other)
         : m_id(other.m_id)
+        , m_cache_key(other.m_cache_key)
+        , m_status(other.m_status)
+        , m_error_log(std::move(other.m_error_log))
     {
         other.m_id = 0;
+        other.m_status = CompileStatus::Failed;
     }
     ShaderProgram::~ShaderProgram()
     {
         if(m_id != 0)
         {
+            forget_program(m_id);
             glDeleteProgram(m_id);
         }
     }
+    CompileStatus ShaderProgram::poll(std::string* error_log) const
+    {
+        if(m_status != CompileStatus::Pending)
+        {
+            if(error_log && m_status == CompileStatus::Failed)
+            {
+                *error_log = m_error_log;
+            }
+            return m_status;
+        }
+
+        if(parallel_compile_supported())
+        {
+            int complete = 0;
+            glGetProgramiv(m_id, GL_COMPLETION_STATUS_KHR, &complete);
+            if(!complete)
+            {
+                return m_status;
+            }
+        }
+
+        return wait(error_log);
+    }
+    CompileStatus ShaderProgram::wait(std::string* error_log) const
+    {
+        if(m_status != CompileStatus::Pending)
+        {
+            if(error_log && m_status == CompileStatus::Failed)
+            {
+                *error_log = m_error_log;
+            }
+            return m_status;
+        }
+
+        //check for and report errors
+        int success = 0;
+        glGetProgramiv(m_id, GL_LINK_STATUS, &success);
+        if (!success)
+        {
+            char buf[1024];
+            glGetProgramInfoLog(m_id, sizeof(buf), nullptr, buf);
+            m_error_log = buf;
+            if(error_log)
+            {
+                *error_log = m_error_log;
+            }
+            m_status = CompileStatus::Failed;
+            return m_status;
+        }
+
+        m_status = CompileStatus::Succeeded;
+        store_program_binary(m_id, m_cache_key);
+        return m_status;
+    }
     void ShaderProgram::use() const
     {
-        glUseProgram(m_id);
+        bind_program(m_id);
     }
 
     int ShaderProgram::uniform_location(const char *name) const
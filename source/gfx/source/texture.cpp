@@ -1,6 +1,7 @@
 #include "texture.h"
 
 #include "image.h"
+#include "render_state.h"
 
 #include "glad/glad.h"
 
@@ -15,7 +16,7 @@ namespace gfx
 
         //create buffer
         glGenTextures(1, &m_id);
-        glBindTexture(GL_TEXTURE_2D, m_id);
+        bind_texture(0, m_id);
         //wrapping
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -35,16 +36,19 @@ namespace gfx
     Texture::~Texture()
     {
         if(m_id != 0)
+        {
+            forget_texture(m_id);
             glDeleteTextures(1, &m_id);
+        }
     }
     
     void Texture::use() const
     {
-        glBindTexture(GL_TEXTURE_2D, m_id);
+        bind_texture(0, m_id);
     }
     
     void unbind_texture()
     {
-        glBindTexture(GL_TEXTURE_2D, 0u);
+        bind_texture(0, 0u);
     }
 }
\ No newline at end of file
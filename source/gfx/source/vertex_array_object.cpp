@@ -2,6 +2,7 @@
 
 #include "vertex_buffer.h"
 #include "element_buffer.h"
+#include "render_state.h"
 
 #include "glad/glad.h"
 
@@ -13,11 +14,11 @@ namespace gfx
         , m_type(type)
     {
         glGenVertexArrays(1, &m_id);
-        glBindVertexArray(m_id);
+        bind_vertex_array(m_id);
         m_vb->bind_attributes();
         if (m_eb)
         {
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eb->id());
+            bind_buffer(BufferTarget::Element, eb->id());
         }
     }
 
@@ -34,6 +35,7 @@ namespace gfx
     {
         if(m_id != 0)
         {
+            forget_vertex_array(m_id);
             glDeleteVertexArrays(1, &m_id);
         }
     }
@@ -45,7 +47,7 @@ namespace gfx
             return;
         }
 
-        glBindVertexArray(m_id);
+        bind_vertex_array(m_id);
         int gl_primitive_type = GL_TRIANGLES;
         switch(m_type)
         {
@@ -61,7 +63,6 @@ namespace gfx
         {
             glDrawArrays(gl_primitive_type, 0, m_vb->vertex_count());
         }
-        glBindVertexArray(0);
     }
 
     void VertexArray::draw(const VertexBuffer& instance_buffer) const
@@ -71,7 +72,7 @@ namespace gfx
             return;
         }
 
-        glBindVertexArray(m_id);
+        bind_vertex_array(m_id);
         int gl_primitive_type = GL_TRIANGLES;
         switch(m_type)
         {
@@ -88,7 +89,6 @@ namespace gfx
         {
             glDrawArraysInstanced(gl_primitive_type, 0, m_vb->vertex_count(), instance_buffer.vertex_count());
         }
-        glBindVertexArray(0);
     }
 
 }
\ No newline at end of file
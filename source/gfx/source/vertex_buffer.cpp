@@ -1,5 +1,7 @@
 #include "vertex_buffer.h"
 
+#include "render_state.h"
+
 #include "glad/glad.h"
 
 namespace gfx
@@ -9,7 +11,7 @@ namespace gfx
         , m_components(components)
     {
         glGenBuffers(1, &m_id);
-        glBindBuffer(GL_ARRAY_BUFFER, m_id);
+        bind_buffer(BufferTarget::Array, m_id);
         glBufferData(GL_ARRAY_BUFFER, vertex_size(components.data(), (int)components.size()) * vertex_count, data, GL_STATIC_DRAW);
     }
     VertexBuffer::VertexBuffer(VertexBuffer&& other)
@@ -23,12 +25,13 @@ namespace gfx
     {
         if(m_id != 0)
         {
+            forget_buffer(m_id);
             glDeleteBuffers(1, &m_id);
         }
     }
     void VertexBuffer::bind_attributes() const
     {
-        glBindBuffer(GL_ARRAY_BUFFER, m_id);
+        bind_buffer(BufferTarget::Array, m_id);
         
         auto stride = vertex_size(m_components.data(), (int)m_components.size());
         uint64_t offset = 0;
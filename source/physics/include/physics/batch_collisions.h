@@ -0,0 +1,50 @@
+#pragma once
+
+#include "colliders.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace phys
+{
+    //colliders stored as one array per component, so consecutive shapes load straight into vector registers
+
+    struct SphereBatch
+    {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+        std::vector<float> radius;
+
+        void add(const Sphere&);
+        void clear();
+        int size() const { return (int)x.size(); }
+    };
+
+    struct AABBBatch
+    {
+        std::vector<float> min_x;
+        std::vector<float> min_y;
+        std::vector<float> min_z;
+        std::vector<float> max_x;
+        std::vector<float> max_y;
+        std::vector<float> max_z;
+
+        void add(const AABB3&);
+        void clear();
+        int size() const { return (int)min_x.size(); }
+    };
+
+    //words needed for the hits of count shapes
+    inline int hit_mask_words(int count) { return (count + 31) / 32; }
+
+    //test one shape against shapes [first, first + count) of a batch, several at a time with simd where available
+    //  bit i % 32 of hits[i / 32] is set if shape first + i intersects, exactly where intersects() would say so
+    //  penetration, if given, gets how deep each overlaps, only meaningful where the bit is set
+    void intersects(const Sphere&, const SphereBatch&, int first, int count, uint32_t* hits, float* penetration = nullptr);
+    void intersects(const Sphere&, const AABBBatch&, int first, int count, uint32_t* hits, float* penetration = nullptr);
+    void intersects(const AABB3&, const AABBBatch&, int first, int count, uint32_t* hits, float* penetration = nullptr);
+
+    //shapes tested per instruction, 8 with avx, 4 with sse2, 1 otherwise
+    int batch_collision_width();
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "colliders.h"
+
+#include <vector>
+
+namespace phys
+{
+    //finds which of a list of bounds overlap, so structures suited to different scenes can be swapped and compared
+    //  items are referred to by their index in the list they were built from
+    class Broadphase
+    {
+    public:
+        virtual ~Broadphase() = default;
+
+        virtual void build(const std::vector<AABB3>& bounds) = 0;
+        //bounds must be for the same items it was built with
+        virtual void refit(const std::vector<AABB3>& bounds) = 0;
+
+        //appends items whose bounds intersect the aabb
+        virtual void query(const AABB3&, std::vector<int>& items) const = 0;
+        //replaces pairs with every pair of items whose bounds intersect, sorted
+        virtual void find_pairs(std::vector<BodyPair>& pairs) const = 0;
+
+        virtual int item_count() const = 0;
+    };
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "broadphase.h"
+#include "colliders.h"
+
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace phys
+{
+    //bounding volume hierarchy over a list of bounds, items are referred to by their index in that list
+    //  built top down splitting where the surface area heuristic says is cheapest, from a few binned candidates
+    //  moving items only needs a refit, which keeps the tree and grows node bounds, rebuild when it's degraded
+    //  or items are added or removed
+    class BVH : public Broadphase
+    {
+    public:
+        struct RayHit
+        {
+            int item;
+            float distance;
+        };
+        //exact distance along the ray to an item, whose bounds the ray already hits
+        using RayTest = std::function<std::optional<float>(int item)>;
+
+        void build(const std::vector<AABB3>& bounds) override;
+        void refit(const std::vector<AABB3>& bounds) override;
+
+        //nearest item hit, by its bounds unless a test is given
+        std::optional<RayHit> raycast(const Ray&, float max_distance = INFINITY, const RayTest& test = {}) const;
+        void query(const AABB3&, std::vector<int>& items) const override;
+        void query(const Sphere&, std::vector<int>& items) const;
+        void find_pairs(std::vector<BodyPair>& pairs) const override;
+
+        int item_count() const override { return (int)m_item_bounds.size(); }
+        int node_count() const { return (int)m_nodes.size(); }
+        //sum of node surface areas relative to the root, lower is better, for seeing how far a refit has degraded it
+        float cost() const;
+
+    private:
+        //leaves have a count of items from m_items[first], others have children at first and first + 1
+        struct Node
+        {
+            AABB3 bounds;
+            int first;
+            int count;
+        };
+
+        void split(int node);
+        template<typename Overlaps>
+        void query(const Overlaps& overlaps, std::vector<int>& items) const;
+
+        std::vector<Node> m_nodes;
+        std::vector<int> m_items;
+        std::vector<AABB3> m_item_bounds;
+        std::vector<maths::Vector3> m_centroids; //only while building
+    };
+}
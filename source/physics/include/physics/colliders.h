@@ -3,6 +3,8 @@
 #include "maths/maths.h"
 
 #include <algorithm>
+#include <cmath>
+#include <optional>
 
 namespace phys
 {
@@ -21,6 +23,22 @@ namespace phys
         float radius = 0.f;
     };
 
+    struct Ray
+    {
+        maths::Vector3 origin = maths::Vector3::zero();
+        maths::Vector3 direction = maths::Vector3::unit_z(); //normalized
+    };
+
+    //two colliders whose bounds overlap, a < b
+    struct BodyPair
+    {
+        int a;
+        int b;
+
+        bool operator==(const BodyPair&) const = default;
+        bool operator<(const BodyPair& other) const { return a != other.a ? a < other.a : b < other.b; }
+    };
+
 
     //function defs
 
@@ -66,4 +84,57 @@ namespace phys
     {
         return intersects(sphere, aabb);
     }
+
+    //smallest union of the two
+    inline AABB3 merge(const AABB3& a, const AABB3& b)
+    {
+        return {
+            {std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z)},
+            {std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z)}
+        };
+    }
+
+    //distance along the ray to where it enters the aabb, 0 if it starts inside
+    //  inv_direction is 1 / ray.direction, worked out once when testing a ray against many boxes
+    inline std::optional<float> raycast(const Ray& ray, maths::Vector3 inv_direction, const AABB3& aabb)
+    {
+        //slabs, infinities from zero direction components fall out of the min/max
+        const float tx1 = (aabb.min.x - ray.origin.x) * inv_direction.x;
+        const float tx2 = (aabb.max.x - ray.origin.x) * inv_direction.x;
+        const float ty1 = (aabb.min.y - ray.origin.y) * inv_direction.y;
+        const float ty2 = (aabb.max.y - ray.origin.y) * inv_direction.y;
+        const float tz1 = (aabb.min.z - ray.origin.z) * inv_direction.z;
+        const float tz2 = (aabb.max.z - ray.origin.z) * inv_direction.z;
+
+        const float t_enter = std::max({std::min(tx1, tx2), std::min(ty1, ty2), std::min(tz1, tz2), 0.f});
+        const float t_exit = std::min({std::max(tx1, tx2), std::max(ty1, ty2), std::max(tz1, tz2)});
+        if (t_enter > t_exit)
+        {
+            return std::nullopt;
+        }
+        return t_enter;
+    }
+
+    inline std::optional<float> raycast(const Ray& ray, const AABB3& aabb)
+    {
+        return raycast(ray, {1.f / ray.direction.x, 1.f / ray.direction.y, 1.f / ray.direction.z}, aabb);
+    }
+
+    inline std::optional<float> raycast(const Ray& ray, const Sphere& sphere)
+    {
+        //solve |origin + t * direction - pos| = radius for the first t >= 0
+        const auto offset = ray.origin - sphere.pos;
+        const float b = maths::Vector3::dot(offset, ray.direction);
+        const float c = offset.magnitude_squared() - sphere.radius * sphere.radius;
+        if (c <= 0.f)
+        {
+            return 0.f;
+        }
+        const float discriminant = b * b - c;
+        if (b > 0.f || discriminant < 0.f)
+        {
+            return std::nullopt;
+        }
+        return -b - std::sqrt(discriminant);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "colliders.h"
+
+#include "maths/maths.h"
+
+namespace phys
+{
+    struct ContactPoint
+    {
+        maths::Vector3 position = maths::Vector3::zero();
+        float penetration = 0.f;
+        //identifies the same point on the same pair of shapes from one step to the next
+        int id = 0;
+
+        //impulses the solver accumulated, carried into the next step to warm start it
+        float normal_impulse = 0.f;
+        float tangent_impulse[2] = {0.f, 0.f};
+    };
+
+    //every point where two shapes intersect, sharing one normal
+    struct ContactManifold
+    {
+        static constexpr int c_max_points = 4;
+
+        int body_a = -1;
+        int body_b = -1;
+        maths::Vector3 normal = maths::Vector3::zero(); //from a to b
+        int point_count = 0;
+        ContactPoint points[c_max_points];
+    };
+
+    //fill in the manifold's normal and points if the shapes intersect, body indices are left alone
+    //  like intersects(), touching isn't intersecting and gives no contact
+    bool collide(const Sphere& a, const Sphere& b, ContactManifold& manifold);
+    bool collide(const Sphere& a, const AABB3& b, ContactManifold& manifold);
+    bool collide(const AABB3& a, const Sphere& b, ContactManifold& manifold);
+    bool collide(const AABB3& a, const AABB3& b, ContactManifold& manifold);
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "broadphase.h"
+#include "bvh.h"
+#include "colliders.h"
+#include "contacts.h"
+#include "sweeps.h"
+
+#include "maths/maths.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace phys
+{
+    enum class ShapeType : uint8_t
+    {
+        Sphere,
+        Box,
+    };
+
+    struct WorldSettings
+    {
+        maths::Vector3 gravity = {0.f, -9.81f, 0.f};
+        int velocity_iterations = 8;
+        float restitution = 0.2f;
+        float friction = 0.5f;
+        //approach speed below which contacts don't bounce, so resting bodies settle
+        float restitution_threshold = 1.f;
+        //fraction of the penetration pushed out per step, and how much is left alone so resting contacts don't jitter
+        float baumgarte = 0.2f;
+        float penetration_slop = 0.005f;
+        bool warm_starting = true;
+        //islands with more contacts than this are coloured so one island can be solved across threads
+        int colouring_threshold = 256;
+        //spheres moving further than their radius in a step are swept so they can't pass through thin bodies
+        bool continuous_collision = true;
+    };
+
+    //runs task(i) for every i in [0, count), in any order on any threads, and returns once they've all finished
+    using ParallelFor = std::function<void(int count, const std::function<void(int)>& task)>;
+
+    //world of spheres and boxes stepped with semi-implicit euler and a sequential impulse contact solver
+    //  bodies are stored as arrays per property and referred to by index, in the order they were added
+    //  boxes stay axis aligned, so they can't rotate and have no inverse inertia
+    //  a mass of 0 makes a body static
+    //  pairs of bodies that might touch come from a broadphase, then contacts are solved per island of touching bodies,
+    //  islands are independent so are solved in parallel
+    //  nothing about how the work is split depends on the thread count, so results are identical for any number
+    //  fast spheres are swept to where they first touch anything in their path, slide along it for the rest of the step
+    //  and bounce off it on the next
+    class RigidBodyWorld
+    {
+    public:
+        explicit RigidBodyWorld(WorldSettings settings = {});
+
+        int add_sphere(const Sphere&, float mass, maths::Vector3 velocity = maths::Vector3::zero());
+        int add_box(const AABB3&, float mass, maths::Vector3 velocity = maths::Vector3::zero());
+        void clear();
+
+        void step(float dt);
+
+        //without one everything runs on the calling thread
+        void set_parallel_for(ParallelFor parallel_for) { m_parallel_for = std::move(parallel_for); }
+        //finds which bodies' bounds overlap each step, a BVH unless set
+        void set_broadphase(std::unique_ptr<Broadphase>);
+        const Broadphase& broadphase() const { return *m_broadphase; }
+
+        int body_count() const { return (int)m_positions.size(); }
+        ShapeType shape(int body) const { return m_shapes[body]; }
+        Sphere sphere(int body) const;
+        AABB3 bounds(int body) const;
+
+        const maths::Vector3& position(int body) const { return m_positions[body]; }
+        const maths::Vector3& velocity(int body) const { return m_velocities[body]; }
+        const maths::Vector3& angular_velocity(int body) const { return m_angular_velocities[body]; }
+        const maths::Quaternion& orientation(int body) const { return m_orientations[body]; }
+        float inverse_mass(int body) const { return m_inverse_masses[body]; }
+        void set_velocity(int body, maths::Vector3 velocity) { m_velocities[body] = velocity; }
+
+        //contacts found in the last step with the impulses applied for them
+        const std::vector<ContactManifold>& contacts() const { return m_contacts; }
+        int island_count() const { return (int)m_islands.size(); }
+        float kinetic_energy() const;
+
+        WorldSettings& settings() { return m_settings; }
+        const WorldSettings& settings() const { return m_settings; }
+
+    private:
+        //per contact point values that only change between steps
+        struct SolverPoint
+        {
+            maths::Vector3 offset_a;
+            maths::Vector3 offset_b;
+            float normal_mass;
+            float tangent_mass[2];
+            float bias;
+        };
+
+        //a range of m_island_contacts
+        struct Island
+        {
+            int first;
+            int count;
+        };
+
+        int add_body(ShapeType, maths::Vector3 position, maths::Vector3 extents, float mass, float inverse_inertia, maths::Vector3 velocity);
+
+        void integrate_velocities(float dt);
+        void find_pairs();
+        void generate_contacts();
+        void prepare_contacts(float dt);
+        void build_islands();
+        void solve_islands();
+        void solve_coloured_island(const Island&);
+        void sweep_fast_bodies(float dt);
+        void integrate_positions(float dt);
+
+        void warm_start(int manifold);
+        void solve_contact(int manifold);
+
+        //calls task(begin, end) for ranges of about grain elements covering [0, count)
+        void parallel_ranges(int count, int grain, const std::function<void(int, int)>& task) const;
+        int find_island_root(int body);
+
+        void apply_impulse(int body_a, int body_b, const SolverPoint&, maths::Vector3 impulse);
+        maths::Vector3 relative_velocity(int body_a, int body_b, const SolverPoint&) const;
+
+        WorldSettings m_settings;
+
+        //bodies
+        std::vector<maths::Vector3> m_positions;
+        std::vector<maths::Vector3> m_velocities;
+        std::vector<maths::Vector3> m_angular_velocities;
+        std::vector<maths::Quaternion> m_orientations;
+        std::vector<float> m_inverse_masses;
+        std::vector<float> m_inverse_inertias;
+        std::vector<ShapeType> m_shapes;
+        std::vector<maths::Vector3> m_extents; //radius in x for spheres, half size for boxes
+
+        //pairs are found through it, rebuilt when stale and otherwise refit from the step's bounds
+        std::unique_ptr<Broadphase> m_broadphase;
+        bool m_broadphase_stale = true;
+        int m_steps_since_build = 0;
+
+        //per step, kept to reuse their memory
+        std::vector<AABB3> m_bounds;
+        std::vector<BodyPair> m_pairs;
+        std::vector<ContactManifold> m_contacts;
+        std::vector<ContactManifold> m_previous_contacts;
+        std::vector<uint8_t> m_pair_touching;
+        std::vector<ContactManifold> m_pair_contacts;
+        std::vector<maths::Vector3> m_tangents; //two per manifold
+        std::vector<SolverPoint> m_solver_points; //c_max_points per manifold
+        std::vector<float> m_step_fractions; //of the step each body has left to move after sweep hits moved it to them
+        std::vector<maths::Vector3> m_step_velocities; //each body moves with for the rest of the step, its velocity unless it slid off a sweep hit
+
+        //islands, contact indices grouped by island in contact order
+        std::vector<int> m_island_parents; //union-find over bodies
+        std::vector<int> m_body_islands; //by root body
+        std::vector<int> m_contact_islands;
+        std::vector<Island> m_islands;
+        std::vector<int> m_island_contacts;
+        std::vector<int> m_small_island_batches; //index of the first island in each batch, plus the end
+
+        //contacts of the island being coloured, grouped by colour, with the start of each colour plus the end
+        std::vector<int> m_coloured_contacts;
+        std::vector<int> m_colour_starts;
+        std::vector<uint64_t> m_body_colours; //bit per colour used by a body's contacts
+        std::vector<int> m_contact_colours;
+
+        ParallelFor m_parallel_for;
+    };
+}
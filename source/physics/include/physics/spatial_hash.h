@@ -0,0 +1,61 @@
+#pragma once
+
+#include "broadphase.h"
+#include "colliders.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace phys
+{
+    //uniform grid of cells, stored sparsely by hashing cell coordinates
+    //  each item is listed in every cell its bounds touch, so it suits lots of items around the cell size
+    //  and gets slow for items spanning many cells
+    //  refit only moves items whose range of cells changed, which for small steps is few of them
+    class SpatialHash : public Broadphase
+    {
+    public:
+        explicit SpatialHash(float cell_size = 1.f);
+
+        void build(const std::vector<AABB3>& bounds) override;
+        void refit(const std::vector<AABB3>& bounds) override;
+        //moves one item, its bounds are kept for pair tests
+        void update(int item, const AABB3& bounds);
+
+        void query(const AABB3&, std::vector<int>& items) const override;
+        void find_pairs(std::vector<BodyPair>& pairs) const override;
+
+        int item_count() const override { return (int)m_items.size(); }
+        int cell_count() const { return (int)m_cells.size(); }
+        float cell_size() const { return m_cell_size; }
+        //items that changed cells in the last refit
+        int moved_count() const { return m_moved_count; }
+
+    private:
+        //inclusive range of cell coordinates
+        struct CellRange
+        {
+            int min[3];
+            int max[3];
+
+            bool operator==(const CellRange&) const = default;
+        };
+
+        struct Item
+        {
+            AABB3 bounds;
+            CellRange cells;
+        };
+
+        CellRange cell_range(const AABB3&) const;
+        void insert(int item);
+        void remove(int item);
+
+        float m_cell_size;
+        float m_inv_cell_size;
+        std::vector<Item> m_items;
+        std::unordered_map<uint64_t, std::vector<int>> m_cells;
+        int m_moved_count = 0;
+    };
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "colliders.h"
+
+#include "maths/maths.h"
+
+#include <optional>
+
+namespace phys
+{
+    //where a moving shape first touches a still one
+    struct SweepHit
+    {
+        float fraction = 0.f; //of the motion, 0 to 1
+        maths::Vector3 normal = maths::Vector3::zero(); //from the still shape towards the moving one
+    };
+
+    //time of impact of a sphere moving by motion, for both shapes moving pass their relative motion
+    //  already overlapping hits at 0 if moving further in, shapes touching or overlapping and separating don't hit
+    std::optional<SweepHit> sweep(const Sphere& moving, maths::Vector3 motion, const Sphere& still);
+    std::optional<SweepHit> sweep(const Sphere& moving, maths::Vector3 motion, const AABB3& still);
+}
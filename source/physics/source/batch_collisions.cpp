@@ -0,0 +1,250 @@
+#include "batch_collisions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX__)
+#define PHYS_AVX 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PHYS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace phys
+{
+    //Lanes
+    //  the kernels are written once against these, operations are in the same order as the scalar intersects()
+    //  so every width gives the same answer, the scalar one handles what's left over after the widest
+
+    struct ScalarLanes
+    {
+        static constexpr int width = 1;
+        using Mask = bool;
+
+        float value;
+
+        static ScalarLanes load(const float* values) { return {*values}; }
+        static ScalarLanes set(float value) { return {value}; }
+        static void store(float* out, ScalarLanes lanes) { *out = lanes.value; }
+        static uint32_t bits(Mask mask) { return mask ? 1u : 0u; }
+        static Mask both(Mask a, Mask b) { return a && b; }
+
+        friend ScalarLanes operator+(ScalarLanes a, ScalarLanes b) { return {a.value + b.value}; }
+        friend ScalarLanes operator-(ScalarLanes a, ScalarLanes b) { return {a.value - b.value}; }
+        friend ScalarLanes operator*(ScalarLanes a, ScalarLanes b) { return {a.value * b.value}; }
+        friend Mask operator<(ScalarLanes a, ScalarLanes b) { return a.value < b.value; }
+        friend Mask operator>(ScalarLanes a, ScalarLanes b) { return a.value > b.value; }
+        //picking the same operand as minps/maxps when they're equal
+        friend ScalarLanes min(ScalarLanes a, ScalarLanes b) { return {a.value < b.value ? a.value : b.value}; }
+        friend ScalarLanes max(ScalarLanes a, ScalarLanes b) { return {a.value > b.value ? a.value : b.value}; }
+        friend ScalarLanes sqrt(ScalarLanes a) { return {std::sqrt(a.value)}; }
+    };
+
+#if PHYS_AVX
+    struct AvxLanes
+    {
+        static constexpr int width = 8;
+        using Mask = __m256;
+
+        __m256 value;
+
+        static AvxLanes load(const float* values) { return {_mm256_loadu_ps(values)}; }
+        static AvxLanes set(float value) { return {_mm256_set1_ps(value)}; }
+        static void store(float* out, AvxLanes lanes) { _mm256_storeu_ps(out, lanes.value); }
+        static uint32_t bits(Mask mask) { return (uint32_t)_mm256_movemask_ps(mask); }
+        static Mask both(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+
+        friend AvxLanes operator+(AvxLanes a, AvxLanes b) { return {_mm256_add_ps(a.value, b.value)}; }
+        friend AvxLanes operator-(AvxLanes a, AvxLanes b) { return {_mm256_sub_ps(a.value, b.value)}; }
+        friend AvxLanes operator*(AvxLanes a, AvxLanes b) { return {_mm256_mul_ps(a.value, b.value)}; }
+        friend Mask operator<(AvxLanes a, AvxLanes b) { return _mm256_cmp_ps(a.value, b.value, _CMP_LT_OQ); }
+        friend Mask operator>(AvxLanes a, AvxLanes b) { return _mm256_cmp_ps(a.value, b.value, _CMP_GT_OQ); }
+        friend AvxLanes min(AvxLanes a, AvxLanes b) { return {_mm256_min_ps(a.value, b.value)}; }
+        friend AvxLanes max(AvxLanes a, AvxLanes b) { return {_mm256_max_ps(a.value, b.value)}; }
+        friend AvxLanes sqrt(AvxLanes a) { return {_mm256_sqrt_ps(a.value)}; }
+    };
+    using WideLanes = AvxLanes;
+#elif PHYS_SSE2
+    struct SseLanes
+    {
+        static constexpr int width = 4;
+        using Mask = __m128;
+
+        __m128 value;
+
+        static SseLanes load(const float* values) { return {_mm_loadu_ps(values)}; }
+        static SseLanes set(float value) { return {_mm_set1_ps(value)}; }
+        static void store(float* out, SseLanes lanes) { _mm_storeu_ps(out, lanes.value); }
+        static uint32_t bits(Mask mask) { return (uint32_t)_mm_movemask_ps(mask); }
+        static Mask both(Mask a, Mask b) { return _mm_and_ps(a, b); }
+
+        friend SseLanes operator+(SseLanes a, SseLanes b) { return {_mm_add_ps(a.value, b.value)}; }
+        friend SseLanes operator-(SseLanes a, SseLanes b) { return {_mm_sub_ps(a.value, b.value)}; }
+        friend SseLanes operator*(SseLanes a, SseLanes b) { return {_mm_mul_ps(a.value, b.value)}; }
+        friend Mask operator<(SseLanes a, SseLanes b) { return _mm_cmplt_ps(a.value, b.value); }
+        friend Mask operator>(SseLanes a, SseLanes b) { return _mm_cmpgt_ps(a.value, b.value); }
+        friend SseLanes min(SseLanes a, SseLanes b) { return {_mm_min_ps(a.value, b.value)}; }
+        friend SseLanes max(SseLanes a, SseLanes b) { return {_mm_max_ps(a.value, b.value)}; }
+        friend SseLanes sqrt(SseLanes a) { return {_mm_sqrt_ps(a.value)}; }
+    };
+    using WideLanes = SseLanes;
+#else
+    using WideLanes = ScalarLanes;
+#endif
+
+    //Private functions
+
+    //clamp as std::clamp does for a valid box, lo where v < lo, hi where hi < v
+    template<typename Lanes>
+    static Lanes clamp(Lanes v, Lanes lo, Lanes hi)
+    {
+        return min(max(v, lo), hi);
+    }
+
+    template<typename Lanes>
+    static typename Lanes::Mask sphere_sphere(const Sphere& a, const SphereBatch& batch, int i, Lanes& penetration)
+    {
+        const Lanes dx = Lanes::set(a.pos.x) - Lanes::load(&batch.x[i]);
+        const Lanes dy = Lanes::set(a.pos.y) - Lanes::load(&batch.y[i]);
+        const Lanes dz = Lanes::set(a.pos.z) - Lanes::load(&batch.z[i]);
+        const Lanes radii_combined = Lanes::set(a.radius) + Lanes::load(&batch.radius[i]);
+        const Lanes separation_squared = dx * dx + dy * dy + dz * dz;
+        penetration = radii_combined - sqrt(separation_squared);
+        return separation_squared < radii_combined * radii_combined;
+    }
+
+    template<typename Lanes>
+    static typename Lanes::Mask sphere_aabb(const Sphere& sphere, const AABBBatch& batch, int i, Lanes& penetration)
+    {
+        const Lanes x = Lanes::set(sphere.pos.x);
+        const Lanes y = Lanes::set(sphere.pos.y);
+        const Lanes z = Lanes::set(sphere.pos.z);
+        const Lanes dx = clamp(x, Lanes::load(&batch.min_x[i]), Lanes::load(&batch.max_x[i])) - x;
+        const Lanes dy = clamp(y, Lanes::load(&batch.min_y[i]), Lanes::load(&batch.max_y[i])) - y;
+        const Lanes dz = clamp(z, Lanes::load(&batch.min_z[i]), Lanes::load(&batch.max_z[i])) - z;
+        const Lanes radius = Lanes::set(sphere.radius);
+        const Lanes separation_squared = dx * dx + dy * dy + dz * dz;
+        //centres inside the box count as touching the surface, the depth to the nearest face isn't worked out
+        penetration = radius - sqrt(separation_squared);
+        return separation_squared < radius * radius;
+    }
+
+    template<typename Lanes>
+    static typename Lanes::Mask aabb_aabb(const AABB3& a, const AABBBatch& batch, int i, Lanes& penetration)
+    {
+        const Lanes min_x = Lanes::load(&batch.min_x[i]);
+        const Lanes min_y = Lanes::load(&batch.min_y[i]);
+        const Lanes min_z = Lanes::load(&batch.min_z[i]);
+        const Lanes max_x = Lanes::load(&batch.max_x[i]);
+        const Lanes max_y = Lanes::load(&batch.max_y[i]);
+        const Lanes max_z = Lanes::load(&batch.max_z[i]);
+        const Lanes a_min_x = Lanes::set(a.min.x), a_max_x = Lanes::set(a.max.x);
+        const Lanes a_min_y = Lanes::set(a.min.y), a_max_y = Lanes::set(a.max.y);
+        const Lanes a_min_z = Lanes::set(a.min.z), a_max_z = Lanes::set(a.max.z);
+
+        const Lanes overlap_x = min(a_max_x, max_x) - max(a_min_x, min_x);
+        const Lanes overlap_y = min(a_max_y, max_y) - max(a_min_y, min_y);
+        const Lanes overlap_z = min(a_max_z, max_z) - max(a_min_z, min_z);
+        penetration = min(min(overlap_x, overlap_y), overlap_z);
+
+        const auto overlaps_x = Lanes::both(a_max_x > min_x, a_min_x < max_x);
+        const auto overlaps_y = Lanes::both(a_max_y > min_y, a_min_y < max_y);
+        const auto overlaps_z = Lanes::both(a_max_z > min_z, a_min_z < max_z);
+        return Lanes::both(Lanes::both(overlaps_x, overlaps_y), overlaps_z);
+    }
+
+    //runs the kernel over the range as wide as possible then one at a time, packing the masks into hits
+    template<typename Shape, typename Batch, typename WideKernel, typename ScalarKernel>
+    static void run_kernel(const Shape& shape, const Batch& batch, int first, int count, uint32_t* hits, float* penetration,
+        WideKernel wide_kernel, ScalarKernel scalar_kernel)
+    {
+        std::memset(hits, 0, sizeof(uint32_t) * hit_mask_words(count));
+
+        int i = 0;
+        for (; i + WideLanes::width <= count; i += WideLanes::width)
+        {
+            WideLanes depth;
+            const uint32_t bits = WideLanes::bits(wide_kernel(shape, batch, first + i, depth));
+            //width divides 32, so a group never straddles two words
+            hits[i / 32] |= bits << (i % 32);
+            if (penetration)
+            {
+                WideLanes::store(penetration + i, depth);
+            }
+        }
+        for (; i < count; ++i)
+        {
+            ScalarLanes depth;
+            const uint32_t bits = ScalarLanes::bits(scalar_kernel(shape, batch, first + i, depth));
+            hits[i / 32] |= bits << (i % 32);
+            if (penetration)
+            {
+                penetration[i] = depth.value;
+            }
+        }
+    }
+
+    //SphereBatch =====================================================================
+
+    void SphereBatch::add(const Sphere& sphere)
+    {
+        x.push_back(sphere.pos.x);
+        y.push_back(sphere.pos.y);
+        z.push_back(sphere.pos.z);
+        radius.push_back(sphere.radius);
+    }
+
+    void SphereBatch::clear()
+    {
+        x.clear();
+        y.clear();
+        z.clear();
+        radius.clear();
+    }
+
+    //AABBBatch =====================================================================
+
+    void AABBBatch::add(const AABB3& aabb)
+    {
+        min_x.push_back(aabb.min.x);
+        min_y.push_back(aabb.min.y);
+        min_z.push_back(aabb.min.z);
+        max_x.push_back(aabb.max.x);
+        max_y.push_back(aabb.max.y);
+        max_z.push_back(aabb.max.z);
+    }
+
+    void AABBBatch::clear()
+    {
+        min_x.clear();
+        min_y.clear();
+        min_z.clear();
+        max_x.clear();
+        max_y.clear();
+        max_z.clear();
+    }
+
+    //Batched tests =====================================================================
+
+    void intersects(const Sphere& sphere, const SphereBatch& batch, int first, int count, uint32_t* hits, float* penetration)
+    {
+        run_kernel(sphere, batch, first, count, hits, penetration, sphere_sphere<WideLanes>, sphere_sphere<ScalarLanes>);
+    }
+
+    void intersects(const Sphere& sphere, const AABBBatch& batch, int first, int count, uint32_t* hits, float* penetration)
+    {
+        run_kernel(sphere, batch, first, count, hits, penetration, sphere_aabb<WideLanes>, sphere_aabb<ScalarLanes>);
+    }
+
+    void intersects(const AABB3& aabb, const AABBBatch& batch, int first, int count, uint32_t* hits, float* penetration)
+    {
+        run_kernel(aabb, batch, first, count, hits, penetration, aabb_aabb<WideLanes>, aabb_aabb<ScalarLanes>);
+    }
+
+    int batch_collision_width()
+    {
+        return WideLanes::width;
+    }
+}
@@ -0,0 +1,351 @@
+#include "bvh.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace phys
+{
+    using maths::Vector3;
+
+    namespace
+    {
+        constexpr int c_bin_count = 12;
+        constexpr int c_max_leaf_items = 4;
+        constexpr int c_max_depth = 64;
+
+        //relative cost of visiting a node against testing an item
+        constexpr float c_traversal_cost = 1.f;
+    }
+
+    //Private functions
+
+    static float component(const Vector3& vec, int axis)
+    {
+        return (&vec.x)[axis];
+    }
+
+    static AABB3 empty_bounds()
+    {
+        return {{INFINITY, INFINITY, INFINITY}, {-INFINITY, -INFINITY, -INFINITY}};
+    }
+
+    static float surface_area(const AABB3& aabb)
+    {
+        const auto size = aabb.max - aabb.min;
+        if (size.x < 0.f)
+        {
+            return 0.f;
+        }
+        return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    //BVH =====================================================================
+
+    void BVH::build(const std::vector<AABB3>& bounds)
+    {
+        const int count = (int)bounds.size();
+        m_item_bounds = bounds;
+        m_items.resize(count);
+        m_centroids.resize(count);
+        for (int i = 0; i < count; ++i)
+        {
+            m_items[i] = i;
+            m_centroids[i] = (bounds[i].min + bounds[i].max) * 0.5f;
+        }
+
+        m_nodes.clear();
+        m_nodes.reserve(2 * count / c_max_leaf_items + 1);
+        if (count == 0)
+        {
+            return;
+        }
+
+        m_nodes.push_back({empty_bounds(), 0, count});
+        split(0);
+        m_centroids.clear();
+    }
+
+    void BVH::split(int node_index)
+    {
+        //iterative so deep trees don't overflow the stack
+        int stack[c_max_depth * 2];
+        int stack_size = 0;
+        stack[stack_size++] = node_index;
+
+        while (stack_size > 0)
+        {
+            const int index = stack[--stack_size];
+            Node node = m_nodes[index];
+
+            node.bounds = empty_bounds();
+            AABB3 centroid_bounds = empty_bounds();
+            for (int i = node.first; i < node.first + node.count; ++i)
+            {
+                const int item = m_items[i];
+                node.bounds = merge(node.bounds, m_item_bounds[item]);
+                centroid_bounds = merge(centroid_bounds, {m_centroids[item], m_centroids[item]});
+            }
+            m_nodes[index] = node;
+
+            if (node.count <= c_max_leaf_items || stack_size + 2 > (int)std::size(stack))
+            {
+                continue;
+            }
+
+            //bin along the axis the centroids spread furthest on
+            const auto extent = centroid_bounds.max - centroid_bounds.min;
+            const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+            const float axis_min = component(centroid_bounds.min, axis);
+            const float axis_extent = component(extent, axis);
+            if (axis_extent <= 0.f)
+            {
+                //every centroid in one place, nothing to split on
+                continue;
+            }
+
+            struct Bin
+            {
+                AABB3 bounds = empty_bounds();
+                int count = 0;
+            };
+            Bin bins[c_bin_count];
+            const float bin_scale = c_bin_count / axis_extent;
+            auto bin_of = [&](int item)
+            {
+                return std::min((int)((component(m_centroids[item], axis) - axis_min) * bin_scale), c_bin_count - 1);
+            };
+            for (int i = node.first; i < node.first + node.count; ++i)
+            {
+                auto& bin = bins[bin_of(m_items[i])];
+                bin.bounds = merge(bin.bounds, m_item_bounds[m_items[i]]);
+                ++bin.count;
+            }
+
+            //cost of each split between bins, sweeping from both ends
+            float right_area[c_bin_count - 1];
+            int right_count[c_bin_count - 1];
+            {
+                AABB3 bounds = empty_bounds();
+                int count = 0;
+                for (int i = c_bin_count - 1; i > 0; --i)
+                {
+                    bounds = merge(bounds, bins[i].bounds);
+                    count += bins[i].count;
+                    right_area[i - 1] = surface_area(bounds);
+                    right_count[i - 1] = count;
+                }
+            }
+
+            int best_split = -1;
+            float best_cost = (float)node.count; //cost of leaving it as a leaf, relative to the node's area
+            {
+                AABB3 bounds = empty_bounds();
+                int count = 0;
+                const float inv_area = 1.f / std::max(surface_area(node.bounds), 1e-12f);
+                for (int i = 0; i < c_bin_count - 1; ++i)
+                {
+                    bounds = merge(bounds, bins[i].bounds);
+                    count += bins[i].count;
+                    const float cost = c_traversal_cost + (surface_area(bounds) * count + right_area[i] * right_count[i]) * inv_area;
+                    if (count > 0 && right_count[i] > 0 && cost < best_cost)
+                    {
+                        best_cost = cost;
+                        best_split = i;
+                    }
+                }
+            }
+            if (best_split == -1)
+            {
+                continue;
+            }
+
+            const auto middle = std::partition(m_items.begin() + node.first, m_items.begin() + node.first + node.count, [&](int item)
+            {
+                return bin_of(item) <= best_split;
+            });
+            const int left_count = (int)(middle - m_items.begin()) - node.first;
+
+            const int left = (int)m_nodes.size();
+            m_nodes.push_back({empty_bounds(), node.first, left_count});
+            m_nodes.push_back({empty_bounds(), node.first + left_count, node.count - left_count});
+            m_nodes[index].first = left;
+            m_nodes[index].count = 0;
+
+            stack[stack_size++] = left + 1;
+            stack[stack_size++] = left;
+        }
+    }
+
+    void BVH::refit(const std::vector<AABB3>& bounds)
+    {
+        assert(bounds.size() == m_item_bounds.size());
+        m_item_bounds = bounds;
+
+        //children always come after their parent, so going backwards sees them first
+        for (int index = (int)m_nodes.size() - 1; index >= 0; --index)
+        {
+            auto& node = m_nodes[index];
+            if (node.count > 0)
+            {
+                node.bounds = empty_bounds();
+                for (int i = node.first; i < node.first + node.count; ++i)
+                {
+                    node.bounds = merge(node.bounds, m_item_bounds[m_items[i]]);
+                }
+            }
+            else
+            {
+                node.bounds = merge(m_nodes[node.first].bounds, m_nodes[node.first + 1].bounds);
+            }
+        }
+    }
+
+    std::optional<BVH::RayHit> BVH::raycast(const Ray& ray, float max_distance, const RayTest& test) const
+    {
+        if (m_nodes.empty())
+        {
+            return std::nullopt;
+        }
+
+        const Vector3 inv_direction = {1.f / ray.direction.x, 1.f / ray.direction.y, 1.f / ray.direction.z};
+        std::optional<RayHit> nearest;
+        float nearest_distance = max_distance;
+
+        struct Entry
+        {
+            int node;
+            float distance;
+        };
+        Entry stack[c_max_depth * 2];
+        int stack_size = 0;
+        if (auto distance = phys::raycast(ray, inv_direction, m_nodes[0].bounds); distance && *distance <= max_distance)
+        {
+            stack[stack_size++] = {0, *distance};
+        }
+
+        while (stack_size > 0)
+        {
+            const auto entry = stack[--stack_size];
+            if (entry.distance > nearest_distance)
+            {
+                continue;
+            }
+
+            const auto& node = m_nodes[entry.node];
+            if (node.count > 0)
+            {
+                for (int i = node.first; i < node.first + node.count; ++i)
+                {
+                    const int item = m_items[i];
+                    auto distance = phys::raycast(ray, inv_direction, m_item_bounds[item]);
+                    if (distance && test)
+                    {
+                        distance = test(item);
+                    }
+                    if (distance && *distance <= nearest_distance)
+                    {
+                        nearest_distance = *distance;
+                        nearest = RayHit{item, *distance};
+                    }
+                }
+                continue;
+            }
+
+            //visit the nearer child first so the further one is more likely to be skipped
+            auto left = phys::raycast(ray, inv_direction, m_nodes[node.first].bounds);
+            auto right = phys::raycast(ray, inv_direction, m_nodes[node.first + 1].bounds);
+            const bool left_first = left && (!right || *left <= *right);
+            if (left_first && right && *right <= nearest_distance)
+            {
+                stack[stack_size++] = {node.first + 1, *right};
+            }
+            if (left && *left <= nearest_distance)
+            {
+                stack[stack_size++] = {node.first, *left};
+            }
+            if (!left_first && right && *right <= nearest_distance)
+            {
+                stack[stack_size++] = {node.first + 1, *right};
+            }
+        }
+        return nearest;
+    }
+
+    template<typename Overlaps>
+    void BVH::query(const Overlaps& overlaps, std::vector<int>& items) const
+    {
+        if (m_nodes.empty())
+        {
+            return;
+        }
+
+        int stack[c_max_depth * 2];
+        int stack_size = 0;
+        stack[stack_size++] = 0;
+        while (stack_size > 0)
+        {
+            const auto& node = m_nodes[stack[--stack_size]];
+            if (!overlaps(node.bounds))
+            {
+                continue;
+            }
+            if (node.count > 0)
+            {
+                for (int i = node.first; i < node.first + node.count; ++i)
+                {
+                    if (overlaps(m_item_bounds[m_items[i]]))
+                    {
+                        items.push_back(m_items[i]);
+                    }
+                }
+                continue;
+            }
+            stack[stack_size++] = node.first + 1;
+            stack[stack_size++] = node.first;
+        }
+    }
+
+    void BVH::query(const AABB3& aabb, std::vector<int>& items) const
+    {
+        query([&](const AABB3& bounds) { return intersects(aabb, bounds); }, items);
+    }
+
+    void BVH::query(const Sphere& sphere, std::vector<int>& items) const
+    {
+        query([&](const AABB3& bounds) { return intersects(sphere, bounds); }, items);
+    }
+
+    void BVH::find_pairs(std::vector<BodyPair>& pairs) const
+    {
+        pairs.clear();
+        std::vector<int> overlapping;
+        for (int a = 0; a < item_count(); ++a)
+        {
+            overlapping.clear();
+            query(m_item_bounds[a], overlapping);
+            for (int b : overlapping)
+            {
+                if (b > a)
+                {
+                    pairs.push_back({a, b});
+                }
+            }
+        }
+        std::sort(pairs.begin(), pairs.end());
+    }
+
+    float BVH::cost() const
+    {
+        if (m_nodes.empty())
+        {
+            return 0.f;
+        }
+
+        float total = 0.f;
+        for (auto& node : m_nodes)
+        {
+            total += surface_area(node.bounds);
+        }
+        return total / std::max(surface_area(m_nodes[0].bounds), 1e-12f);
+    }
+}
@@ -0,0 +1,149 @@
+#include "contacts.h"
+
+#include <cmath>
+
+namespace phys
+{
+    //Private functions
+
+    static float& component(maths::Vector3& vec, int axis)
+    {
+        return (&vec.x)[axis];
+    }
+
+    static float component(const maths::Vector3& vec, int axis)
+    {
+        return (&vec.x)[axis];
+    }
+
+    static void set_single_point(ContactManifold& manifold, maths::Vector3 normal, maths::Vector3 position, float penetration)
+    {
+        manifold.normal = normal;
+        manifold.point_count = 1;
+        manifold.points[0] = {};
+        manifold.points[0].position = position;
+        manifold.points[0].penetration = penetration;
+    }
+
+    //Collision functions =====================================================================
+
+    bool collide(const Sphere& a, const Sphere& b, ContactManifold& manifold)
+    {
+        const auto separation = b.pos - a.pos;
+        const float radii_combined = a.radius + b.radius;
+        const float separation_squared = separation.magnitude_squared();
+        if (separation_squared >= radii_combined * radii_combined)
+        {
+            return false;
+        }
+
+        //coincident centres have no direction between them, any will do
+        const float distance = std::sqrt(separation_squared);
+        const auto normal = distance > 1e-6f ? separation / distance : maths::Vector3::unit_y();
+        const float penetration = radii_combined - distance;
+        set_single_point(manifold, normal, a.pos + normal * (a.radius - 0.5f * penetration), penetration);
+        return true;
+    }
+
+    bool collide(const Sphere& sphere, const AABB3& aabb, ContactManifold& manifold)
+    {
+        const auto closest_point = aabb.clamp_point(sphere.pos);
+        const auto separation = closest_point - sphere.pos;
+        const float separation_squared = separation.magnitude_squared();
+        if (separation_squared >= sphere.radius * sphere.radius)
+        {
+            return false;
+        }
+
+        if (separation_squared > 1e-12f)
+        {
+            const float distance = std::sqrt(separation_squared);
+            set_single_point(manifold, separation / distance, closest_point, sphere.radius - distance);
+            return true;
+        }
+
+        //centre inside the box, push out through the nearest face
+        int nearest_axis = 0;
+        float nearest_distance = INFINITY;
+        float nearest_sign = 1.f;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float to_min = component(sphere.pos, axis) - component(aabb.min, axis);
+            const float to_max = component(aabb.max, axis) - component(sphere.pos, axis);
+            if (to_min < nearest_distance)
+            {
+                nearest_axis = axis;
+                nearest_distance = to_min;
+                nearest_sign = -1.f;
+            }
+            if (to_max < nearest_distance)
+            {
+                nearest_axis = axis;
+                nearest_distance = to_max;
+                nearest_sign = 1.f;
+            }
+        }
+
+        //normal points from the sphere into the box, so opposite the face it leaves through
+        auto normal = maths::Vector3::zero();
+        component(normal, nearest_axis) = -nearest_sign;
+        set_single_point(manifold, normal, sphere.pos, sphere.radius + nearest_distance);
+        return true;
+    }
+
+    bool collide(const AABB3& aabb, const Sphere& sphere, ContactManifold& manifold)
+    {
+        if (!collide(sphere, aabb, manifold))
+        {
+            return false;
+        }
+        manifold.normal = -manifold.normal;
+        return true;
+    }
+
+    bool collide(const AABB3& a, const AABB3& b, ContactManifold& manifold)
+    {
+        auto overlap_min = maths::Vector3::zero();
+        auto overlap_max = maths::Vector3::zero();
+        int axis = 0;
+        float penetration = INFINITY;
+        for (int i = 0; i < 3; ++i)
+        {
+            component(overlap_min, i) = std::fmax(component(a.min, i), component(b.min, i));
+            component(overlap_max, i) = std::fmin(component(a.max, i), component(b.max, i));
+            const float overlap = component(overlap_max, i) - component(overlap_min, i);
+            if (overlap <= 0.f)
+            {
+                return false;
+            }
+            if (overlap < penetration)
+            {
+                axis = i;
+                penetration = overlap;
+            }
+        }
+
+        //separate along the axis of least overlap, towards b
+        const float a_centre = component(a.min, axis) + component(a.max, axis);
+        const float b_centre = component(b.min, axis) + component(b.max, axis);
+        manifold.normal = maths::Vector3::zero();
+        component(manifold.normal, axis) = b_centre >= a_centre ? 1.f : -1.f;
+
+        //corners of the overlapping face, halfway through the overlap
+        const int u = (axis + 1) % 3;
+        const int v = (axis + 2) % 3;
+        const float middle = 0.5f * (component(overlap_min, axis) + component(overlap_max, axis));
+        manifold.point_count = 4;
+        for (int corner = 0; corner < 4; ++corner)
+        {
+            auto& point = manifold.points[corner];
+            point = {};
+            component(point.position, axis) = middle;
+            component(point.position, u) = (corner & 1) ? component(overlap_max, u) : component(overlap_min, u);
+            component(point.position, v) = (corner & 2) ? component(overlap_max, v) : component(overlap_min, v);
+            point.penetration = penetration;
+            point.id = axis * 4 + corner;
+        }
+        return true;
+    }
+}
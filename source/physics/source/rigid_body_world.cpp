@@ -0,0 +1,740 @@
+#include "rigid_body_world.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+
+namespace phys
+{
+    using maths::Vector3;
+
+    namespace
+    {
+        //surfaces a fast sphere can slide off of in one step before it's stopped for the rest of it
+        constexpr int c_max_sweep_hits = 4;
+        //steps the broadphase is refit for before it's rebuilt
+        constexpr int c_broadphase_rebuild_interval = 30;
+    }
+
+    //Private functions
+
+    static bool manifold_order(const ContactManifold& lhs, const ContactManifold& rhs)
+    {
+        return lhs.body_a != rhs.body_a ? lhs.body_a < rhs.body_a : lhs.body_b < rhs.body_b;
+    }
+
+    //any two directions perpendicular to the normal and each other, for friction
+    static void tangent_basis(Vector3 normal, Vector3& t1, Vector3& t2)
+    {
+        if (std::fabs(normal.x) >= 0.57735f)
+        {
+            t1 = Vector3(normal.y, -normal.x, 0.f).normalized();
+        }
+        else
+        {
+            t1 = Vector3(0.f, normal.z, -normal.y).normalized();
+        }
+        t2 = Vector3::cross(normal, t1);
+    }
+
+    //RigidBodyWorld =====================================================================
+
+    RigidBodyWorld::RigidBodyWorld(WorldSettings settings)
+        : m_settings(settings)
+        , m_broadphase(std::make_unique<BVH>())
+    {}
+
+    void RigidBodyWorld::set_broadphase(std::unique_ptr<Broadphase> broadphase)
+    {
+        m_broadphase = std::move(broadphase);
+        m_broadphase_stale = true;
+    }
+
+    int RigidBodyWorld::add_sphere(const Sphere& sphere, float mass, Vector3 velocity)
+    {
+        //solid sphere, 2/5 m r^2
+        const float inverse_inertia = mass > 0.f ? 1.f / (0.4f * mass * sphere.radius * sphere.radius) : 0.f;
+        return add_body(ShapeType::Sphere, sphere.pos, {sphere.radius, sphere.radius, sphere.radius}, mass, inverse_inertia, velocity);
+    }
+
+    int RigidBodyWorld::add_box(const AABB3& aabb, float mass, Vector3 velocity)
+    {
+        return add_body(ShapeType::Box, (aabb.min + aabb.max) * 0.5f, (aabb.max - aabb.min) * 0.5f, mass, 0.f, velocity);
+    }
+
+    int RigidBodyWorld::add_body(ShapeType shape, Vector3 position, Vector3 extents, float mass, float inverse_inertia, Vector3 velocity)
+    {
+        assert(mass >= 0.f);
+        const bool dynamic = mass > 0.f;
+
+        m_positions.push_back(position);
+        m_velocities.push_back(dynamic ? velocity : Vector3::zero());
+        m_angular_velocities.push_back(Vector3::zero());
+        m_orientations.push_back(maths::Quaternion::identity());
+        m_inverse_masses.push_back(dynamic ? 1.f / mass : 0.f);
+        m_inverse_inertias.push_back(inverse_inertia);
+        m_shapes.push_back(shape);
+        m_extents.push_back(extents);
+        m_broadphase_stale = true;
+        return body_count() - 1;
+    }
+
+    void RigidBodyWorld::clear()
+    {
+        m_positions.clear();
+        m_velocities.clear();
+        m_angular_velocities.clear();
+        m_orientations.clear();
+        m_inverse_masses.clear();
+        m_inverse_inertias.clear();
+        m_shapes.clear();
+        m_extents.clear();
+        m_contacts.clear();
+        m_previous_contacts.clear();
+        m_broadphase_stale = true;
+    }
+
+    Sphere RigidBodyWorld::sphere(int body) const
+    {
+        assert(m_shapes[body] == ShapeType::Sphere);
+        return {m_positions[body], m_extents[body].x};
+    }
+
+    AABB3 RigidBodyWorld::bounds(int body) const
+    {
+        return {m_positions[body] - m_extents[body], m_positions[body] + m_extents[body]};
+    }
+
+    float RigidBodyWorld::kinetic_energy() const
+    {
+        float energy = 0.f;
+        for (int i = 0; i < body_count(); ++i)
+        {
+            if (m_inverse_masses[i] > 0.f)
+            {
+                energy += 0.5f * m_velocities[i].magnitude_squared() / m_inverse_masses[i];
+            }
+            if (m_inverse_inertias[i] > 0.f)
+            {
+                energy += 0.5f * m_angular_velocities[i].magnitude_squared() / m_inverse_inertias[i];
+            }
+        }
+        return energy;
+    }
+
+    void RigidBodyWorld::step(float dt)
+    {
+        if (dt <= 0.f)
+        {
+            return;
+        }
+
+        //semi-implicit euler, positions move with the velocities after contacts have corrected them
+        integrate_velocities(dt);
+        find_pairs();
+        generate_contacts();
+        prepare_contacts(dt);
+        build_islands();
+        solve_islands();
+        sweep_fast_bodies(dt);
+        integrate_positions(dt);
+    }
+
+    void RigidBodyWorld::integrate_velocities(float dt)
+    {
+        const Vector3 gravity_step = m_settings.gravity * dt;
+        parallel_ranges(body_count(), 1024, [&](int begin, int end)
+        {
+            for (int i = begin; i < end; ++i)
+            {
+                if (m_inverse_masses[i] > 0.f)
+                {
+                    m_velocities[i] += gravity_step;
+                }
+            }
+        });
+    }
+
+    void RigidBodyWorld::find_pairs()
+    {
+        m_bounds.resize(body_count());
+        for (int i = 0; i < body_count(); ++i)
+        {
+            m_bounds[i] = bounds(i);
+        }
+
+        //refitting is cheaper but loosens the structure as bodies move, so it's rebuilt every so often and whenever bodies change
+        if (m_broadphase_stale || m_steps_since_build >= c_broadphase_rebuild_interval)
+        {
+            m_broadphase->build(m_bounds);
+            m_broadphase_stale = false;
+            m_steps_since_build = 0;
+        }
+        else
+        {
+            m_broadphase->refit(m_bounds);
+            ++m_steps_since_build;
+        }
+
+        //sorted, so contacts come out in the same order whichever broadphase found them
+        m_broadphase->find_pairs(m_pairs);
+        std::erase_if(m_pairs, [this](const BodyPair& pair)
+        {
+            return m_inverse_masses[pair.a] == 0.f && m_inverse_masses[pair.b] == 0.f;
+        });
+    }
+
+    void RigidBodyWorld::generate_contacts()
+    {
+        //every pair is collided into its own slot, then the ones touching are gathered in pair order
+        m_pair_touching.resize(m_pairs.size());
+        m_pair_contacts.resize(m_pairs.size());
+        parallel_ranges((int)m_pairs.size(), 256, [&](int begin, int end)
+        {
+            for (int i = begin; i < end; ++i)
+            {
+                auto [a, b] = m_pairs[i];
+                auto& manifold = m_pair_contacts[i];
+                bool touching = false;
+                if (m_shapes[a] == ShapeType::Sphere)
+                {
+                    touching = m_shapes[b] == ShapeType::Sphere
+                        ? collide(sphere(a), sphere(b), manifold)
+                        : collide(sphere(a), m_bounds[b], manifold);
+                }
+                else
+                {
+                    touching = m_shapes[b] == ShapeType::Sphere
+                        ? collide(m_bounds[a], sphere(b), manifold)
+                        : collide(m_bounds[a], m_bounds[b], manifold);
+                }
+                manifold.body_a = a;
+                manifold.body_b = b;
+                m_pair_touching[i] = touching;
+            }
+        });
+
+        //last step's contacts hold the impulses to warm start with
+        std::swap(m_contacts, m_previous_contacts);
+        m_contacts.clear();
+        for (int i = 0; i < (int)m_pairs.size(); ++i)
+        {
+            if (m_pair_touching[i])
+            {
+                m_contacts.push_back(m_pair_contacts[i]);
+            }
+        }
+
+        if (!m_settings.warm_starting)
+        {
+            return;
+        }
+
+        //both lists are sorted by body pair, walk them together to carry over impulses for points that persist
+        assert(std::is_sorted(m_contacts.begin(), m_contacts.end(), manifold_order));
+        auto previous = m_previous_contacts.begin();
+        for (auto& manifold : m_contacts)
+        {
+            while (previous != m_previous_contacts.end() && manifold_order(*previous, manifold))
+            {
+                ++previous;
+            }
+            if (previous == m_previous_contacts.end())
+            {
+                break;
+            }
+            if (manifold_order(manifold, *previous))
+            {
+                continue;
+            }
+
+            for (int i = 0; i < manifold.point_count; ++i)
+            {
+                auto& point = manifold.points[i];
+                for (int j = 0; j < previous->point_count; ++j)
+                {
+                    auto& previous_point = previous->points[j];
+                    if (point.id == previous_point.id)
+                    {
+                        point.normal_impulse = previous_point.normal_impulse;
+                        point.tangent_impulse[0] = previous_point.tangent_impulse[0];
+                        point.tangent_impulse[1] = previous_point.tangent_impulse[1];
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    void RigidBodyWorld::prepare_contacts(float dt)
+    {
+        m_tangents.resize(m_contacts.size() * 2);
+        m_solver_points.resize(m_contacts.size() * ContactManifold::c_max_points);
+
+        parallel_ranges((int)m_contacts.size(), 256, [&](int begin, int end)
+        {
+            for (int m = begin; m < end; ++m)
+            {
+                auto& manifold = m_contacts[m];
+                const int a = manifold.body_a;
+                const int b = manifold.body_b;
+                const Vector3 normal = manifold.normal;
+                Vector3* tangents = &m_tangents[m * 2];
+                tangent_basis(normal, tangents[0], tangents[1]);
+
+                //resistance of the pair to an impulse along a direction at the point
+                auto effective_mass = [&](const SolverPoint& solver_point, Vector3 direction)
+                {
+                    const float k = m_inverse_masses[a] + m_inverse_masses[b]
+                        + m_inverse_inertias[a] * Vector3::cross(solver_point.offset_a, direction).magnitude_squared()
+                        + m_inverse_inertias[b] * Vector3::cross(solver_point.offset_b, direction).magnitude_squared();
+                    return k > 0.f ? 1.f / k : 0.f;
+                };
+
+                for (int i = 0; i < manifold.point_count; ++i)
+                {
+                    auto& point = manifold.points[i];
+                    auto& solver_point = m_solver_points[m * ContactManifold::c_max_points + i];
+                    solver_point.offset_a = point.position - m_positions[a];
+                    solver_point.offset_b = point.position - m_positions[b];
+                    solver_point.normal_mass = effective_mass(solver_point, normal);
+                    solver_point.tangent_mass[0] = effective_mass(solver_point, tangents[0]);
+                    solver_point.tangent_mass[1] = effective_mass(solver_point, tangents[1]);
+
+                    //push apart whichever is faster, fixing penetration or bouncing
+                    const float separation_speed = m_settings.baumgarte / dt * std::fmax(point.penetration - m_settings.penetration_slop, 0.f);
+                    const float approach_speed = -Vector3::dot(relative_velocity(a, b, solver_point), normal);
+                    const float bounce_speed = approach_speed > m_settings.restitution_threshold ? m_settings.restitution * approach_speed : 0.f;
+                    solver_point.bias = std::fmax(separation_speed, bounce_speed);
+                }
+            }
+        });
+    }
+
+    //smallest body index becomes the root, so islands come out the same however contacts were found
+    int RigidBodyWorld::find_island_root(int body)
+    {
+        while (m_island_parents[body] != body)
+        {
+            m_island_parents[body] = m_island_parents[m_island_parents[body]];
+            body = m_island_parents[body];
+        }
+        return body;
+    }
+
+    void RigidBodyWorld::build_islands()
+    {
+        //static bodies don't carry impulses between the bodies touching them, so don't join islands
+        m_island_parents.resize(body_count());
+        for (int i = 0; i < body_count(); ++i)
+        {
+            m_island_parents[i] = i;
+        }
+        for (auto& manifold : m_contacts)
+        {
+            if (m_inverse_masses[manifold.body_a] > 0.f && m_inverse_masses[manifold.body_b] > 0.f)
+            {
+                const int root_a = find_island_root(manifold.body_a);
+                const int root_b = find_island_root(manifold.body_b);
+                m_island_parents[std::max(root_a, root_b)] = std::min(root_a, root_b);
+            }
+        }
+
+        //number islands in the order they're first touched, counting contacts in each
+        m_body_islands.assign(body_count(), -1);
+        m_contact_islands.resize(m_contacts.size());
+        m_islands.clear();
+        for (int m = 0; m < (int)m_contacts.size(); ++m)
+        {
+            auto& manifold = m_contacts[m];
+            const int body = m_inverse_masses[manifold.body_a] > 0.f ? manifold.body_a : manifold.body_b;
+            const int root = find_island_root(body);
+            if (m_body_islands[root] == -1)
+            {
+                m_body_islands[root] = (int)m_islands.size();
+                m_islands.push_back({0, 0});
+            }
+            m_contact_islands[m] = m_body_islands[root];
+            ++m_islands[m_body_islands[root]].count;
+        }
+
+        //bucket contacts by island keeping contact order within each, counts are rebuilt as write cursors
+        int first = 0;
+        for (auto& island : m_islands)
+        {
+            island.first = first;
+            first += island.count;
+            island.count = 0;
+        }
+        m_island_contacts.resize(m_contacts.size());
+        for (int m = 0; m < (int)m_contacts.size(); ++m)
+        {
+            auto& island = m_islands[m_contact_islands[m]];
+            m_island_contacts[island.first + island.count++] = m;
+        }
+
+        //group small islands into batches of roughly even work for tasks
+        constexpr int c_batch_contacts = 64;
+        m_small_island_batches.clear();
+        int batch_contacts = c_batch_contacts;
+        for (int i = 0; i < (int)m_islands.size(); ++i)
+        {
+            if (m_islands[i].count > m_settings.colouring_threshold)
+            {
+                continue;
+            }
+            if (batch_contacts >= c_batch_contacts)
+            {
+                m_small_island_batches.push_back(i);
+                batch_contacts = 0;
+            }
+            batch_contacts += m_islands[i].count;
+        }
+        m_small_island_batches.push_back((int)m_islands.size());
+    }
+
+    void RigidBodyWorld::solve_islands()
+    {
+        //small islands are each solved whole by one task
+        const int batch_count = (int)m_small_island_batches.size() - 1;
+        auto solve_batch = [&](int batch)
+        {
+            for (int i = m_small_island_batches[batch]; i < m_small_island_batches[batch + 1]; ++i)
+            {
+                auto& island = m_islands[i];
+                if (island.count > m_settings.colouring_threshold)
+                {
+                    continue;
+                }
+
+                const int* contacts = &m_island_contacts[island.first];
+                for (int c = 0; c < island.count; ++c)
+                {
+                    warm_start(contacts[c]);
+                }
+                for (int iteration = 0; iteration < m_settings.velocity_iterations; ++iteration)
+                {
+                    for (int c = 0; c < island.count; ++c)
+                    {
+                        solve_contact(contacts[c]);
+                    }
+                }
+            }
+        };
+        if (m_parallel_for)
+        {
+            m_parallel_for(batch_count, solve_batch);
+        }
+        else
+        {
+            for (int batch = 0; batch < batch_count; ++batch)
+            {
+                solve_batch(batch);
+            }
+        }
+
+        //large ones are split up by colour
+        for (auto& island : m_islands)
+        {
+            if (island.count > m_settings.colouring_threshold)
+            {
+                solve_coloured_island(island);
+            }
+        }
+    }
+
+    //contacts of one colour share no moving bodies, so can be solved at the same time without locking
+    //  colours are solved one after another, which is the order the contacts are solved in whatever the thread count
+    void RigidBodyWorld::solve_coloured_island(const Island& island)
+    {
+        constexpr int c_max_colours = 64;
+        const int* contacts = &m_island_contacts[island.first];
+
+        //greedy colouring, each contact gets the first colour neither moving body has used yet
+        //  contacts that find every colour taken go in a last batch solved on one thread
+        m_body_colours.assign(body_count(), 0);
+        m_contact_colours.resize(island.count);
+        int colour_counts[c_max_colours + 1] = {};
+        for (int c = 0; c < island.count; ++c)
+        {
+            auto& manifold = m_contacts[contacts[c]];
+            const bool dynamic_a = m_inverse_masses[manifold.body_a] > 0.f;
+            const bool dynamic_b = m_inverse_masses[manifold.body_b] > 0.f;
+            const uint64_t used =
+                (dynamic_a ? m_body_colours[manifold.body_a] : 0) |
+                (dynamic_b ? m_body_colours[manifold.body_b] : 0);
+
+            int colour = c_max_colours;
+            if (~used != 0)
+            {
+                colour = std::countr_one(used);
+                if (dynamic_a) m_body_colours[manifold.body_a] |= uint64_t(1) << colour;
+                if (dynamic_b) m_body_colours[manifold.body_b] |= uint64_t(1) << colour;
+            }
+            m_contact_colours[c] = colour;
+            ++colour_counts[colour];
+        }
+
+        m_colour_starts.resize(c_max_colours + 2);
+        m_colour_starts[0] = 0;
+        for (int colour = 0; colour <= c_max_colours; ++colour)
+        {
+            m_colour_starts[colour + 1] = m_colour_starts[colour] + colour_counts[colour];
+        }
+        m_coloured_contacts.resize(island.count);
+        int cursors[c_max_colours + 1];
+        std::copy(m_colour_starts.begin(), m_colour_starts.end() - 1, cursors);
+        for (int c = 0; c < island.count; ++c)
+        {
+            m_coloured_contacts[cursors[m_contact_colours[c]]++] = contacts[c];
+        }
+
+        auto for_each_colour = [&](void (RigidBodyWorld::*solve)(int))
+        {
+            constexpr int c_grain = 32;
+            for (int colour = 0; colour < c_max_colours; ++colour)
+            {
+                const int start = m_colour_starts[colour];
+                const int count = m_colour_starts[colour + 1] - start;
+                parallel_ranges(count, c_grain, [&](int begin, int end)
+                {
+                    for (int i = begin; i < end; ++i)
+                    {
+                        (this->*solve)(m_coloured_contacts[start + i]);
+                    }
+                });
+            }
+            for (int i = m_colour_starts[c_max_colours]; i < m_colour_starts[c_max_colours + 1]; ++i)
+            {
+                (this->*solve)(m_coloured_contacts[i]);
+            }
+        };
+
+        for_each_colour(&RigidBodyWorld::warm_start);
+        for (int iteration = 0; iteration < m_settings.velocity_iterations; ++iteration)
+        {
+            for_each_colour(&RigidBodyWorld::solve_contact);
+        }
+    }
+
+    void RigidBodyWorld::warm_start(int m)
+    {
+        if (!m_settings.warm_starting)
+        {
+            return;
+        }
+
+        auto& manifold = m_contacts[m];
+        const Vector3* tangents = &m_tangents[m * 2];
+        for (int i = 0; i < manifold.point_count; ++i)
+        {
+            auto& point = manifold.points[i];
+            const Vector3 impulse =
+                manifold.normal * point.normal_impulse +
+                tangents[0] * point.tangent_impulse[0] +
+                tangents[1] * point.tangent_impulse[1];
+            apply_impulse(manifold.body_a, manifold.body_b, m_solver_points[m * ContactManifold::c_max_points + i], impulse);
+        }
+    }
+
+    void RigidBodyWorld::solve_contact(int m)
+    {
+        auto& manifold = m_contacts[m];
+        const int a = manifold.body_a;
+        const int b = manifold.body_b;
+        const Vector3* tangents = &m_tangents[m * 2];
+
+        for (int i = 0; i < manifold.point_count; ++i)
+        {
+            auto& point = manifold.points[i];
+            auto& solver_point = m_solver_points[m * ContactManifold::c_max_points + i];
+
+            //normal, accumulated impulse clamped rather than each delta so earlier iterations can be undone
+            {
+                const float normal_speed = Vector3::dot(relative_velocity(a, b, solver_point), manifold.normal);
+                const float delta = solver_point.normal_mass * (solver_point.bias - normal_speed);
+                const float accumulated = std::fmax(point.normal_impulse + delta, 0.f);
+                apply_impulse(a, b, solver_point, manifold.normal * (accumulated - point.normal_impulse));
+                point.normal_impulse = accumulated;
+            }
+
+            //friction, limited by how hard the contact is pushing
+            const float friction_limit = m_settings.friction * point.normal_impulse;
+            for (int t = 0; t < 2; ++t)
+            {
+                const float tangent_speed = Vector3::dot(relative_velocity(a, b, solver_point), tangents[t]);
+                const float delta = -solver_point.tangent_mass[t] * tangent_speed;
+                const float accumulated = std::clamp(point.tangent_impulse[t] + delta, -friction_limit, friction_limit);
+                apply_impulse(a, b, solver_point, tangents[t] * (accumulated - point.tangent_impulse[t]));
+                point.tangent_impulse[t] = accumulated;
+            }
+        }
+    }
+
+    void RigidBodyWorld::sweep_fast_bodies(float dt)
+    {
+        m_step_fractions.assign(body_count(), 1.f);
+        m_step_velocities = m_velocities;
+        if (!m_settings.continuous_collision)
+        {
+            return;
+        }
+
+        //few bodies move this fast, so this is serial and in body order to stay deterministic
+        for (int a = 0; a < body_count(); ++a)
+        {
+            if (m_shapes[a] != ShapeType::Sphere || m_inverse_masses[a] == 0.f)
+            {
+                continue;
+            }
+            const float radius = m_extents[a].x;
+
+            //each hit moves the sphere to it, then the rest of the step is swept again sliding along what was hit
+            //  bodies already hit are convex and slid away from, so only floating point error could hit them again
+            int hit_bodies[c_max_sweep_hits];
+            for (int hit_count = 0;; ++hit_count)
+            {
+                const Vector3 motion = m_step_velocities[a] * (dt * m_step_fractions[a]);
+                if (motion.magnitude_squared() <= radius * radius)
+                {
+                    break;
+                }
+
+                //bounds covering the rest of the step, other bodies are only swept against if theirs overlap
+                auto swept_bounds = [&](int body)
+                {
+                    const auto start = bounds(body);
+                    const Vector3 step = m_step_velocities[body] * (dt * m_step_fractions[body]);
+                    return merge(start, {start.min + step, start.max + step});
+                };
+                const auto bounds_a = swept_bounds(a);
+                const Sphere sphere_a = sphere(a);
+
+                std::optional<SweepHit> first_hit;
+                int first_body = -1;
+                for (int b = 0; b < body_count(); ++b)
+                {
+                    if (b == a || std::find(hit_bodies, hit_bodies + hit_count, b) != hit_bodies + hit_count || !intersects(bounds_a, swept_bounds(b)))
+                    {
+                        continue;
+                    }
+
+                    //sweep with the motion relative to b, as if b stood still
+                    const Vector3 relative_motion = motion - m_step_velocities[b] * (dt * m_step_fractions[b]);
+                    auto hit = m_shapes[b] == ShapeType::Sphere
+                        ? sweep(sphere_a, relative_motion, sphere(b))
+                        : sweep(sphere_a, relative_motion, bounds(b));
+                    if (hit && (!first_hit || hit->fraction < first_hit->fraction))
+                    {
+                        first_hit = hit;
+                        first_body = b;
+                    }
+                }
+                if (!first_hit)
+                {
+                    break;
+                }
+                if (hit_count == c_max_sweep_hits)
+                {
+                    //still hitting things, stay put for the rest of the step rather than risk passing through one
+                    m_step_fractions[a] = 0.f;
+                    break;
+                }
+
+                //both move to the impact with the motion that got them there
+                const int b = first_body;
+                hit_bodies[hit_count] = b;
+                for (int body : {a, b})
+                {
+                    if (m_inverse_masses[body] > 0.f)
+                    {
+                        m_positions[body] += m_step_velocities[body] * (dt * m_step_fractions[body] * first_hit->fraction);
+                        m_step_fractions[body] *= 1.f - first_hit->fraction;
+                    }
+                }
+
+                //for the rest of the step they only lose the motion into each other and slide,
+                //  later steps bounce off as a contact would have
+                const Vector3 normal = first_hit->normal;
+                const float inverse_mass_sum = m_inverse_masses[a] + m_inverse_masses[b];
+                const float step_normal_speed = Vector3::dot(m_step_velocities[a] - m_step_velocities[b], normal);
+                if (step_normal_speed < 0.f)
+                {
+                    const float impulse = -step_normal_speed / inverse_mass_sum;
+                    m_step_velocities[a] += normal * (impulse * m_inverse_masses[a]);
+                    m_step_velocities[b] -= normal * (impulse * m_inverse_masses[b]);
+                }
+                const float normal_speed = Vector3::dot(m_velocities[a] - m_velocities[b], normal);
+                if (normal_speed < 0.f)
+                {
+                    const float restitution = -normal_speed > m_settings.restitution_threshold ? m_settings.restitution : 0.f;
+                    const float impulse = -(1.f + restitution) * normal_speed / inverse_mass_sum;
+                    m_velocities[a] += normal * (impulse * m_inverse_masses[a]);
+                    m_velocities[b] -= normal * (impulse * m_inverse_masses[b]);
+                }
+            }
+        }
+    }
+
+    void RigidBodyWorld::integrate_positions(float dt)
+    {
+        parallel_ranges(body_count(), 1024, [&](int begin, int end)
+        {
+            for (int i = begin; i < end; ++i)
+            {
+                m_positions[i] += m_step_velocities[i] * (dt * m_step_fractions[i]);
+
+                const Vector3& w = m_angular_velocities[i];
+                if (w.x != 0.f || w.y != 0.f || w.z != 0.f)
+                {
+                    //dq/dt = 1/2 w q
+                    auto& q = m_orientations[i];
+                    q = (q + maths::Quaternion{w.x, w.y, w.z, 0.f} * q * (0.5f * dt)).normalized();
+                }
+            }
+        });
+    }
+
+    void RigidBodyWorld::parallel_ranges(int count, int grain, const std::function<void(int, int)>& task) const
+    {
+        const int range_count = (count + grain - 1) / grain;
+        if (!m_parallel_for || range_count <= 1)
+        {
+            if (count > 0)
+            {
+                task(0, count);
+            }
+            return;
+        }
+
+        m_parallel_for(range_count, [&](int range)
+        {
+            task(range * grain, std::min(count, (range + 1) * grain));
+        });
+    }
+
+    //impulse is applied to b and its opposite to a
+    //  static bodies are never written, they're shared between islands being solved at the same time
+    void RigidBodyWorld::apply_impulse(int a, int b, const SolverPoint& solver_point, Vector3 impulse)
+    {
+        if (m_inverse_masses[a] > 0.f)
+        {
+            m_velocities[a] -= impulse * m_inverse_masses[a];
+            m_angular_velocities[a] -= Vector3::cross(solver_point.offset_a, impulse) * m_inverse_inertias[a];
+        }
+        if (m_inverse_masses[b] > 0.f)
+        {
+            m_velocities[b] += impulse * m_inverse_masses[b];
+            m_angular_velocities[b] += Vector3::cross(solver_point.offset_b, impulse) * m_inverse_inertias[b];
+        }
+    }
+
+    //velocity of b's contact point relative to a's
+    Vector3 RigidBodyWorld::relative_velocity(int a, int b, const SolverPoint& solver_point) const
+    {
+        const Vector3 velocity_a = m_velocities[a] + Vector3::cross(m_angular_velocities[a], solver_point.offset_a);
+        const Vector3 velocity_b = m_velocities[b] + Vector3::cross(m_angular_velocities[b], solver_point.offset_b);
+        return velocity_b - velocity_a;
+    }
+}
@@ -0,0 +1,177 @@
+#include "spatial_hash.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace phys
+{
+    //Private functions
+
+    //21 bits per axis, coordinates wrap beyond about a million cells which only costs extra pair tests
+    static uint64_t cell_key(int x, int y, int z)
+    {
+        constexpr uint64_t mask = (1u << 21) - 1;
+        return ((uint64_t)x & mask) | (((uint64_t)y & mask) << 21) | (((uint64_t)z & mask) << 42);
+    }
+
+    template<typename Function>
+    static void for_each_cell(const int min[3], const int max[3], const Function& function)
+    {
+        for (int z = min[2]; z <= max[2]; ++z)
+        {
+            for (int y = min[1]; y <= max[1]; ++y)
+            {
+                for (int x = min[0]; x <= max[0]; ++x)
+                {
+                    function(x, y, z);
+                }
+            }
+        }
+    }
+
+    //SpatialHash =====================================================================
+
+    SpatialHash::SpatialHash(float cell_size)
+        : m_cell_size(cell_size)
+        , m_inv_cell_size(1.f / cell_size)
+    {
+        assert(cell_size > 0.f);
+    }
+
+    void SpatialHash::build(const std::vector<AABB3>& bounds)
+    {
+        m_cells.clear();
+        m_items.resize(bounds.size());
+        for (int i = 0; i < (int)bounds.size(); ++i)
+        {
+            m_items[i] = {bounds[i], cell_range(bounds[i])};
+            insert(i);
+        }
+        m_moved_count = (int)bounds.size();
+    }
+
+    void SpatialHash::refit(const std::vector<AABB3>& bounds)
+    {
+        assert(bounds.size() == m_items.size());
+        m_moved_count = 0;
+        for (int i = 0; i < (int)bounds.size(); ++i)
+        {
+            update(i, bounds[i]);
+        }
+    }
+
+    void SpatialHash::update(int item, const AABB3& bounds)
+    {
+        auto& entry = m_items[item];
+        entry.bounds = bounds;
+
+        const auto cells = cell_range(bounds);
+        if (cells == entry.cells)
+        {
+            return;
+        }
+
+        remove(item);
+        entry.cells = cells;
+        insert(item);
+        ++m_moved_count;
+    }
+
+    void SpatialHash::query(const AABB3& aabb, std::vector<int>& items) const
+    {
+        //an item in several of the cells is only reported from the first of them it shares with the query
+        const auto range = cell_range(aabb);
+        for_each_cell(range.min, range.max, [&](int x, int y, int z)
+        {
+            auto cell = m_cells.find(cell_key(x, y, z));
+            if (cell == m_cells.end())
+            {
+                return;
+            }
+            for (int item : cell->second)
+            {
+                const auto& cells = m_items[item].cells;
+                const bool first_shared =
+                    x == std::max(cells.min[0], range.min[0]) &&
+                    y == std::max(cells.min[1], range.min[1]) &&
+                    z == std::max(cells.min[2], range.min[2]);
+                if (first_shared && intersects(aabb, m_items[item].bounds))
+                {
+                    items.push_back(item);
+                }
+            }
+        });
+    }
+
+    void SpatialHash::find_pairs(std::vector<BodyPair>& pairs) const
+    {
+        pairs.clear();
+        for (auto& [key, items] : m_cells)
+        {
+            for (int i = 0; i < (int)items.size(); ++i)
+            {
+                const auto& a = m_items[items[i]];
+                for (int j = i + 1; j < (int)items.size(); ++j)
+                {
+                    const auto& b = m_items[items[j]];
+                    if (!intersects(a.bounds, b.bounds))
+                    {
+                        continue;
+                    }
+
+                    //items sharing several cells meet in all of them, only the first shared cell reports the pair
+                    const int x = std::max(a.cells.min[0], b.cells.min[0]);
+                    const int y = std::max(a.cells.min[1], b.cells.min[1]);
+                    const int z = std::max(a.cells.min[2], b.cells.min[2]);
+                    if (cell_key(x, y, z) != key)
+                    {
+                        continue;
+                    }
+                    pairs.push_back({std::min(items[i], items[j]), std::max(items[i], items[j])});
+                }
+            }
+        }
+        //cells are visited in hash order
+        std::sort(pairs.begin(), pairs.end());
+    }
+
+    SpatialHash::CellRange SpatialHash::cell_range(const AABB3& aabb) const
+    {
+        CellRange range;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            range.min[axis] = (int)std::floor((&aabb.min.x)[axis] * m_inv_cell_size);
+            range.max[axis] = (int)std::floor((&aabb.max.x)[axis] * m_inv_cell_size);
+        }
+        return range;
+    }
+
+    void SpatialHash::insert(int item)
+    {
+        const auto& cells = m_items[item].cells;
+        for_each_cell(cells.min, cells.max, [&](int x, int y, int z)
+        {
+            m_cells[cell_key(x, y, z)].push_back(item);
+        });
+    }
+
+    void SpatialHash::remove(int item)
+    {
+        const auto& cells = m_items[item].cells;
+        for_each_cell(cells.min, cells.max, [&](int x, int y, int z)
+        {
+            auto cell = m_cells.find(cell_key(x, y, z));
+            assert(cell != m_cells.end());
+            auto& items = cell->second;
+            auto it = std::find(items.begin(), items.end(), item);
+            assert(it != items.end());
+            *it = items.back();
+            items.pop_back();
+            if (items.empty())
+            {
+                m_cells.erase(cell);
+            }
+        });
+    }
+}
@@ -0,0 +1,106 @@
+#include "sweeps.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace phys
+{
+    using maths::Vector3;
+
+    namespace
+    {
+        //gap at which a sweep counts as touching
+        constexpr float c_sweep_tolerance = 1e-4f;
+        constexpr int c_max_sweep_iterations = 32;
+    }
+
+    //Sweep functions =====================================================================
+
+    std::optional<SweepHit> sweep(const Sphere& moving, Vector3 motion, const Sphere& still)
+    {
+        //solve |offset + t * motion| = combined radius for the first t
+        const Vector3 offset = moving.pos - still.pos;
+        const float radius = moving.radius + still.radius;
+        const float a = motion.magnitude_squared();
+        const float b = Vector3::dot(offset, motion);
+        const float c = offset.magnitude_squared() - radius * radius;
+        if (b >= 0.f)
+        {
+            //not approaching
+            return std::nullopt;
+        }
+        if (c <= 0.f)
+        {
+            const float distance = offset.magnitude();
+            return SweepHit{0.f, distance > 0.f ? offset / distance : -motion.normalized()};
+        }
+
+        const float discriminant = b * b - a * c;
+        if (discriminant < 0.f)
+        {
+            return std::nullopt;
+        }
+        const float t = (-b - std::sqrt(discriminant)) / a;
+        if (t > 1.f)
+        {
+            return std::nullopt;
+        }
+        return SweepHit{t, (offset + motion * t).normalized()};
+    }
+
+    std::optional<SweepHit> sweep(const Sphere& moving, Vector3 motion, const AABB3& still)
+    {
+        //the sphere's centre can't reach the rounded box before it reaches the box grown by the radius,
+        //  so start from where it enters that and close the remaining gap by conservative advancement
+        const Vector3 grow = {moving.radius, moving.radius, moving.radius};
+        const AABB3 grown = {still.min - grow, still.max + grow};
+        const Ray ray = {moving.pos, motion};
+        const Vector3 inv_motion = {1.f / motion.x, 1.f / motion.y, 1.f / motion.z};
+
+        float t = 0.f;
+        float t_exit = 1.f;
+        const bool moving_along = motion.x != 0.f || motion.y != 0.f || motion.z != 0.f;
+        if (moving_along)
+        {
+            //exit of the grown box, past which nothing can be hit
+            auto enter = raycast(ray, inv_motion, grown);
+            if (!enter || *enter > 1.f)
+            {
+                return std::nullopt;
+            }
+            t = *enter;
+            const float tx = std::max((grown.min.x - ray.origin.x) * inv_motion.x, (grown.max.x - ray.origin.x) * inv_motion.x);
+            const float ty = std::max((grown.min.y - ray.origin.y) * inv_motion.y, (grown.max.y - ray.origin.y) * inv_motion.y);
+            const float tz = std::max((grown.min.z - ray.origin.z) * inv_motion.z, (grown.max.z - ray.origin.z) * inv_motion.z);
+            t_exit = std::min({tx, ty, tz, 1.f});
+        }
+        const float speed = motion.magnitude();
+
+        for (int iteration = 0; iteration < c_max_sweep_iterations && t <= t_exit; ++iteration)
+        {
+            const Vector3 centre = moving.pos + motion * t;
+            const Vector3 closest = still.clamp_point(centre);
+            const Vector3 separation = centre - closest;
+            const float distance = separation.magnitude();
+            const float gap = distance - moving.radius;
+            if (gap <= c_sweep_tolerance)
+            {
+                //a centre inside the box has no closest direction, use the one it came from
+                const Vector3 normal = distance > 0.f ? separation / distance : -motion.normalized();
+                if (Vector3::dot(normal, motion) >= 0.f)
+                {
+                    //the box is convex, so separating at the first touch means never hitting
+                    return std::nullopt;
+                }
+                return SweepHit{t, normal};
+            }
+            if (!moving_along)
+            {
+                return std::nullopt;
+            }
+            //nothing is hit before the sphere has moved as far as the gap
+            t += gap / speed;
+        }
+        return std::nullopt;
+    }
+}
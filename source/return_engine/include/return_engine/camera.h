@@ -1,8 +1,10 @@
 #pragma once
 
 #include "maths/maths.h"
+#include "maths/vector2.h"
 
 #include "file/file.h"
+#include "physics/colliders.h"
 
 namespace re
 {
@@ -25,6 +27,9 @@ namespace re
         maths::Matrix44 projection_matrix() const;
         maths::Matrix44 perspective_matrix() const;
         maths::Matrix44 orthographic_matrix() const;
+
+        //world space ray through a point on the screen, ndc runs -1 to 1 with y up
+        phys::Ray ray(maths::Vector2 ndc) const;
     };
 
     struct OrbitCamera
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <vector>
 
 namespace re
@@ -27,6 +29,51 @@ namespace re
         int m_count = 0;
     };
 
+    //fixed capacity fifo, never allocates after construction
+    //  push returns false when full, leaving it to the caller what to do with the element
+    template<typename ElementType, int Capacity>
+    class RingBuffer
+    {
+    public:
+        bool push(const ElementType&);
+        ElementType pop();
+
+        int count() const { return m_count; }
+        bool empty() const { return m_count == 0; }
+        bool full() const { return m_count == Capacity; }
+        static constexpr int capacity() { return Capacity; }
+    private:
+        ElementType m_elements[Capacity] = {};
+        int m_next_in_line = 0;
+        int m_count = 0;
+    };
+
+    //passes the latest of a stream of values from one writing thread to one reading thread without locking
+    //  the writer fills write_buffer() then publishes it, the reader takes whatever was published last
+    //  neither ever waits on the other, so the reader may see a value twice or never see one if their rates differ
+    template<typename ElementType>
+    class TripleBuffer
+    {
+    public:
+        //writer thread
+        ElementType& write_buffer() { return m_elements[m_write]; }
+        void publish();
+
+        //reader thread
+        //returns false, keeping the current read buffer, if nothing was published since the last take
+        bool take_latest();
+        ElementType& read_buffer() { return m_elements[m_read]; }
+
+    private:
+        //set in m_shared when it holds a published buffer the reader hasn't taken
+        static constexpr uint8_t c_published = 4;
+
+        ElementType m_elements[3];
+        uint8_t m_write = 0;
+        uint8_t m_read = 1;
+        std::atomic<uint8_t> m_shared = 2;
+    };
+
     //inline definitions
 
     template<typename ElementType>
@@ -72,4 +119,45 @@ namespace re
         }
     }
 
+    template<typename ElementType, int Capacity>
+    inline bool RingBuffer<ElementType, Capacity>::push(const ElementType& element)
+    {
+        if (full())
+        {
+            return false;
+        }
+        m_elements[(m_next_in_line + m_count) % Capacity] = element;
+        ++m_count;
+        return true;
+    }
+
+    template<typename ElementType, int Capacity>
+    inline ElementType RingBuffer<ElementType, Capacity>::pop()
+    {
+        assert(m_count > 0);
+        auto element = std::move(m_elements[m_next_in_line]);
+        m_next_in_line = (m_next_in_line + 1) % Capacity;
+        --m_count;
+        return element;
+    }
+
+    template<typename ElementType>
+    inline void TripleBuffer<ElementType>::publish()
+    {
+        //swap the filled buffer for the shared one, release so the reader sees what was written
+        m_write = m_shared.exchange(m_write | c_published, std::memory_order_acq_rel) & ~c_published;
+    }
+
+    template<typename ElementType>
+    inline bool TripleBuffer<ElementType>::take_latest()
+    {
+        if (!(m_shared.load(std::memory_order_relaxed) & c_published))
+        {
+            return false;
+        }
+
+        //anything published since the check is taken too, the flag is in whatever comes back
+        m_read = m_shared.exchange(m_read, std::memory_order_acq_rel) & ~c_published;
+        return true;
+    }
 }
\ No newline at end of file
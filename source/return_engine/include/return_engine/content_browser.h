@@ -1,6 +1,10 @@
 #pragma once
 
+#include "editor_support/content_index.h"
+
 #include <filesystem>
+#include <memory>
+#include <string>
 #include <vector>
 
 /*UNFINISHED*/
@@ -17,28 +21,19 @@ namespace re
     public:
         ContentBrowser() { refresh_cache(); }
         void draw();
+        //keeps the index up to date between refreshes, with changes from a file watcher
+        void files_changed(const std::vector<std::filesystem::path>& paths);
 
     private:
-        struct Entry
-        {
-            std::filesystem::path relative_path;
-            std::vector<Entry> sub_entries;
-        };
-
-        void apply_filter(const Entry& entry);
         void apply_filter();
         void refresh_cache();
 
-        std::vector<Entry> m_entries;
-        const Entry* m_selected_entry = nullptr;
-        const Entry* m_current_directory = nullptr;
+        //built in the background, so refreshing doesn't stall a frame
+        std::unique_ptr<ContentIndex> m_index;
+        std::string m_selected_entry;
+        std::string m_current_directory;
 
-        struct SearchResult
-        {
-            const Entry* entry = nullptr;
-            float distance = 0.f;
-        };
         std::string m_search_filter;
-        std::vector<SearchResult> m_results;
+        std::vector<ContentResult> m_results;
     };
-}
\ No newline at end of file
+}
@@ -4,6 +4,7 @@
 
 #include "maths/maths.h"
 #include "file/file.h"
+#include "physics/colliders.h"
 
 #include <memory>
 
@@ -25,5 +26,7 @@ namespace re
         std::unique_ptr<VisualComponent> visual_component;
 
         maths::Matrix44 transform() const;
+        //world space bounds of the visual component, loose when rotated
+        phys::AABB3 bounds() const;
     };
 }
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+namespace re
+{
+    //splits variable frame times into fixed simulation steps
+    //  time not yet simulated carries over to the next frame in an accumulator
+    //  alpha is how far the frame is between the last two steps, for interpolating what's drawn
+    //  after a long stall at most max_steps are run and the rest of the time is dropped, rather than spiralling
+
+    class FixedTimestep
+    {
+    public:
+        FixedTimestep(double step_seconds = 1.0 / 60.0, int max_steps = 5);
+
+        //adds a frame's time and returns how many steps to simulate for it
+        int advance(double frame_seconds);
+
+        double step_seconds() const { return m_step_seconds; }
+        float alpha() const { return (float)(m_accumulator / m_step_seconds); }
+
+    private:
+        double m_step_seconds;
+        int m_max_steps;
+        double m_accumulator = 0.0;
+    };
+}
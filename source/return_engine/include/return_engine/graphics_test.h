@@ -1,8 +1,12 @@
 #pragma once
 
+#include "undo_history.h"
+
 #include "gfx/graphics_manager.h"
 #include "file/file.h"
 
+#include <deque>
+#include <filesystem>
 #include <string>
 #include <vector>
 
@@ -13,7 +17,7 @@ namespace gfx
 
 namespace re
 {
-    class VertexBuffer
+    class VertexBuffer : public Revisioned
     {
     public:
         static VertexBuffer create_triangle_buffer();
@@ -28,7 +32,9 @@ namespace re
         int vertex_size() const;
         int num_vertices() const { return m_num_vertices; }
 
-        DEFINE_SERIALIZATION_FUNCTIONS(m_name, m_components, m_data);
+        void write(file::FileOut& f) const { f.write_all(m_name, m_components, m_data); }
+        //the vertex count isn't saved, it follows from the data and the layout
+        void read(file::FileIn& f);
 
     private:
         bool edit_vertex(int i);
@@ -41,7 +47,7 @@ namespace re
         std::string m_error_log;
     };
 
-    class ElementBuffer
+    class ElementBuffer : public Revisioned
     {
     public:
         struct Triangle
@@ -65,7 +71,7 @@ namespace re
         std::string m_error_log;
     };
 
-    class VertexArrayObject
+    class VertexArrayObject : public Revisioned
     {
     public:
         static VertexArrayObject create_default_triangle_vao();
@@ -86,7 +92,7 @@ namespace re
     };
 
     template<gfx::ShaderType shader_type>
-    class Shader
+    class Shader : public Revisioned
     {
     public:
         static Shader create_triangle_shader() requires (shader_type == gfx::ShaderType::Vertex);
@@ -109,7 +115,7 @@ namespace re
     using VertexShader = Shader<gfx::ShaderType::Vertex>;
     using FragmentShader = Shader<gfx::ShaderType::Fragment>;
 
-    class ShaderProgram
+    class ShaderProgram : public Revisioned
     {
     public:
         static ShaderProgram create_default_triangle_program();
@@ -129,7 +135,7 @@ namespace re
         std::string m_error_log;
     };
 
-    class Texture
+    class Texture : public Revisioned
     {
     public:
         static Texture default_wall_texture();
@@ -170,20 +176,52 @@ namespace re
 
         Data& data() { return m_data; }
 
+        //oldest undo states are dropped once the history holds more than this
+        void set_undo_memory_budget(size_t bytes);
+
         void compile_assets(gfx::GraphicsManager& manager);
+        //collects errors from shaders and programs that were still compiling, call once per frame
+        void update_compile_status(const gfx::GraphicsManager& manager);
+
+        //rebuilds whatever was loaded from a file changed on disk, returns true if anything in the manager was replaced
+        //scenes must relink afterwards
+        bool reload_changed_file(const std::filesystem::path& path, gfx::GraphicsManager& manager);
 
     private:
+        //a state in the undo history, unchanged assets are shared with neighbouring states
+        struct Snapshot
+        {
+            AssetNodes<VertexBuffer> m_vertex_buffers;
+            AssetNodes<ElementBuffer> m_element_buffers;
+            AssetNodes<VertexShader> m_vertex_shaders;
+            AssetNodes<FragmentShader> m_fragment_shaders;
+            AssetNodes<ShaderProgram> m_shader_programs;
+            AssetNodes<VertexArrayObject> m_vertex_array_objects;
+            AssetNodes<Texture> m_textures;
+        };
+
+        void load_state(const std::filesystem::path& path);
+        void save_state(const std::filesystem::path& path);
+        void remember_state_path(const std::filesystem::path& path);
+
         void snapshot();
         bool undo();
         bool redo();
+        void release_snapshot(Snapshot&);
+        void enforce_undo_memory_budget();
 
         bool m_deferred_update = true;
+        bool m_compile_pending = false;
         Data m_data;
 
-        constexpr static int undo_stack_size = 32;
-        Data m_undo_stack[undo_stack_size];
-        int m_undo_length = 0;
-        int m_redo_length = 0;
-        int m_undo_current = 0;
+        //last state file loaded or saved, and its write time so our own saves aren't reloaded
+        std::filesystem::path m_state_path;
+        std::filesystem::file_time_type m_state_write_time;
+
+        constexpr static size_t default_undo_memory_budget = 64 * 1024 * 1024;
+        std::deque<Snapshot> m_undo_history;
+        int m_undo_current = -1;
+        size_t m_undo_memory = 0;
+        size_t m_undo_memory_budget = default_undo_memory_budget;
     };
 }
\ No newline at end of file
@@ -1,9 +1,20 @@
 #pragma once
 
+#include "containers.h"
+
 #include "maths/vector2.h"
 
+#include <bitset>
+#include <cstdint>
+
 struct GLFWwindow;
 
+namespace file
+{
+    class FileOut;
+    class FileIn;
+}
+
 namespace re
 {
     enum class Key
@@ -58,23 +69,104 @@ namespace re
         Count
     };
 
+    enum class InputEventType : uint8_t
+    {
+        KeyDown,
+        KeyUp,
+        MouseDown,
+        MouseUp,
+        CursorMove,
+    };
+
+    //one change of input as it happened, time in seconds on the glfw clock
+    struct InputEvent
+    {
+        InputEventType type;
+        int code = 0; //the Key or MouseButton for button events
+        maths::Vector2 cursor_pos = {0.f, 0.f}; //for CursorMove
+        double time = 0.0;
+    };
+
+    //everything that happened to input over a frame
+    //  plain data, so it can be copied to the simulation and read there without touching glfw
+    //  a press and release within one frame shows as both pressed and released though never down
+    class InputSnapshot
+    {
+    public:
+        bool down(Key key) const { return m_keys_down[(int)key]; }
+        bool pressed(Key key) const { return m_keys_pressed[(int)key]; }
+        bool released(Key key) const { return m_keys_released[(int)key]; }
+
+        bool down(MouseButton button) const { return m_buttons_down[(int)button]; }
+        bool pressed(MouseButton button) const { return m_buttons_pressed[(int)button]; }
+        bool released(MouseButton button) const { return m_buttons_released[(int)button]; }
+
+        maths::Vector2 mouse_pos() const { return m_cursor_pos; }
+        maths::Vector2 mouse_delta() const { return m_cursor_delta; }
+
+        //adds a later snapshot on, for when frames pass without anything consuming them
+        void merge(const InputSnapshot& later);
+        //forgets the edges and movement once they've been acted on, keeping what's held down
+        void clear_edges();
+        void apply(const InputEvent&);
+        //what imgui has taken reads as nothing happening
+        void clear_keys();
+        void clear_mouse_buttons();
+
+        void write(file::FileOut&) const;
+        void read(file::FileIn&);
+
+    private:
+        std::bitset<(int)Key::Count> m_keys_down;
+        std::bitset<(int)Key::Count> m_keys_pressed;
+        std::bitset<(int)Key::Count> m_keys_released;
+        std::bitset<(int)MouseButton::Count> m_buttons_down;
+        std::bitset<(int)MouseButton::Count> m_buttons_pressed;
+        std::bitset<(int)MouseButton::Count> m_buttons_released;
+        maths::Vector2 m_cursor_pos = {0.f, 0.f};
+        maths::Vector2 m_cursor_delta = {0.f, 0.f};
+    };
+
+    //glfw callbacks queue timestamped events, update turns those queued since the last update into the frame's snapshot
+    //  queries answer from the snapshot, so a press shorter than a frame still shows as pressed
+    //  without a window nothing is installed and events only come from push_event, to drive it headless
     class InputManager
     {
     public:
-        InputManager(GLFWwindow& window) : m_window(&window){}
+        InputManager() = default;
+        //installs glfw callbacks that forward to any already installed, imgui's included
+        InputManager(GLFWwindow& window);
+        ~InputManager();
+        InputManager(const InputManager&) = delete;
+        InputManager& operator=(const InputManager&) = delete;
 
+        void push_event(const InputEvent&);
         void update();
-        bool get_key(Key) const;
-        bool get_mouse_button(MouseButton) const;
+        const InputSnapshot& snapshot() const { return m_snapshot; }
+        //stands in for this frame's snapshot, to play back a recording
+        void replay(const InputSnapshot& snapshot) { m_snapshot = snapshot; }
+
+        bool get_key(Key key) const { return m_snapshot.down(key); }
+        bool get_mouse_button(MouseButton button) const { return m_snapshot.down(button); }
 
-        maths::Vector2 mouse_delta() const;
-        maths::Vector2 mouse_pos() const;
+        maths::Vector2 mouse_delta() const { return m_snapshot.mouse_delta(); }
+        maths::Vector2 mouse_pos() const { return m_snapshot.mouse_pos(); }
 
     private:
-        GLFWwindow* m_window;
-        bool m_key_input_consumed_by_imgui = false;
-        bool m_mouse_input_consumed_by_imgui = false;
-        maths::Vector2 m_cursor_pos = { 0.f,0.f };
-        maths::Vector2 m_cursor_delta = { 0.f,0.f };
+        static constexpr int c_event_capacity = 256;
+
+        static void key_callback(GLFWwindow*, int key, int scancode, int action, int mods);
+        static void mouse_button_callback(GLFWwindow*, int button, int action, int mods);
+        static void cursor_pos_callback(GLFWwindow*, double x, double y);
+
+        GLFWwindow* m_window = nullptr;
+        RingBuffer<InputEvent, c_event_capacity> m_events;
+        //the events applied so far, published as m_snapshot on update
+        InputSnapshot m_pending;
+        InputSnapshot m_snapshot;
+
+        void (*m_previous_key_callback)(GLFWwindow*, int, int, int, int) = nullptr;
+        void (*m_previous_mouse_button_callback)(GLFWwindow*, int, int, int) = nullptr;
+        void (*m_previous_cursor_pos_callback)(GLFWwindow*, double, double) = nullptr;
     };
-}
\ No newline at end of file
+}
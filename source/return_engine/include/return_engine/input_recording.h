@@ -0,0 +1,64 @@
+#pragma once
+
+#include "input_manager.h"
+
+#include "file/file.h"
+
+#include <filesystem>
+#include <vector>
+
+namespace re
+{
+    //what a frame was driven by, the sim gets the same steps from the same dt
+    struct RecordedFrame
+    {
+        DEFINE_SERIALIZATION_FUNCTIONS(dt, input);
+
+        float dt = 0.f;
+        InputSnapshot input;
+    };
+
+    //writes each frame's dt and input as it goes, so a crash still leaves everything up to it
+    class InputRecorder
+    {
+    public:
+        InputRecorder(const std::filesystem::path&);
+
+        bool valid() const { return m_file.valid(); }
+        void record(float dt, const InputSnapshot&);
+        int frame_count() const { return m_frame_count; }
+
+    private:
+        file::FileOut m_file;
+        int m_frame_count = 0;
+    };
+
+    //reads a whole recording up front, playing it back shouldn't wait on the disk mid frame
+    class InputPlayback
+    {
+    public:
+        InputPlayback(const std::filesystem::path&);
+
+        //false if the file was missing or isn't a recording
+        bool valid() const { return m_valid; }
+        //the next frame, or nullptr once the recording has run out
+        const RecordedFrame* next();
+        int frame_count() const { return (int)m_frames.size(); }
+
+    private:
+        std::vector<RecordedFrame> m_frames;
+        int m_next = 0;
+        bool m_valid = false;
+    };
+
+    struct FrameTimeSummary
+    {
+        int count = 0;
+        float min = 0.f;
+        float average = 0.f;
+        float p99 = 0.f;
+    };
+
+    //seconds per frame, reordered in place to find the percentile
+    FrameTimeSummary summarize_frame_times(std::vector<float>& frame_seconds);
+}
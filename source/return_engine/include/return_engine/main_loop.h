@@ -7,6 +7,14 @@ namespace re
         const char* window_name        = "Return Engine";
         int         init_window_width  = 700;
         int         init_window_height = 700;
+
+        //scene loaded once assets are first compiled
+        const char* scene_path         = nullptr;
+        //records each frame's input and dt, or plays a recording back with its dt in place of the real one
+        //  a replay exits when the recording runs out, printing frame times, for repeatable profiling runs
+        //  only the scene's own input is recorded, editor ui interaction isn't
+        const char* record_input_path  = nullptr;
+        const char* replay_input_path  = nullptr;
     };
 
     int main_loop(const EngineConfig&);
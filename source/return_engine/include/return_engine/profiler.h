@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//hierarchical frame profiler
+//  PROFILE_SCOPE("name") times the rest of the enclosing block, scopes nest so each zone knows its depth
+//  zones are written by the timing thread into its own ring buffer without locking, the main thread gathers
+//  them into a frame in profiler_next_frame
+//  names must outlive the profiler, in practice string literals
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_SCOPE(name) ::re::ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+
+namespace re
+{
+    struct ProfileZone
+    {
+        const char* name;
+        int64_t start_ns;
+        int64_t end_ns;
+        int thread; //index into profiler_thread_names
+        int depth;
+    };
+
+    struct GpuProfileZone
+    {
+        const char* name;
+        double seconds;
+    };
+
+    struct ProfilerFrame
+    {
+        int64_t start_ns = 0;
+        int64_t end_ns = 0;
+        std::vector<ProfileZone> zones;
+        std::vector<GpuProfileZone> gpu_zones;
+
+        double seconds() const { return 1e-9 * (double)(end_ns - start_ns); }
+    };
+
+    class ProfileScope
+    {
+    public:
+        explicit ProfileScope(const char* name);
+        ~ProfileScope();
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        const char* m_name;
+        int64_t m_start_ns;
+    };
+
+    //steady clock time used for every zone
+    int64_t profiler_now_ns();
+
+    //names the calling thread in the timeline, otherwise threads are numbered in the order they first record a zone
+    void profiler_set_thread_name(const char* name);
+    std::vector<std::string> profiler_thread_names();
+
+    //main thread only
+    //closes the frame in progress, if any, and starts the next one
+    void profiler_next_frame();
+    //gpu timings arrive frames late and without a start time so are only listed by duration
+    void profiler_record_gpu_zone(const char* name, double seconds);
+
+    //completed frames, oldest first
+    const std::vector<ProfilerFrame>& profiler_history();
+
+    //frames are also kept here while capturing, up to a limit
+    void profiler_start_capture();
+    void profiler_stop_capture();
+    bool profiler_capturing();
+    const std::vector<ProfilerFrame>& profiler_capture();
+
+    //chrome trace event format, load in chrome://tracing or ui.perfetto.dev
+    std::string chrome_trace_json(const std::vector<ProfilerFrame>&, const std::vector<std::string>& thread_names);
+
+    void profiler_window();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "camera.h"
+
+#include "gfx/gfx_forward.h"
+#include "gfx/lights.h"
+#include "gfx/resource_slots.h"
+#include "maths/maths.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace gfx
+{
+    class GraphicsManager;
+}
+
+namespace re
+{
+    //everything needed to draw one frame of a scene, without referring back to the scene
+    //  filled on the simulation thread while the main thread draws the previous packet
+    //  resources are held by handle and only resolved when drawn, assets may be recompiled in between
+    class RenderPacket
+    {
+    public:
+        //instances sharing a program, vertex array and texture, drawn together
+        struct Batch
+        {
+            gfx::Handle<gfx::ShaderProgram> program;
+            gfx::Handle<gfx::VertexArray> vao;
+            gfx::Handle<gfx::Texture> texture;
+            int first;
+            int count;
+        };
+
+        struct DebugShape
+        {
+            enum class Type { Sphere, Cube };
+
+            Type type;
+            maths::Matrix44 transform;
+            maths::Vector3 size; //radius in x for spheres
+            maths::Vector3 colour;
+            int segments;
+        };
+
+        Camera camera;
+        float time = 0.f;
+        DirectionalLight light;
+        AmbientLight ambient;
+
+        void clear();
+
+        void add_instance(
+            gfx::Handle<gfx::ShaderProgram>,
+            gfx::Handle<gfx::VertexArray>,
+            gfx::Handle<gfx::Texture>,
+            const maths::Matrix44& transform);
+        void add_sphere(const maths::Matrix44& transform, float radius, maths::Vector3 colour, int segments);
+        void add_cube(const maths::Matrix44& transform, maths::Vector3 dimensions, maths::Vector3 colour);
+
+        //sorts instances into batches, call once everything is added
+        void finish();
+
+        const std::vector<Batch>& batches() const { return m_batches; }
+        const std::vector<maths::Matrix44>& transforms() const { return m_transforms; }
+        const std::vector<DebugShape>& debug_shapes() const { return m_debug_shapes; }
+
+    private:
+        struct InstanceKey
+        {
+            gfx::Handle<gfx::ShaderProgram> program;
+            gfx::Handle<gfx::VertexArray> vao;
+            gfx::Handle<gfx::Texture> texture;
+            int index; //into m_transforms as added
+        };
+
+        std::vector<InstanceKey> m_keys;
+        std::vector<maths::Matrix44> m_unsorted_transforms;
+
+        std::vector<Batch> m_batches;
+        std::vector<maths::Matrix44> m_transforms;
+        std::vector<DebugShape> m_debug_shapes;
+    };
+
+    //issues the gl calls for a finished packet, batches with a resource that no longer exists are skipped
+    void draw_render_packet(const RenderPacket&, const gfx::GraphicsManager&, gfx::BatchRenderer&);
+}
@@ -1,14 +1,22 @@
 #pragma once
 
 #include "camera.h"
+#include "containers.h"
 #include "entity.h"
+#include "fixed_timestep.h"
 #include "gfx/lights.h"
 #include "input_manager.h"
+#include "render_packet.h"
+#include "task_manager.h"
 
 #include "maths/maths.h"
 #include "gfx/batch_renderer.h"
+#include "gfx/gpu_timer.h"
 #include "gfx/graphics_manager.h"
+#include "physics/bvh.h"
 
+#include <cstdint>
+#include <filesystem>
 #include <vector>
 
 namespace re
@@ -19,10 +27,25 @@ namespace re
         DEFINE_SERIALIZATION_FUNCTIONS(m_entities, m_time, m_camera, m_light, m_ambient);
 
         Scene(const gfx::GraphicsManager&, const InputManager&);
-        void update_and_draw(float dt, float aspect_ratio);
+
+        //the simulation runs in fixed steps on a task while the main thread draws
+        //  begin_simulation reads input then queues the steps covering dt, followed by building a render packet
+        //  nothing may touch the scene until tasks.finish_tasks() has returned
+        //  draw submits the packet built by the previous simulation, so only the gl calls are left on the main thread
+        void begin_simulation(float dt, TaskManager& tasks);
+        void draw(float aspect_ratio);
 
         void editor_ui();
         void relink_assets();
+        //relink_assets once done adding, for scenes built in code
+        void add_entity(Entity entity) { m_entities.push_back(std::move(entity)); }
+        int entity_count() const { return (int)m_entities.size(); }
+        const Entity& entity(int index) const { return m_entities[index]; }
+
+        void save(const std::filesystem::path& path);
+        void load(const std::filesystem::path& path);
+        //reloads the scene if it was loaded from or saved to path, returns true if it was
+        bool reload_changed_file(const std::filesystem::path& path);
 
         const DirectionalLight& directional_light() const { return m_light; }
         const AmbientLight& ambient_light() const { return m_ambient; }
@@ -32,22 +55,67 @@ namespace re
         gfx::BatchRenderer& batch_renderer() { return m_batch_renderer; }
 
     private:
+        //what the simulation changes, kept from the step before last to interpolate between
+        struct SimState
+        {
+            maths::Vector3 camera_pos;
+            maths::Quaternion camera_orientation;
+            double time = 0.0;
+        };
+
+        //input is only readable on the main thread so is gathered for the simulation
+        struct SimInput
+        {
+            InputSnapshot input; //edges merged over frames until a step reads them
+            maths::Vector2 camera_rotation; //accumulated until a step applies it
+        };
+
+        void capture_input();
+        void simulate(int steps, float step_seconds);
+        void build_render_packet(float alpha);
+        SimState sim_state() const;
+        //forgets the previous state, after anything moves the camera outside the simulation
+        void reset_interpolation();
+        void remember_path(const std::filesystem::path& path);
+        //selects the entity under the cursor when the left button goes down over the viewport
+        void pick_entity();
+        void update_bvh();
+
         std::vector<Entity> m_entities;
         double m_time = 0.0;
         
         Camera m_camera;
 
+        FixedTimestep m_timestep;
+        SimState m_previous_state;
+        SimInput m_sim_input;
+        int m_sim_steps = 0;
+
+        //written by the simulation task, read by draw
+        TripleBuffer<RenderPacket> m_render_packets;
+
         DirectionalLight m_light;
         AmbientLight m_ambient;
 
-        Entity m_clipboard;
+        //entity bounds, rebuilt when entities are added or removed and refit otherwise
+        phys::BVH m_bvh;
+        std::vector<phys::AABB3> m_entity_bounds;
+        int m_selected = -1;
+
+        //the copied entity serialized, so pasting is the same as loading it
+        std::vector<uint8_t> m_clipboard;
         bool m_show_gizmos = true;
         float m_dt;
         float m_draw_time;
 
+        //last file loaded or saved, and its write time so our own saves aren't reloaded
+        std::filesystem::path m_path;
+        std::filesystem::file_time_type m_write_time;
+
         const gfx::GraphicsManager& m_gfx_manager;
         const InputManager& m_input_manager;
         gfx::BatchRenderer m_batch_renderer;
+        gfx::GpuTimer m_gpu_draw_timer;
     };
 
 
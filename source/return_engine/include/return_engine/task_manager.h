@@ -30,18 +30,28 @@ namespace re
 
         //add tasks
         void add_task(Task task);
+        //runs task(i) for i in [start, end). one range at a time, finish_tasks before adding another
         void add_tasks(IndexedTask task, int start, int end);
 
-        //execute tasks
+        //execute tasks on the calling thread until every added task has finished, including ones other threads are running
         void finish_tasks();
 
+        //add_tasks then help until just that range has finished, so unlike finish_tasks it can be called from inside a task
+        void run_tasks(IndexedTask task, int start, int end);
+
+        int thread_count() const { return (int)m_thread_pool.size(); }
+
     private:
-        void task_thread_loop();
-        bool execute_tasks();
+        void task_thread_loop(int index);
+        bool execute_tasks(bool indexed_only = false);
 
         //thread pool
         std::vector<std::thread> m_thread_pool;
-        bool m_running = false;
+        std::atomic<bool> m_running = false;
+
+        //tasks added but not yet finished, all of them and just the indexed range
+        std::atomic<int> m_unfinished = 0;
+        std::atomic<int> m_indexed_unfinished = 0;
 
         //tasks - need a list of tasks which can store any number, where threads can take a bunch at a time
         //  circular buffer might make the most sense 
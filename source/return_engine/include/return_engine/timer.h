@@ -9,16 +9,16 @@ namespace re
     public:
         Timer()
         {
-            m_start = std::chrono::system_clock::now();
+            m_start = std::chrono::steady_clock::now();
         }
 
         float age_seconds()
         {
             using namespace std::chrono;
-            return 1e-9f * duration_cast<nanoseconds>(system_clock::now() - m_start).count();
+            return 1e-9f * duration_cast<nanoseconds>(steady_clock::now() - m_start).count();
         }
 
     private:
-        std::chrono::system_clock::time_point m_start;
+        std::chrono::steady_clock::time_point m_start;
     };
 }
\ No newline at end of file
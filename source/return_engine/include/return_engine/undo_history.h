@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace re
+{
+    //building blocks for an undo history that shares unchanged assets between states instead of copying them
+    //  assets are given a new revision whenever they're edited, two assets with the same revision hold the same data
+    //  each history state holds an immutable node per asset, a node is only created when an asset's revision changes
+    //  so recording a state costs the size of what changed, plus a pointer per asset
+
+    class Revisioned
+    {
+    public:
+        uint64_t revision() const { return m_revision; }
+        void new_revision();
+
+    private:
+        uint64_t m_revision = 0; //0 until first edited or recorded
+    };
+
+    template<typename AssetT>
+    using AssetNode = std::shared_ptr<const AssetT>;
+    template<typename AssetT>
+    using AssetNodes = std::vector<AssetNode<AssetT>>;
+
+    //fills nodes with the state of assets, reusing nodes from the previous state for anything unchanged
+    //returns the memory newly held, measured with memory_size(const AssetT&) which must be findable by adl
+    template<typename AssetT>
+    size_t record_assets(std::vector<AssetT>& assets, const AssetNodes<AssetT>& previous, AssetNodes<AssetT>& nodes);
+
+    //brings assets back to a recorded state, only copying assets whose revision differs
+    template<typename AssetT>
+    void restore_assets(const AssetNodes<AssetT>& nodes, std::vector<AssetT>& assets);
+
+    //drops nodes, returns the memory freed. nodes still shared with other states aren't freed
+    template<typename AssetT>
+    size_t release_assets(AssetNodes<AssetT>& nodes);
+
+    //inline definitions
+
+    template<typename AssetT>
+    size_t record_assets(std::vector<AssetT>& assets, const AssetNodes<AssetT>& previous, AssetNodes<AssetT>& nodes)
+    {
+        size_t new_memory = 0;
+        nodes.clear();
+        nodes.reserve(assets.size());
+
+        for (int i = 0; i < (int)assets.size(); ++i)
+        {
+            auto& asset = assets[i];
+            if (asset.revision() == 0)
+            {
+                asset.new_revision();
+            }
+
+            //assets usually stay where they were, only search the whole list if this one moved or changed
+            const AssetNode<AssetT>* shared = nullptr;
+            if (i < (int)previous.size() && previous[i]->revision() == asset.revision())
+            {
+                shared = &previous[i];
+            }
+            else
+            {
+                auto found = std::find_if(previous.begin(), previous.end(), [&asset](auto& node) { return node->revision() == asset.revision(); });
+                if (found != previous.end())
+                {
+                    shared = &*found;
+                }
+            }
+
+            if (shared)
+            {
+                nodes.push_back(*shared);
+            }
+            else
+            {
+                nodes.push_back(std::make_shared<const AssetT>(asset));
+                new_memory += memory_size(asset);
+            }
+        }
+
+        return new_memory;
+    }
+
+    template<typename AssetT>
+    void restore_assets(const AssetNodes<AssetT>& nodes, std::vector<AssetT>& assets)
+    {
+        assets.resize(nodes.size());
+        for (int i = 0; i < (int)nodes.size(); ++i)
+        {
+            if (assets[i].revision() != nodes[i]->revision())
+            {
+                assets[i] = *nodes[i];
+            }
+        }
+    }
+
+    template<typename AssetT>
+    size_t release_assets(AssetNodes<AssetT>& nodes)
+    {
+        size_t freed_memory = 0;
+        for (auto& node : nodes)
+        {
+            if (node.use_count() == 1)
+            {
+                freed_memory += memory_size(*node);
+            }
+        }
+        nodes.clear();
+
+        return freed_memory;
+    }
+}
@@ -1,15 +1,18 @@
 #pragma once
 
 #include "gfx/gfx_forward.h"
+#include "gfx/resource_slots.h"
 #include "maths/maths.h"
 
 #include "file/file.h"
+#include "physics/colliders.h"
 
 #include <memory>
 #include <string>
 
 namespace re
 {
+    class RenderPacket;
     class Scene;
 
     enum class VisualComponentType
@@ -27,13 +30,15 @@ namespace re
 
         virtual std::unique_ptr<VisualComponent> clone() const = 0;
 
+        //records what to draw, called from the simulation thread so mustn't touch gl
         virtual void draw(
             const maths::Matrix44& transform,
-            const maths::Matrix44& camera,
             const Scene&,
-            gfx::BatchRenderer&) const = 0;
+            RenderPacket&) const = 0;
         virtual void edit(const Scene&) = 0;
         virtual void relink(const Scene&) = 0;
+        //bounds before the entity's transform, for picking
+        virtual phys::AABB3 local_bounds() const = 0;
 
         virtual VisualComponentType type() const = 0;
     };
@@ -46,23 +51,29 @@ namespace re
     public:
         DEFINE_SERIALIZATION_FUNCTIONS(m_vao_name, m_program_name, m_texture_name);
 
+        VAOComponent() = default;
+        //resources are found by name on the next relink
+        VAOComponent(std::string vao_name, std::string program_name, std::string texture_name = {})
+            : m_vao_name(std::move(vao_name)), m_program_name(std::move(program_name)), m_texture_name(std::move(texture_name)) {}
+
         std::unique_ptr<VisualComponent> clone() const override { return std::make_unique<VAOComponent>(*this); }
 
         void draw(
             const maths::Matrix44& transform,
-            const maths::Matrix44& camera,
             const Scene&,
-            gfx::BatchRenderer&) const override;
+            RenderPacket&) const override;
         void edit(const Scene&) override;
         void relink(const Scene&) override;
+        //meshes don't keep their vertices on the cpu, so assume they fit in a cube reaching 1 either side of the origin
+        phys::AABB3 local_bounds() const override { return {-maths::Vector3::one(), maths::Vector3::one()}; }
         VisualComponentType type() const { return VisualComponentType::VAO; }
 
     private:
-        const gfx::VertexArray* m_vao = nullptr;
-        const gfx::ShaderProgram* m_program = nullptr;
-        const gfx::Texture* m_texture = nullptr;
+        gfx::Handle<gfx::VertexArray> m_vao;
+        gfx::Handle<gfx::ShaderProgram> m_program;
+        gfx::Handle<gfx::Texture> m_texture;
 
-        //needed by editor and for relinking
+        //saved with the component, looked up again when the handles no longer resolve
         std::string m_vao_name;
         std::string m_program_name;
         std::string m_texture_name;
@@ -73,15 +84,19 @@ namespace re
     public:
         DEFINE_SERIALIZATION_FUNCTIONS(m_radius, m_colour, m_num_segments);
 
+        SphereComponent() = default;
+        SphereComponent(float radius, maths::Vector3 colour, int num_segments = 20)
+            : m_radius(radius), m_colour(colour), m_num_segments(num_segments) {}
+
         std::unique_ptr<VisualComponent> clone() const override { return std::make_unique<SphereComponent>(*this); }
 
         void draw(
             const maths::Matrix44& transform,
-            const maths::Matrix44& camera,
             const Scene&,
-            gfx::BatchRenderer&) const override;
+            RenderPacket&) const override;
         void edit(const Scene&) override;
         void relink(const Scene&) override {}
+        phys::AABB3 local_bounds() const override { return {-maths::Vector3::one() * m_radius, maths::Vector3::one() * m_radius}; }
         VisualComponentType type() const { return VisualComponentType::Sphere; }
 
     private:
@@ -95,15 +110,19 @@ namespace re
     public:
         DEFINE_SERIALIZATION_FUNCTIONS(m_dimensions, m_colour);
 
+        CubeComponent() = default;
+        CubeComponent(maths::Vector3 dimensions, maths::Vector3 colour)
+            : m_dimensions(dimensions), m_colour(colour) {}
+
         std::unique_ptr<VisualComponent> clone() const override { return std::make_unique<CubeComponent>(*this); }
 
         void draw(
             const maths::Matrix44& transform,
-            const maths::Matrix44& camera,
             const Scene&,
-            gfx::BatchRenderer&) const override;
+            RenderPacket&) const override;
         void edit(const Scene&) override;
         void relink(const Scene&) override {}
+        phys::AABB3 local_bounds() const override { return {m_dimensions * -0.5f, m_dimensions * 0.5f}; }
         VisualComponentType type() const { return VisualComponentType::Cube; }
 
     private:
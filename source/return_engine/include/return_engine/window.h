@@ -12,7 +12,9 @@ namespace re
 
     //return true if execution should continue, false if should exit
     bool window_update();
+    //asks for the window to close, window_update returns false the next time round
+    void window_close();
 
     float window_aspect();
-    const InputManager& window_input_manager();
+    InputManager& window_input_manager();
 }
\ No newline at end of file
@@ -26,6 +26,20 @@ namespace re
             maths::Matrix44::from_translation(maths::Vector3(0.f, 0.f, -near));
     }
 
+    phys::Ray Camera::ray(maths::Vector2 ndc) const
+    {
+        //undoes the projection matrices by hand, the view space point on the near plane is scaled the same way
+        if (perspective)
+        {
+            const float tan_fov_2 = tanf(fov_y / 2.f);
+            const maths::Vector3 direction = {ndc.x * aspect * tan_fov_2, ndc.y * tan_fov_2, -1.f};
+            return {pos, (orientation * direction).normalized()};
+        }
+
+        const maths::Vector3 offset = {ndc.x * fov_y * aspect, ndc.y * fov_y, 0.f};
+        return {pos + orientation * offset, orientation * maths::Vector3(0.f, 0.f, -1.f)};
+    }
+
     maths::Vector3 OrbitCamera::pos() const
     {
         return center + orientation * maths::Vector3(0.f, 0.f, orbit_distance);
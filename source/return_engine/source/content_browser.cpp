@@ -1,14 +1,15 @@
 #include "content_browser.h"
 
-#include "editor_support/fuzzy_search.h"
 #include "file/file.h"
 
 #include "imgui/imgui.h"
 
-#include <algorithm>
-
 namespace re
 {
+    namespace
+    {
+        constexpr int c_max_results = 200;
+    }
 
     void ContentBrowser::draw()
     {
@@ -19,6 +20,11 @@ namespace re
         //double click action
     }
 
+    void ContentBrowser::files_changed(const std::vector<std::filesystem::path>& paths)
+    {
+        m_index->update(paths);
+    }
+
     void ContentBrowser::apply_filter()
     {
         m_results.clear();
@@ -27,34 +33,18 @@ namespace re
             return;
         }
 
-        for(auto& entry : m_entries)
-        {
-            apply_filter(entry);
-        }
-
-        std::sort(m_results.begin(), m_results.end(), [](auto& lhs, auto& rhs){ return lhs.distance < rhs.distance;});
-    }
-
-    void ContentBrowser::apply_filter(const Entry& entry)
-    {
-        m_results.push_back({&entry, adjusted_levenshtein_distance(entry.relative_path.string().c_str(), m_search_filter.c_str())});
-        for(auto& sub_entry : entry.sub_entries)
-        {
-            apply_filter(sub_entry);
-        }
+        //already ranked, and only the best are scored
+        ContentQuery query;
+        query.term = m_search_filter;
+        query.max_results = c_max_results;
+        m_results = m_index->search(query);
     }
 
     void ContentBrowser::refresh_cache()
     {
         m_results.clear();
-        m_entries.clear();
-
-        for(auto iter : std::filesystem::directory_iterator(file::get_data_path("")))
-        {
-            //todo: push back entries with relative path, and if directory then recursively push sub entries
-        }
-
+        m_index = std::make_unique<ContentIndex>(file::get_data_path(""));
         apply_filter();
     }
 
-}
\ No newline at end of file
+}
@@ -9,4 +9,27 @@ namespace re
             maths::Matrix44::from_orientation(orientation) *
             maths::Matrix44::from_scale(scale);
     }
+
+    phys::AABB3 Entity::bounds() const
+    {
+        if (!visual_component)
+        {
+            return {pos, pos};
+        }
+
+        //bounds of the transformed corners
+        const auto local = visual_component->local_bounds();
+        const auto matrix = transform();
+        phys::AABB3 result = {maths::Vector3::one() * INFINITY, maths::Vector3::one() * -INFINITY};
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            const maths::Vector3 point = {
+                corner & 1 ? local.max.x : local.min.x,
+                corner & 2 ? local.max.y : local.min.y,
+                corner & 4 ? local.max.z : local.min.z};
+            const auto world = matrix * point;
+            result = phys::merge(result, {world, world});
+        }
+        return result;
+    }
 }
\ No newline at end of file
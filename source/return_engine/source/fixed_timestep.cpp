@@ -0,0 +1,26 @@
+#include "fixed_timestep.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace re
+{
+    FixedTimestep::FixedTimestep(double step_seconds, int max_steps)
+        : m_step_seconds(step_seconds)
+        , m_max_steps(max_steps)
+    {
+        assert(step_seconds > 0.0 && max_steps > 0);
+    }
+
+    int FixedTimestep::advance(double frame_seconds)
+    {
+        m_accumulator += std::max(frame_seconds, 0.0);
+
+        const double steps = std::floor(m_accumulator / m_step_seconds);
+        m_accumulator = std::max(m_accumulator - steps * m_step_seconds, 0.0);
+
+        //drop the time we can't catch up on, the remainder is kept so alpha stays continuous
+        return (int)std::min(steps, (double)m_max_steps);
+    }
+}
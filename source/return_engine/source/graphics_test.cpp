@@ -128,6 +128,13 @@ namespace re
         return gfx::vertex_size(m_components.data(), (int)m_components.size());
     }
 
+    void VertexBuffer::read(file::FileIn& f)
+    {
+        f.read_all(m_name, m_components, m_data);
+        const int size = vertex_size();
+        m_num_vertices = size > 0 ? (int)m_data.size() / size : 0;
+    }
+
     //ElementBuffer =================================================================
 
     static bool edit(const char* label, ElementBuffer::Triangle& vt)
@@ -315,13 +322,65 @@ namespace re
 
     //GraphicsTestEditor ============================================================
 
-    static bool edit(const char*, VertexBuffer& vb)       { return vb.edit(); }
-    static bool edit(const char*, ElementBuffer& eb)      { return eb.edit(); }
+    //edited assets get a new revision so the undo history records them
+    template<typename AssetT>
+    static bool edit_asset(AssetT& asset)
+    {
+        if (!asset.edit())
+        {
+            return false;
+        }
+        asset.new_revision();
+        return true;
+    }
+
+    static bool edit(const char*, VertexBuffer& vb)       { return edit_asset(vb); }
+    static bool edit(const char*, ElementBuffer& eb)      { return edit_asset(eb); }
     template<gfx::ShaderType shader_type>
-    static bool edit(const char*, Shader<shader_type>& s) { return s.edit(); }
-    static bool edit(const char*, ShaderProgram& sp)      { return sp.edit(); }
-    static bool edit(const char*, VertexArrayObject& vao) { return vao.edit(); }
-    static bool edit(const char*, Texture& texture)       { return texture.edit(); }
+    static bool edit(const char*, Shader<shader_type>& s) { return edit_asset(s); }
+    static bool edit(const char*, ShaderProgram& sp)      { return edit_asset(sp); }
+    static bool edit(const char*, VertexArrayObject& vao) { return edit_asset(vao); }
+    static bool edit(const char*, Texture& texture)       { return edit_asset(texture); }
+
+    //approximate memory held by a copy of each asset in the undo history
+    static size_t memory_size(const VertexBuffer& vb)
+    {
+        return sizeof(vb) + vb.name().size() + vb.components().size() * sizeof(gfx::BufferAttributeType) + vb.total_size();
+    }
+    static size_t memory_size(const ElementBuffer& eb)
+    {
+        return sizeof(eb) + eb.name().size() + eb.num_triangles() * sizeof(ElementBuffer::Triangle);
+    }
+    template<gfx::ShaderType shader_type>
+    static size_t memory_size(const Shader<shader_type>& s)
+    {
+        return sizeof(s) + s.name().size() + s.source().size();
+    }
+    static size_t memory_size(const ShaderProgram& sp)
+    {
+        return sizeof(sp) + sp.name().size() + sp.vertex_shader().size() + sp.fragment_shader().size();
+    }
+    static size_t memory_size(const VertexArrayObject& vao)
+    {
+        return sizeof(vao) + vao.name().size() + vao.vertex_buffer_name().size() + vao.element_buffer_name().size();
+    }
+    static size_t memory_size(const Texture& texture)
+    {
+        return sizeof(texture) + texture.name().size() + texture.texture_filename().size();
+    }
+
+    //calls f with each asset list in data, followed by the matching node list from each snapshot
+    template<typename FunctionT, typename ... SnapshotT>
+    static void for_each_asset_list(FunctionT&& f, GraphicsTestEditor::Data& data, SnapshotT&... snapshots)
+    {
+        f(data.m_vertex_buffers, snapshots.m_vertex_buffers...);
+        f(data.m_element_buffers, snapshots.m_element_buffers...);
+        f(data.m_vertex_shaders, snapshots.m_vertex_shaders...);
+        f(data.m_fragment_shaders, snapshots.m_fragment_shaders...);
+        f(data.m_shader_programs, snapshots.m_shader_programs...);
+        f(data.m_vertex_array_objects, snapshots.m_vertex_array_objects...);
+        f(data.m_textures, snapshots.m_textures...);
+    }
 
     GraphicsTestEditor::GraphicsTestEditor()
     {
@@ -357,18 +416,26 @@ namespace re
             {
                 if(saving)
                 {
-                    auto file = file::FileOut::from_absolute(update_dialog_result->result_path.string().c_str());
-                    m_data.write(file);
+                    save_state(update_dialog_result->result_path);
                 }
                 else
                 {
-                    auto file = file::FileIn::from_absolute(update_dialog_result->result_path.string().c_str());
-                    m_data.read(file);
+                    load_state(update_dialog_result->result_path);
                     changed = true;
                 }
             }
 
-            ImGui::Text("Undo frame: %d, Undo/Redo length:[%d, %d]", m_undo_current, m_undo_length, m_redo_length);
+            const int undo_length = m_undo_current;
+            const int redo_length = (int)m_undo_history.size() - 1 - m_undo_current;
+            ImGui::Text("Undo frame: %d, Undo/Redo length:[%d, %d]", m_undo_current, undo_length, redo_length);
+            int budget_mb = (int)(m_undo_memory_budget / (1024 * 1024));
+            ImGui::Text("Undo memory: %.2f MB", (double)m_undo_memory / (1024.0 * 1024.0));
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(100.f);
+            if (ImGui::DragInt("Budget (MB)", &budget_mb, 1.f, 1, 4096))
+            {
+                set_undo_memory_budget((size_t)budget_mb * 1024 * 1024);
+            }
             ImGui::Separator();
             if (imhelp::edit_list("Vertex Buffers", m_data.m_vertex_buffers))             changed = true;
             ImGui::Separator();
@@ -406,6 +473,24 @@ namespace re
         return changed;
     }
 
+    static std::unique_ptr<gfx::Texture> compile_texture(Texture& texture)
+    {
+        texture.error_log().clear();
+
+        if(texture.texture_filename().empty())
+        {
+            texture.error_log() = "Filename not specified.";
+            return nullptr;
+        }
+
+        gfx::Image texture_image(texture.texture_filename().c_str());
+        if(!texture_image.valid())
+        {
+            texture.error_log() = "Couldn't load the file.";
+        }
+        return std::make_unique<gfx::Texture>(texture_image);
+    }
+
     void GraphicsTestEditor::compile_assets(gfx::GraphicsManager &manager)
     {
         manager.clear();
@@ -464,7 +549,7 @@ namespace re
             vert_shader.error_log().clear();
             manager.add(
                 vert_shader.name().c_str(), 
-                std::make_unique<gfx::VertexShader>(vert_shader.source().c_str(), &vert_shader.error_log())
+                std::make_unique<gfx::VertexShader>(vert_shader.source().c_str())
             );
         }
         gfx::report_gl_error();
@@ -474,7 +559,7 @@ namespace re
             frag_shader.error_log().clear();
             manager.add(
                 frag_shader.name().c_str(),
-                std::make_unique<gfx::FragmentShader>(frag_shader.source().c_str(), &frag_shader.error_log())
+                std::make_unique<gfx::FragmentShader>(frag_shader.source().c_str())
             );
         }
         gfx::report_gl_error();
@@ -495,50 +580,167 @@ namespace re
                 continue;
             }
 
-            manager.add(shader_program.name().c_str(), std::make_unique<gfx::ShaderProgram>(*vshader, *fshader, &shader_program.error_log()));
+            manager.add(shader_program.name().c_str(), std::make_unique<gfx::ShaderProgram>(*vshader, *fshader));
 
         }
         gfx::report_gl_error();
 
         for(auto& texture : textures)
         {
-            texture.error_log().clear();
+            if(auto compiled = compile_texture(texture))
+            {
+                manager.add(texture.name().c_str(), std::move(compiled));
+            }
+        }
+        gfx::report_gl_error();
+
+        //anything that wasn't recompiled is gone, handles to it mustn't resolve to whatever takes its slot
+        manager.remove_empty();
+
+        //shaders and programs finish compiling in the background, errors are collected as they complete
+        m_compile_pending = true;
+    }
+
+    void GraphicsTestEditor::update_compile_status(const gfx::GraphicsManager& manager)
+    {
+        if (!m_compile_pending)
+        {
+            return;
+        }
+
+        bool pending = false;
+        auto poll = [&pending](auto* object, std::string& error_log)
+        {
+            if (object && object->poll(&error_log) == gfx::CompileStatus::Pending)
+            {
+                pending = true;
+            }
+        };
+
+        for (auto& vert_shader : m_data.m_vertex_shaders)
+        {
+            poll(manager.vertex_shader(vert_shader.name().c_str()), vert_shader.error_log());
+        }
+        for (auto& frag_shader : m_data.m_fragment_shaders)
+        {
+            poll(manager.fragment_shader(frag_shader.name().c_str()), frag_shader.error_log());
+        }
+        for (auto& shader_program : m_data.m_shader_programs)
+        {
+            poll(manager.shader_program(shader_program.name().c_str()), shader_program.error_log());
+        }
+
+        m_compile_pending = pending;
+    }
+
+    bool GraphicsTestEditor::reload_changed_file(const std::filesystem::path& path, gfx::GraphicsManager& manager)
+    {
+        auto changed_path = path.lexically_normal();
 
-            if(texture.texture_filename().empty())
+        //the editor state holds every asset, reloading it rebuilds everything
+        if (!m_state_path.empty() && changed_path == m_state_path)
+        {
+            std::error_code error;
+            auto write_time = std::filesystem::last_write_time(changed_path, error);
+            if (error || write_time == m_state_write_time)
+            {
+                //deleted, or our own save
+                return false;
+            }
+
+            load_state(changed_path);
+            snapshot();
+            compile_assets(manager);
+            return true;
+        }
+
+        //otherwise only the assets loaded from that file are rebuilt, swapped into their existing slots
+        bool reloaded = false;
+        for (auto& texture : m_data.m_textures)
+        {
+            if (texture.texture_filename().empty() || file::get_data_path(texture.texture_filename().c_str()).lexically_normal() != changed_path)
             {
-                texture.error_log() = "Filename not specified.";
                 continue;
             }
 
-            gfx::Image texture_image(texture.texture_filename().c_str());
-            if(!texture_image.valid())
+            if (auto compiled = compile_texture(texture))
             {
-                texture.error_log() = "Couldn't load the file.";
+                manager.replace(texture.name().c_str(), std::move(compiled));
+                reloaded = true;
             }
-            manager.add(texture.name().c_str(), std::make_unique<gfx::Texture>(texture_image));
         }
-        gfx::report_gl_error();
+        return reloaded;
+    }
+
+    void GraphicsTestEditor::load_state(const std::filesystem::path& path)
+    {
+        {
+            auto file = file::FileIn::from_absolute(path.string().c_str());
+            m_data.read(file);
+        }
+
+        //loading reads over existing assets, they can no longer be matched to the history
+        for_each_asset_list([](auto& assets)
+        {
+            for (auto& asset : assets)
+            {
+                asset.new_revision();
+            }
+        }, m_data);
+
+        remember_state_path(path);
+    }
+
+    void GraphicsTestEditor::save_state(const std::filesystem::path& path)
+    {
+        {
+            auto file = file::FileOut::from_absolute(path.string().c_str(), file::Compression::Blocks);
+            m_data.write(file);
+        }
+        remember_state_path(path);
+    }
+
+    void GraphicsTestEditor::remember_state_path(const std::filesystem::path& path)
+    {
+        std::error_code error;
+        m_state_path = path.lexically_normal();
+        m_state_write_time = std::filesystem::last_write_time(m_state_path, error);
+    }
+
+    void GraphicsTestEditor::set_undo_memory_budget(size_t bytes)
+    {
+        m_undo_memory_budget = bytes;
+        enforce_undo_memory_budget();
     }
 
     void GraphicsTestEditor::snapshot()
     {
-        m_undo_current += 1;
-        if (m_undo_current >= undo_stack_size) m_undo_current -= undo_stack_size;
-        m_undo_length += 1;
-        if (m_undo_length >= undo_stack_size) m_undo_length = undo_stack_size - 1;
-        m_redo_length = 0;
-        m_undo_stack[m_undo_current] = m_data;
+        //editing after an undo discards the states that could have been redone
+        while ((int)m_undo_history.size() > m_undo_current + 1)
+        {
+            release_snapshot(m_undo_history.back());
+            m_undo_history.pop_back();
+        }
+
+        static Snapshot empty;
+        auto& previous = m_undo_history.empty() ? empty : m_undo_history.back();
+        Snapshot next;
+        for_each_asset_list([this](auto& assets, auto& previous_nodes, auto& nodes)
+        {
+            m_undo_memory += record_assets(assets, previous_nodes, nodes);
+        }, m_data, previous, next);
+
+        m_undo_history.push_back(std::move(next));
+        m_undo_current = (int)m_undo_history.size() - 1;
+        enforce_undo_memory_budget();
     }
 
     bool GraphicsTestEditor::undo()
     {
-        if (m_undo_length > 0)
+        if (m_undo_current > 0)
         {
             m_undo_current -= 1;
-            if (m_undo_current < 0) m_undo_current += undo_stack_size;
-            m_undo_length -= 1;
-            m_redo_length += 1;
-            m_data = m_undo_stack[m_undo_current];
+            for_each_asset_list([](auto& assets, auto& nodes) { restore_assets(nodes, assets); }, m_data, m_undo_history[m_undo_current]);
             return true;
         }
         return false;
@@ -546,15 +748,28 @@ namespace re
 
     bool GraphicsTestEditor::redo()
     {
-        if (m_redo_length > 0)
+        if (m_undo_current + 1 < (int)m_undo_history.size())
         {
             m_undo_current += 1;
-            if (m_undo_current >= undo_stack_size) m_undo_current -= undo_stack_size;
-            m_undo_length += 1;
-            m_redo_length -= 1;
-            m_data = m_undo_stack[m_undo_current];
+            for_each_asset_list([](auto& assets, auto& nodes) { restore_assets(nodes, assets); }, m_data, m_undo_history[m_undo_current]);
             return true;
         }
         return false;
     }
+
+    void GraphicsTestEditor::release_snapshot(Snapshot& snapshot)
+    {
+        for_each_asset_list([this](auto&, auto& nodes) { m_undo_memory -= release_assets(nodes); }, m_data, snapshot);
+    }
+
+    void GraphicsTestEditor::enforce_undo_memory_budget()
+    {
+        //the current state is always kept, however large
+        while (m_undo_memory > m_undo_memory_budget && m_undo_current > 0)
+        {
+            release_snapshot(m_undo_history.front());
+            m_undo_history.pop_front();
+            m_undo_current -= 1;
+        }
+    }
 }
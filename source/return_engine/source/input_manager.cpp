@@ -1,8 +1,11 @@
 #include "input_manager.h"
 
+#include "file/file.h"
 #include "GLFW/glfw3.h"
 #include "imgui/imgui.h"
 
+#include <cassert>
+
 namespace re
 {
     int g_key_conversion[(int)Key::Count] = 
@@ -53,35 +56,214 @@ namespace re
         GLFW_MOUSE_BUTTON_3
     };
 
-    void InputManager::update()
+    namespace
+    {
+        //the manager glfw's callbacks feed, there's only ever the one window
+        InputManager* g_window_input = nullptr;
+    }
+
+    //Private functions
+
+    template<int Count>
+    static int from_glfw(const int (&conversion)[Count], int glfw_code)
+    {
+        for (int i = 0; i < Count; ++i)
+        {
+            if (conversion[i] == glfw_code)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    //InputSnapshot ====
+
+    void InputSnapshot::merge(const InputSnapshot& later)
+    {
+        m_keys_pressed |= later.m_keys_pressed;
+        m_keys_released |= later.m_keys_released;
+        m_keys_down = later.m_keys_down;
+        m_buttons_pressed |= later.m_buttons_pressed;
+        m_buttons_released |= later.m_buttons_released;
+        m_buttons_down = later.m_buttons_down;
+        m_cursor_delta += later.m_cursor_delta;
+        m_cursor_pos = later.m_cursor_pos;
+    }
+
+    void InputSnapshot::clear_edges()
+    {
+        m_keys_pressed.reset();
+        m_keys_released.reset();
+        m_buttons_pressed.reset();
+        m_buttons_released.reset();
+        m_cursor_delta = maths::Vector2::zero();
+    }
+
+    void InputSnapshot::apply(const InputEvent& event)
     {
-        m_key_input_consumed_by_imgui = ImGui::GetIO().WantCaptureKeyboard;
-        m_mouse_input_consumed_by_imgui = ImGui::GetIO().WantCaptureMouse;
+        switch (event.type)
+        {
+        case InputEventType::KeyDown:
+            m_keys_down[event.code] = true;
+            m_keys_pressed[event.code] = true;
+            break;
+        case InputEventType::KeyUp:
+            m_keys_down[event.code] = false;
+            m_keys_released[event.code] = true;
+            break;
+        case InputEventType::MouseDown:
+            m_buttons_down[event.code] = true;
+            m_buttons_pressed[event.code] = true;
+            break;
+        case InputEventType::MouseUp:
+            m_buttons_down[event.code] = false;
+            m_buttons_released[event.code] = true;
+            break;
+        case InputEventType::CursorMove:
+            m_cursor_delta += event.cursor_pos - m_cursor_pos;
+            m_cursor_pos = event.cursor_pos;
+            break;
+        }
+    }
+
+    void InputSnapshot::clear_keys()
+    {
+        m_keys_down.reset();
+        m_keys_pressed.reset();
+        m_keys_released.reset();
+    }
+
+    void InputSnapshot::clear_mouse_buttons()
+    {
+        m_buttons_down.reset();
+        m_buttons_pressed.reset();
+        m_buttons_released.reset();
+    }
+
+    void InputSnapshot::write(file::FileOut& file) const
+    {
+        //button states packed in a byte each, the keys fit in a word each
+        static_assert((int)Key::Count <= 64 && (int)MouseButton::Count <= 8);
+        file << (uint64_t)m_keys_down.to_ullong() << (uint64_t)m_keys_pressed.to_ullong() << (uint64_t)m_keys_released.to_ullong();
+        file << (uint8_t)m_buttons_down.to_ulong() << (uint8_t)m_buttons_pressed.to_ulong() << (uint8_t)m_buttons_released.to_ulong();
+        file << m_cursor_pos << m_cursor_delta;
+    }
+
+    void InputSnapshot::read(file::FileIn& file)
+    {
+        uint64_t keys[3];
+        uint8_t buttons[3];
+        file >> keys[0] >> keys[1] >> keys[2] >> buttons[0] >> buttons[1] >> buttons[2];
+        file >> m_cursor_pos >> m_cursor_delta;
+        m_keys_down = keys[0];
+        m_keys_pressed = keys[1];
+        m_keys_released = keys[2];
+        m_buttons_down = buttons[0];
+        m_buttons_pressed = buttons[1];
+        m_buttons_released = buttons[2];
+    }
+
+    //InputManager ====
+
+    InputManager::InputManager(GLFWwindow& window)
+        : m_window(&window)
+    {
+        assert(!g_window_input);
+        g_window_input = this;
 
         double x, y;
         glfwGetCursorPos(m_window, &x, &y);
-        maths::Vector2 new_cursor_pos = { (float)x, (float)y };
-        m_cursor_delta = new_cursor_pos - m_cursor_pos;
-        m_cursor_pos = new_cursor_pos;
+        //start from where the cursor is so the first move isn't a jump from the corner
+        m_pending.apply({InputEventType::CursorMove, 0, {(float)x, (float)y}, glfwGetTime()});
+        m_pending.clear_edges();
+
+        m_previous_key_callback = glfwSetKeyCallback(m_window, key_callback);
+        m_previous_mouse_button_callback = glfwSetMouseButtonCallback(m_window, mouse_button_callback);
+        m_previous_cursor_pos_callback = glfwSetCursorPosCallback(m_window, cursor_pos_callback);
     }
 
-    bool InputManager::get_key(Key key) const
+    InputManager::~InputManager()
     {
-        return !m_key_input_consumed_by_imgui && glfwGetKey(m_window, g_key_conversion[(int)key]);
+        if (m_window)
+        {
+            glfwSetKeyCallback(m_window, m_previous_key_callback);
+            glfwSetMouseButtonCallback(m_window, m_previous_mouse_button_callback);
+            glfwSetCursorPosCallback(m_window, m_previous_cursor_pos_callback);
+            g_window_input = nullptr;
+        }
     }
 
-    bool InputManager::get_mouse_button(MouseButton button) const
+    void InputManager::push_event(const InputEvent& event)
     {
-        return !m_mouse_input_consumed_by_imgui && glfwGetMouseButton(m_window, g_mouse_conversion[(int)button]);
+        if (m_events.full())
+        {
+            //applying the oldest early loses nothing, it only lands in this frame's snapshot sooner
+            m_pending.apply(m_events.pop());
+        }
+        m_events.push(event);
     }
 
-    maths::Vector2 InputManager::mouse_delta() const
+    void InputManager::update()
+    {
+        while (!m_events.empty())
+        {
+            m_pending.apply(m_events.pop());
+        }
+        m_snapshot = m_pending;
+        m_pending.clear_edges();
+
+        //headless there's no imgui to hand input to
+        if (ImGui::GetCurrentContext())
+        {
+            if (ImGui::GetIO().WantCaptureKeyboard)
+            {
+                m_snapshot.clear_keys();
+            }
+            if (ImGui::GetIO().WantCaptureMouse)
+            {
+                m_snapshot.clear_mouse_buttons();
+            }
+        }
+    }
+
+    void InputManager::key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
     {
-        return m_cursor_delta;
+        auto* input = g_window_input;
+        if (input->m_previous_key_callback)
+        {
+            input->m_previous_key_callback(window, key, scancode, action, mods);
+        }
+
+        const int code = from_glfw(g_key_conversion, key);
+        if (code >= 0 && action != GLFW_REPEAT)
+        {
+            input->push_event({action == GLFW_PRESS ? InputEventType::KeyDown : InputEventType::KeyUp, code, {0.f, 0.f}, glfwGetTime()});
+        }
+    }
+
+    void InputManager::mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
+    {
+        auto* input = g_window_input;
+        if (input->m_previous_mouse_button_callback)
+        {
+            input->m_previous_mouse_button_callback(window, button, action, mods);
+        }
+
+        const int code = from_glfw(g_mouse_conversion, button);
+        if (code >= 0)
+        {
+            input->push_event({action == GLFW_PRESS ? InputEventType::MouseDown : InputEventType::MouseUp, code, {0.f, 0.f}, glfwGetTime()});
+        }
     }
 
-    maths::Vector2 InputManager::mouse_pos() const
+    void InputManager::cursor_pos_callback(GLFWwindow* window, double x, double y)
     {
-        return m_cursor_pos;
+        auto* input = g_window_input;
+        if (input->m_previous_cursor_pos_callback)
+        {
+            input->m_previous_cursor_pos_callback(window, x, y);
+        }
+        input->push_event({InputEventType::CursorMove, 0, {(float)x, (float)y}, glfwGetTime()});
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,86 @@
+#include "input_recording.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace re
+{
+    namespace
+    {
+        //"RINP", then a version bumped whenever InputSnapshot's layout on disk changes
+        constexpr uint32_t c_magic = 0x504e4952;
+        constexpr uint32_t c_version = 1;
+    }
+
+    //InputRecorder ====
+
+    InputRecorder::InputRecorder(const std::filesystem::path& path)
+        : m_file(file::FileOut::from_absolute(path.string().c_str()))
+    {
+        m_file << c_magic << c_version;
+    }
+
+    void InputRecorder::record(float dt, const InputSnapshot& input)
+    {
+        m_file << RecordedFrame{dt, input};
+        ++m_frame_count;
+    }
+
+    //InputPlayback ====
+
+    InputPlayback::InputPlayback(const std::filesystem::path& path)
+    {
+        auto file = file::FileIn::from_absolute(path.string().c_str());
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        file >> magic >> version;
+        if (magic != c_magic || version != c_version)
+        {
+            return;
+        }
+
+        //frames run to the end of the file, a partly written last one is dropped
+        while (true)
+        {
+            RecordedFrame frame;
+            file >> frame;
+            if (!file.valid())
+            {
+                break;
+            }
+            m_frames.push_back(frame);
+        }
+        m_valid = true;
+    }
+
+    const RecordedFrame* InputPlayback::next()
+    {
+        if (m_next >= (int)m_frames.size())
+        {
+            return nullptr;
+        }
+        return &m_frames[m_next++];
+    }
+
+    //Public functions
+
+    FrameTimeSummary summarize_frame_times(std::vector<float>& frame_seconds)
+    {
+        FrameTimeSummary summary;
+        summary.count = (int)frame_seconds.size();
+        if (frame_seconds.empty())
+        {
+            return summary;
+        }
+
+        summary.min = *std::min_element(frame_seconds.begin(), frame_seconds.end());
+        summary.average = std::accumulate(frame_seconds.begin(), frame_seconds.end(), 0.0) / frame_seconds.size();
+
+        //nearest rank, the slowest frame that 99% of frames are no slower than
+        const size_t rank = (size_t)std::ceil(0.99 * frame_seconds.size()) - 1;
+        std::nth_element(frame_seconds.begin(), frame_seconds.begin() + rank, frame_seconds.end());
+        summary.p99 = frame_seconds[rank];
+        return summary;
+    }
+}
@@ -1,13 +1,20 @@
 #include "main_loop.h"
 
 #include "graphics_test.h"
+#include "input_recording.h"
+#include "profiler.h"
 #include "window.h"
 
+#include "editor_support/file_dialog.h"
+#include "file/file_watcher.h"
 #include "gfx/graphics_manager.h"
+#include "gfx/program_cache.h"
 #include "scene.h"
+#include "task_manager.h"
 
 #include <chrono>
 #include <iostream>
+#include <memory>
 
 namespace re
 {
@@ -25,28 +32,136 @@ namespace re
         gfx::GraphicsManager manager;
         re::GraphicsTestEditor editor;
         re::Scene scene(manager, window_input_manager());
+        //the scene simulates on this thread while the main thread draws
+        TaskManager task_manager(1);
         
-        auto time = std::chrono::system_clock::now();
+        file::FileWatcher data_watcher(file::get_data_path(""));
+        std::cout << "Watching data folder for changes" << (data_watcher.polling() ? " by polling" : "") << ".\n";
+
+        std::unique_ptr<InputRecorder> recorder;
+        std::unique_ptr<InputPlayback> playback;
+        std::vector<float> frame_seconds;
+        if (config.replay_input_path)
+        {
+            playback = std::make_unique<InputPlayback>(config.replay_input_path);
+            if (!playback->valid())
+            {
+                std::cout << "Couldn't read input recording " << config.replay_input_path << ".\n";
+                playback.reset();
+            }
+        }
+        else if (config.record_input_path)
+        {
+            recorder = std::make_unique<InputRecorder>(config.record_input_path);
+            if (!recorder->valid())
+            {
+                std::cout << "Couldn't write input recording " << config.record_input_path << ".\n";
+                recorder.reset();
+            }
+        }
+
+        bool first_compile = true;
+        bool first_frame = true;
+        auto time = std::chrono::steady_clock::now();
+        profiler_set_thread_name("Main");
+        profiler_next_frame();
         while (window_update())
         {
             //calculate dt
             float dt = 0.f;
             {
-                auto new_time = std::chrono::system_clock::now();
+                auto new_time = std::chrono::steady_clock::now();
                 dt = 1e-9f * std::chrono::duration_cast<std::chrono::nanoseconds>(new_time - time).count();
                 time = new_time;
             }
 
+            //a replay drives the frame from the recording, with the measured time only reported
+            if (playback)
+            {
+                //the first dt is startup, not a frame
+                if (!first_frame)
+                {
+                    frame_seconds.push_back(dt);
+                }
+                auto* frame = playback->next();
+                if (!frame)
+                {
+                    const auto summary = summarize_frame_times(frame_seconds);
+                    std::cout << "Replayed " << playback->frame_count() << " frames. Frame time min " << 1e3f * summary.min
+                        << " ms, average " << 1e3f * summary.average << " ms, p99 " << 1e3f * summary.p99 << " ms.\n";
+                    playback.reset();
+                    window_close();
+                }
+                else
+                {
+                    window_input_manager().replay(frame->input);
+                    dt = frame->dt;
+                }
+            }
+            else if (recorder)
+            {
+                recorder->record(dt, window_input_manager().snapshot());
+            }
+            first_frame = false;
+
+            //last frame's simulation has to finish before anything reads or changes the scene
+            {
+                PROFILE_SCOPE("Wait for simulation");
+                task_manager.finish_tasks();
+            }
+
+            //pick up files changed on disk, between frames so nothing refers to the objects being replaced
+            {
+                PROFILE_SCOPE("Hot reload");
+                bool reloaded = false;
+                const auto changes = data_watcher.take_changes();
+                for (auto& path : changes)
+                {
+                    if (editor.reload_changed_file(path, manager)) reloaded = true;
+                    if (scene.reload_changed_file(path))           reloaded = true;
+                }
+                file_dialog_files_changed(changes);
+                if (reloaded)
+                {
+                    scene.relink_assets();
+                }
+            }
+
             //update editor
-            if(editor.edit())
             {
-                editor.compile_assets(manager);
-                scene.relink_assets();
+                PROFILE_SCOPE("Editor");
+                if(editor.edit())
+                {
+                    editor.compile_assets(manager);
+                    scene.relink_assets();
+
+                    if(first_compile)
+                    {
+                        if (config.scene_path)
+                        {
+                            scene.load(config.scene_path);
+                        }
+                        auto& cache_stats = gfx::program_cache_stats();
+                        std::cout << "Shader program cache: " << cache_stats.hits << " hits, " << cache_stats.misses << " misses.\n";
+                        first_compile = false;
+                    }
+                }
+                editor.update_compile_status(manager);
+                scene.editor_ui();
+                profiler_window();
             }
-            scene.editor_ui();
 
-            //update scene
-            scene.update_and_draw(dt, window_aspect());
+            //simulate the scene for this frame on the task thread while drawing the state as of the last one
+            scene.begin_simulation(dt, task_manager);
+            scene.draw(window_aspect());
+
+            profiler_next_frame();
+        }
+
+        task_manager.finish_tasks();
+        if (recorder)
+        {
+            std::cout << "Recorded " << recorder->frame_count() << " frames of input to " << config.record_input_path << ".\n";
         }
 
         //shutdown window
@@ -0,0 +1,491 @@
+#include "profiler.h"
+
+#include "file/file.h"
+
+#include "imgui/imgui.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+namespace re
+{
+    namespace
+    {
+        struct ZoneRecord
+        {
+            const char* name;
+            int64_t start_ns;
+            int64_t end_ns;
+            int depth;
+        };
+
+        //single producer ring buffer, only the owning thread writes records and only the main thread reads them
+        //if the owner laps the reader the oldest records are lost rather than blocking the owner
+        struct ThreadBuffer
+        {
+            static constexpr uint64_t c_capacity = 1 << 14;
+
+            ZoneRecord records[c_capacity];
+            std::atomic<uint64_t> written = 0;
+            uint64_t read = 0;  //reader only
+            int depth = 0;      //owner only
+            int index = 0;
+            std::string name;   //guarded by g_thread_mutex
+        };
+
+        constexpr int c_history_frames = 240;
+        constexpr int c_max_capture_frames = 3600;
+
+        std::mutex g_thread_mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> g_threads;
+        thread_local ThreadBuffer* t_thread_buffer = nullptr;
+
+        //main thread state
+        bool g_frame_started = false;
+        ProfilerFrame g_frame;
+        std::vector<ProfilerFrame> g_history;
+        std::vector<ProfilerFrame> g_capture;
+        bool g_capturing = false;
+        bool g_paused = false;
+    }
+
+    static ThreadBuffer& thread_buffer()
+    {
+        if (!t_thread_buffer)
+        {
+            std::lock_guard lock(g_thread_mutex);
+            auto buffer = std::make_unique<ThreadBuffer>();
+            buffer->index = (int)g_threads.size();
+            buffer->name = "Thread " + std::to_string(buffer->index);
+            t_thread_buffer = buffer.get();
+            g_threads.push_back(std::move(buffer));
+        }
+        return *t_thread_buffer;
+    }
+
+    //gathers every record written since the last call into the frame
+    static void collect_zones(ProfilerFrame& frame)
+    {
+        std::lock_guard lock(g_thread_mutex);
+        for (auto& buffer : g_threads)
+        {
+            const uint64_t capacity = ThreadBuffer::c_capacity;
+            const uint64_t written = buffer->written.load(std::memory_order_acquire);
+            const uint64_t first = std::max(buffer->read, written > capacity ? written - capacity : 0);
+
+            auto thread_start = frame.zones.size();
+            for (uint64_t i = first; i < written; ++i)
+            {
+                auto& record = buffer->records[i % capacity];
+                frame.zones.push_back({record.name, record.start_ns, record.end_ns, buffer->index, record.depth});
+            }
+
+            //the owner may have overwritten the oldest slots while they were being copied, drop those
+            const uint64_t written_after = buffer->written.load(std::memory_order_acquire);
+            const uint64_t first_valid = written_after > capacity ? written_after - capacity : 0;
+            if (first_valid > first)
+            {
+                auto overwritten = (size_t)std::min(first_valid - first, written - first);
+                frame.zones.erase(frame.zones.begin() + thread_start, frame.zones.begin() + thread_start + overwritten);
+            }
+
+            buffer->read = written;
+        }
+    }
+
+    static void append_json_string(std::string& json, const char* s)
+    {
+        json += '"';
+        for (; *s; ++s)
+        {
+            switch (*s)
+            {
+            case '"':  json += "\\\""; break;
+            case '\\': json += "\\\\"; break;
+            case '\n': json += "\\n"; break;
+            case '\t': json += "\\t"; break;
+            default:
+                if ((unsigned char)*s < 0x20)
+                {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned)*s);
+                    json += escaped;
+                }
+                else
+                {
+                    json += *s;
+                }
+            }
+        }
+        json += '"';
+    }
+
+    static void append_json_event(std::string& json, const char* name, const char* category, double start_us, double duration_us, int thread)
+    {
+        char numbers[128];
+        json += json.back() == '[' ? "\n" : ",\n";
+        json += "{\"name\":";
+        append_json_string(json, name);
+        snprintf(numbers, sizeof(numbers), ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+            category, start_us, duration_us, thread);
+        json += numbers;
+    }
+
+    static void append_json_thread_name(std::string& json, const char* name, int thread)
+    {
+        json += json.back() == '[' ? "\n" : ",\n";
+        json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(thread) + ",\"args\":{\"name\":";
+        append_json_string(json, name);
+        json += "}}";
+    }
+
+    //ProfileScope ===============================================================
+
+    ProfileScope::ProfileScope(const char* name)
+        : m_name(name)
+    {
+        ++thread_buffer().depth;
+        m_start_ns = profiler_now_ns();
+    }
+
+    ProfileScope::~ProfileScope()
+    {
+        const int64_t end_ns = profiler_now_ns();
+        auto& buffer = *t_thread_buffer;
+        const int depth = --buffer.depth;
+
+        const uint64_t index = buffer.written.load(std::memory_order_relaxed);
+        buffer.records[index % ThreadBuffer::c_capacity] = {m_name, m_start_ns, end_ns, depth};
+        buffer.written.store(index + 1, std::memory_order_release);
+    }
+
+    //Profiler ===================================================================
+
+    int64_t profiler_now_ns()
+    {
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    void profiler_set_thread_name(const char* name)
+    {
+        auto& buffer = thread_buffer();
+        std::lock_guard lock(g_thread_mutex);
+        buffer.name = name;
+    }
+
+    std::vector<std::string> profiler_thread_names()
+    {
+        std::lock_guard lock(g_thread_mutex);
+        std::vector<std::string> names;
+        names.reserve(g_threads.size());
+        for (auto& buffer : g_threads)
+        {
+            names.push_back(buffer->name);
+        }
+        return names;
+    }
+
+    void profiler_next_frame()
+    {
+        const int64_t now = profiler_now_ns();
+        if (g_frame_started)
+        {
+            g_frame.end_ns = now;
+            collect_zones(g_frame);
+
+            if (g_capturing && (int)g_capture.size() < c_max_capture_frames)
+            {
+                g_capture.push_back(g_frame);
+            }
+
+            if (!g_paused)
+            {
+                //reuse the oldest frame's allocations once the history is full
+                if ((int)g_history.size() < c_history_frames)
+                {
+                    g_history.emplace_back();
+                }
+                else
+                {
+                    std::rotate(g_history.begin(), g_history.begin() + 1, g_history.end());
+                }
+                std::swap(g_history.back(), g_frame);
+            }
+        }
+
+        g_frame_started = true;
+        g_frame.start_ns = now;
+        g_frame.end_ns = now;
+        g_frame.zones.clear();
+        g_frame.gpu_zones.clear();
+    }
+
+    void profiler_record_gpu_zone(const char* name, double seconds)
+    {
+        g_frame.gpu_zones.push_back({name, seconds});
+    }
+
+    const std::vector<ProfilerFrame>& profiler_history()
+    {
+        return g_history;
+    }
+
+    void profiler_start_capture()
+    {
+        g_capture.clear();
+        g_capturing = true;
+    }
+
+    void profiler_stop_capture()
+    {
+        g_capturing = false;
+    }
+
+    bool profiler_capturing()
+    {
+        return g_capturing;
+    }
+
+    const std::vector<ProfilerFrame>& profiler_capture()
+    {
+        return g_capture;
+    }
+
+    std::string chrome_trace_json(const std::vector<ProfilerFrame>& frames, const std::vector<std::string>& thread_names)
+    {
+        //cpu threads keep their own ids, frames and gpu zones get a track each after them
+        const int frame_thread = (int)thread_names.size();
+        const int gpu_thread = frame_thread + 1;
+
+        std::string json = "{\"traceEvents\":[";
+        for (int i = 0; i < (int)thread_names.size(); ++i)
+        {
+            append_json_thread_name(json, thread_names[i].c_str(), i);
+        }
+        append_json_thread_name(json, "Frames", frame_thread);
+        append_json_thread_name(json, "GPU", gpu_thread);
+
+        if (!frames.empty())
+        {
+            const int64_t origin_ns = frames.front().start_ns;
+            auto to_us = [](int64_t ns) { return 1e-3 * (double)ns; };
+
+            for (auto& frame : frames)
+            {
+                append_json_event(json, "Frame", "frame", to_us(frame.start_ns - origin_ns), to_us(frame.end_ns - frame.start_ns), frame_thread);
+                for (auto& zone : frame.zones)
+                {
+                    append_json_event(json, zone.name, "cpu", to_us(zone.start_ns - origin_ns), to_us(zone.end_ns - zone.start_ns), zone.thread);
+                }
+
+                //gpu zones have no start time, lay them end to end from the start of the frame
+                double gpu_us = to_us(frame.start_ns - origin_ns);
+                for (auto& zone : frame.gpu_zones)
+                {
+                    append_json_event(json, zone.name, "gpu", gpu_us, 1e6 * zone.seconds, gpu_thread);
+                    gpu_us += 1e6 * zone.seconds;
+                }
+            }
+        }
+        json += "\n]}\n";
+
+        return json;
+    }
+
+    //Profiler window ============================================================
+
+    static ImU32 zone_colour(const char* name)
+    {
+        uint32_t hash = 2166136261u;
+        for (; *name; ++name)
+        {
+            hash = (hash ^ (uint8_t)*name) * 16777619u;
+        }
+        return ImColor::HSV((float)(hash % 360) / 360.f, 0.5f, 0.75f);
+    }
+
+    //bar per frame in the history, returns the frame clicked on if any
+    static int frame_graph(const std::vector<ProfilerFrame>& history, int selected)
+    {
+        const float width = ImGui::GetContentRegionAvail().x;
+        const float height = 60.f;
+        const double max_seconds = 1.0 / 20.0;
+        const float bar_width = width / (float)c_history_frames;
+
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        ImGui::InvisibleButton("FrameGraph", ImVec2(width, height));
+        auto* draw_list = ImGui::GetWindowDrawList();
+        draw_list->AddRectFilled(origin, ImVec2(origin.x + width, origin.y + height), IM_COL32(30, 30, 30, 255));
+
+        for (int i = 0; i < (int)history.size(); ++i)
+        {
+            const double seconds = history[i].seconds();
+            const float bar_height = height * (float)std::min(seconds / max_seconds, 1.0);
+            ImU32 colour =
+                i == selected ? IM_COL32(255, 255, 255, 255) :
+                seconds <= 1.0 / 60.0 ? IM_COL32(80, 200, 80, 255) :
+                seconds <= 1.0 / 30.0 ? IM_COL32(220, 200, 60, 255) :
+                IM_COL32(220, 70, 60, 255);
+
+            const float x = origin.x + bar_width * (float)i;
+            draw_list->AddRectFilled(ImVec2(x, origin.y + height - bar_height), ImVec2(x + std::max(bar_width - 1.f, 1.f), origin.y + height), colour);
+        }
+
+        if (ImGui::IsItemHovered())
+        {
+            const int hovered = (int)((ImGui::GetIO().MousePos.x - origin.x) / bar_width);
+            if (hovered >= 0 && hovered < (int)history.size())
+            {
+                ImGui::SetTooltip("%.3f ms", 1e3 * history[hovered].seconds());
+                if (ImGui::IsItemClicked())
+                {
+                    return hovered;
+                }
+            }
+        }
+        return -1;
+    }
+
+    //flame graph per thread, time runs left to right across the frame and nested zones stack downwards
+    static void frame_timeline(const ProfilerFrame& frame, const std::vector<std::string>& thread_names, float zoom)
+    {
+        const float width = ImGui::GetContentRegionAvail().x * zoom;
+        const float row_height = ImGui::GetTextLineHeightWithSpacing();
+        const double duration_ns = (double)std::max<int64_t>(frame.end_ns - frame.start_ns, 1);
+        auto* draw_list = ImGui::GetWindowDrawList();
+        const ImVec2 mouse = ImGui::GetIO().MousePos;
+
+        for (int thread = 0; thread < (int)thread_names.size(); ++thread)
+        {
+            int max_depth = -1;
+            for (auto& zone : frame.zones)
+            {
+                if (zone.thread == thread)
+                {
+                    max_depth = std::max(max_depth, zone.depth);
+                }
+            }
+            if (max_depth < 0)
+            {
+                continue;
+            }
+
+            ImGui::TextUnformatted(thread_names[thread].c_str());
+            const ImVec2 origin = ImGui::GetCursorScreenPos();
+            ImGui::Dummy(ImVec2(width, row_height * (float)(max_depth + 1)));
+
+            for (auto& zone : frame.zones)
+            {
+                if (zone.thread != thread)
+                {
+                    continue;
+                }
+
+                //zones from other threads can straddle frame boundaries, clamp them to the frame
+                auto to_x = [&](int64_t ns)
+                {
+                    return origin.x + width * (float)std::clamp((double)(ns - frame.start_ns) / duration_ns, 0.0, 1.0);
+                };
+                const ImVec2 min(to_x(zone.start_ns), origin.y + row_height * (float)zone.depth);
+                const ImVec2 max(std::max(to_x(zone.end_ns), min.x + 1.f), min.y + row_height - 1.f);
+
+                draw_list->AddRectFilled(min, max, zone_colour(zone.name));
+                if (max.x - min.x > ImGui::CalcTextSize(zone.name).x)
+                {
+                    draw_list->AddText(ImVec2(min.x + 2.f, min.y), IM_COL32(0, 0, 0, 255), zone.name);
+                }
+
+                if (ImGui::IsWindowHovered() && mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y)
+                {
+                    ImGui::SetTooltip("%s\n%.3f ms", zone.name, 1e-6 * (double)(zone.end_ns - zone.start_ns));
+                }
+            }
+        }
+
+        if (!frame.gpu_zones.empty())
+        {
+            ImGui::SeparatorText("GPU");
+            for (auto& zone : frame.gpu_zones)
+            {
+                ImGui::Text("%s: %.3f ms", zone.name, 1e3 * zone.seconds);
+            }
+        }
+    }
+
+    void profiler_window()
+    {
+        static int selected = -1;
+        static float zoom = 1.f;
+        static std::string export_message;
+
+        if (ImGui::Begin("Profiler"))
+        {
+            if (ImGui::Checkbox("Pause", &g_paused) && !g_paused)
+            {
+                selected = -1;
+            }
+            ImGui::SameLine();
+            if (g_capturing)
+            {
+                if (ImGui::Button("Stop capture"))
+                {
+                    profiler_stop_capture();
+                }
+            }
+            else if (ImGui::Button("Start capture"))
+            {
+                profiler_start_capture();
+            }
+            ImGui::SameLine();
+            ImGui::BeginDisabled(g_capture.empty());
+            if (ImGui::Button("Export capture"))
+            {
+                auto path = file::get_appdata_path("profiler/capture.json");
+                auto json = chrome_trace_json(g_capture, profiler_thread_names());
+                export_message = file::write_string_to_appdata("profiler/capture.json", json.c_str())
+                    ? "Exported to " + path.string()
+                    : "Failed to write " + path.string();
+            }
+            ImGui::EndDisabled();
+            ImGui::Text("Captured frames: %d", (int)g_capture.size());
+            if (!export_message.empty())
+            {
+                ImGui::TextUnformatted(export_message.c_str());
+            }
+
+            auto& history = g_history;
+            if (!history.empty())
+            {
+                //follow the latest frame unless paused and a frame has been picked
+                if (!g_paused || selected >= (int)history.size())
+                {
+                    selected = -1;
+                }
+                const int shown = selected >= 0 ? selected : (int)history.size() - 1;
+
+                int clicked = frame_graph(history, shown);
+                if (clicked >= 0)
+                {
+                    g_paused = true;
+                    selected = clicked;
+                }
+
+                ImGui::Text("Frame: %.3f ms", 1e3 * history[shown].seconds());
+                ImGui::SliderFloat("Zoom", &zoom, 1.f, 50.f, "%.1f", ImGuiSliderFlags_Logarithmic);
+
+                if (ImGui::BeginChild("Timeline", ImVec2(0.f, 0.f), ImGuiChildFlags_Borders, ImGuiWindowFlags_HorizontalScrollbar))
+                {
+                    frame_timeline(history[shown], profiler_thread_names(), zoom);
+                }
+                ImGui::EndChild();
+            }
+        }
+        ImGui::End();
+    }
+}
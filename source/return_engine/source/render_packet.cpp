@@ -0,0 +1,105 @@
+#include "render_packet.h"
+
+#include "gfx/batch_renderer.h"
+#include "gfx/debug_lines.h"
+#include "gfx/graphics_manager.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace re
+{
+    //RenderPacket =====================================================================
+
+    void RenderPacket::clear()
+    {
+        //keeps capacity, packets are refilled every frame
+        m_keys.clear();
+        m_unsorted_transforms.clear();
+        m_batches.clear();
+        m_transforms.clear();
+        m_debug_shapes.clear();
+    }
+
+    void RenderPacket::add_instance(
+        gfx::Handle<gfx::ShaderProgram> program,
+        gfx::Handle<gfx::VertexArray> vao,
+        gfx::Handle<gfx::Texture> texture,
+        const maths::Matrix44& transform)
+    {
+        m_keys.push_back({program, vao, texture, (int)m_unsorted_transforms.size()});
+        m_unsorted_transforms.push_back(transform);
+    }
+
+    void RenderPacket::add_sphere(const maths::Matrix44& transform, float radius, maths::Vector3 colour, int segments)
+    {
+        m_debug_shapes.push_back({DebugShape::Type::Sphere, transform, {radius, radius, radius}, colour, segments});
+    }
+
+    void RenderPacket::add_cube(const maths::Matrix44& transform, maths::Vector3 dimensions, maths::Vector3 colour)
+    {
+        m_debug_shapes.push_back({DebugShape::Type::Cube, transform, dimensions, colour, 0});
+    }
+
+    void RenderPacket::finish()
+    {
+        auto key_tuple = [](const InstanceKey& key)
+        {
+            return std::make_tuple(key.program.index, key.program.generation, key.vao.index, key.vao.generation, key.texture.index, key.texture.generation);
+        };
+
+        //stable so instances within a batch keep the order they were added in
+        std::stable_sort(m_keys.begin(), m_keys.end(), [&](const InstanceKey& lhs, const InstanceKey& rhs)
+        {
+            return key_tuple(lhs) < key_tuple(rhs);
+        });
+
+        m_transforms.resize(m_keys.size());
+        for (int i = 0; i < (int)m_keys.size(); ++i)
+        {
+            auto& key = m_keys[i];
+            m_transforms[i] = m_unsorted_transforms[key.index];
+
+            if (m_batches.empty() || key_tuple(m_keys[m_batches.back().first]) != key_tuple(key))
+            {
+                m_batches.push_back({key.program, key.vao, key.texture, i, 0});
+            }
+            ++m_batches.back().count;
+        }
+    }
+
+    //Drawing =====================================================================
+
+    void draw_render_packet(const RenderPacket& packet, const gfx::GraphicsManager& manager, gfx::BatchRenderer& renderer)
+    {
+        const auto view = packet.camera.view_matrix();
+        const auto projection = packet.camera.projection_matrix();
+        const auto camera = projection * view;
+
+        for (auto& shape : packet.debug_shapes())
+        {
+            switch (shape.type)
+            {
+            case RenderPacket::DebugShape::Type::Sphere:
+                gfx::draw_sphere(shape.transform, shape.size.x, camera, shape.colour, shape.segments);
+                break;
+            case RenderPacket::DebugShape::Type::Cube:
+                gfx::draw_cube(shape.transform, shape.size, camera, shape.colour);
+                break;
+            }
+        }
+
+        for (auto& batch : packet.batches())
+        {
+            auto* program = manager.get(batch.program);
+            auto* vao = manager.get(batch.vao);
+            if (program == nullptr || vao == nullptr)
+            {
+                continue;
+            }
+            renderer.add_instances(*vao, *program, manager.get(batch.texture), packet.transforms().data() + batch.first, batch.count);
+        }
+        renderer.draw_all(packet.time, view, projection);
+        renderer.clear();
+    }
+}
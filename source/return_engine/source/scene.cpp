@@ -1,11 +1,13 @@
 #include "scene.h"
 
+#include "profiler.h"
 #include "timer.h"
 
 #include "maths/maths.h"
 
 #include "editor_support/imgui_helpers.h"
 #include "gfx/debug_lines.h"
+#include "gfx/render_state.h"
 #include "editor_support/file_dialog.h"
 
 #include "imgui/imgui.h"
@@ -13,50 +15,132 @@
 
 #include "GLFW/glfw3.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace re
 {
     Scene::Scene(const gfx::GraphicsManager& gfx_manager, const InputManager& input_manager)
         : m_gfx_manager(gfx_manager)
         , m_input_manager(input_manager)
-    {}
+    {
+        reset_interpolation();
+    }
 
-    void Scene::update_and_draw(float dt, float aspect_ratio)
+    void Scene::begin_simulation(float dt, TaskManager& tasks)
     {
         m_dt = dt;
-        maths::Vector3 camera_movement = maths::Vector3::zero();
-        if(m_input_manager.get_key(Key::W)) camera_movement.z -= dt * 5.f;
-        if(m_input_manager.get_key(Key::A)) camera_movement.x -= dt * 5.f;
-        if(m_input_manager.get_key(Key::S)) camera_movement.z += dt * 5.f;
-        if(m_input_manager.get_key(Key::D)) camera_movement.x += dt * 5.f;
-        if(m_input_manager.get_key(Key::E)) camera_movement.y += dt * 5.f;
-        if(m_input_manager.get_key(Key::C)) camera_movement.y -= dt * 5.f;
-        m_camera.pos += m_camera.orientation * camera_movement;
-
-        if (m_input_manager.get_mouse_button(MouseButton::Right))
-        {
-            auto rotation = m_input_manager.mouse_delta() * 0.002f;
-            m_camera.euler += {-rotation.y, -rotation.x};
-            m_camera.orientation = maths::Quaternion::from_euler(m_camera.euler);
-        }
-
-        m_camera.aspect = aspect_ratio;
-        m_time += dt;
-        auto cam_projection = m_camera.projection_matrix();
-        auto camera = cam_projection * m_camera.view_matrix();
-        
-        gfx::report_gl_error();
-        
-        Timer draw_timer;
 
-        for(auto& entity : m_entities)
+        //the packet the last simulation built is drawn this frame, the buffer it frees is filled by the next
+        m_render_packets.take_latest();
+
+        capture_input();
+        m_sim_steps = m_timestep.advance(dt);
+        tasks.add_task([this, steps = m_sim_steps, step_seconds = (float)m_timestep.step_seconds(), alpha = m_timestep.alpha()]()
         {
-            entity.visual_component->draw(entity.transform(), camera, *this, m_batch_renderer);
+            simulate(steps, step_seconds);
+            build_render_packet(alpha);
+        });
+    }
+
+    void Scene::capture_input()
+    {
+        //frames can pass without a step, keep their edges until one reads them
+        const auto& input = m_input_manager.snapshot();
+        m_sim_input.input.merge(input);
+        if (input.down(MouseButton::Right))
+        {
+            m_sim_input.camera_rotation += input.mouse_delta() * 0.002f;
         }
+    }
 
-        m_batch_renderer.draw_all((float)m_time, m_camera.view_matrix(), m_camera.projection_matrix());
-        m_batch_renderer.clear();
+    void Scene::simulate(int steps, float step_seconds)
+    {
+        PROFILE_SCOPE("Simulate");
+        for (int i = 0; i < steps; ++i)
+        {
+            m_previous_state = sim_state();
+
+            const auto& input = m_sim_input.input;
+            maths::Vector3 velocity = maths::Vector3::zero();
+            if (input.down(Key::W)) velocity.z -= 5.f;
+            if (input.down(Key::A)) velocity.x -= 5.f;
+            if (input.down(Key::S)) velocity.z += 5.f;
+            if (input.down(Key::D)) velocity.x += 5.f;
+            if (input.down(Key::E)) velocity.y += 5.f;
+            if (input.down(Key::C)) velocity.y -= 5.f;
+
+            auto& rotation = m_sim_input.camera_rotation;
+            if (rotation.x != 0.f || rotation.y != 0.f)
+            {
+                m_camera.euler += {-rotation.y, -rotation.x};
+                m_camera.orientation = maths::Quaternion::from_euler(m_camera.euler);
+                rotation = maths::Vector2::zero();
+            }
+            m_camera.pos += m_camera.orientation * (velocity * step_seconds);
+            m_time += step_seconds;
+            m_sim_input.input.clear_edges();
+        }
+    }
+
+    void Scene::build_render_packet(float alpha)
+    {
+        PROFILE_SCOPE("Build render packet");
+        auto& packet = m_render_packets.write_buffer();
+        packet.clear();
 
+        //draw between the last two steps, so the frame rate and step rate can differ without stutter
+        alpha = std::min(alpha, 1.f);
+        packet.camera = m_camera;
+        packet.camera.pos = maths::Vector3::interpolate(m_previous_state.camera_pos, m_camera.pos, alpha);
+        if (!(m_previous_state.camera_orientation == m_camera.orientation))
+        {
+            //slerp between equal orientations has no axis to rotate about
+            packet.camera.orientation = maths::Quaternion::slerp(m_previous_state.camera_orientation, m_camera.orientation, alpha);
+        }
+        packet.time = (float)std::lerp(m_previous_state.time, m_time, (double)alpha);
+        packet.light = m_light;
+        packet.ambient = m_ambient;
+
+        for (auto& entity : m_entities)
+        {
+            if (entity.visual_component)
+            {
+                entity.visual_component->draw(entity.transform(), *this, packet);
+            }
+        }
+        packet.finish();
+
+        m_render_packets.publish();
+    }
+
+    Scene::SimState Scene::sim_state() const
+    {
+        return {m_camera.pos, m_camera.orientation, m_time};
+    }
+
+    void Scene::reset_interpolation()
+    {
+        m_previous_state = sim_state();
+    }
+
+    void Scene::draw(float aspect_ratio)
+    {
+        PROFILE_SCOPE("Scene draw");
+        auto& packet = m_render_packets.read_buffer();
+        packet.camera.aspect = aspect_ratio;
+
+        gfx::report_gl_error();
+        
+        Timer draw_timer;
+        m_gpu_draw_timer.begin();
+        draw_render_packet(packet, m_gfx_manager, m_batch_renderer);
+        m_gpu_draw_timer.end();
         m_draw_time = draw_timer.age_seconds();
+        if(m_gpu_draw_timer.seconds() >= 0.0)
+        {
+            profiler_record_gpu_zone("Scene draw", m_gpu_draw_timer.seconds());
+        }
     }
 
     void Scene::editor_ui()
@@ -81,24 +165,29 @@ namespace re
             {
                 if (saving)
                 {
-                    auto file = file::FileOut::from_absolute(result->result_path.string().c_str());
-                    write(file);
+                    save(result->result_path);
                 }
                 else
                 {
-                    auto file = file::FileIn::from_absolute(result->result_path.string().c_str());
-                    read(file);
-                    relink_assets();
+                    load(result->result_path);
                 }
             }
 
             ImGui::Text("DT: %f", m_dt);
+            ImGui::Text("Sim steps: %d, alpha: %.2f", m_sim_steps, m_timestep.alpha());
             ImGui::Text("Draw time: %f", m_draw_time);
+            ImGui::Text("GPU draw time: %f", m_gpu_draw_timer.seconds());
+            auto& render_state = gfx::last_frame_render_state_counters();
+            ImGui::Text("GL binds issued/skipped: %d/%d", render_state.issued, render_state.skipped);
             ImGui::SeparatorText("Camera");
-            ImGui::DragFloat3("Pos", &m_camera.pos.x, 0.1f);
+            if (ImGui::DragFloat3("Pos", &m_camera.pos.x, 0.1f))
+            {
+                reset_interpolation();
+            }
             if (ImGui::DragFloat3("Rot", &m_camera.euler.x, 0.1f))
             {
                 m_camera.orientation = maths::Quaternion::from_euler(m_camera.euler);
+                reset_interpolation();
             }
             //ImGui::DragFloat("Orbit distance", &m_camera.orbit_distance, 0.1f);
             ImGui::DragFloat("fov_y", &m_camera.fov_y, 0.05f);
@@ -110,18 +199,43 @@ namespace re
             if (ImGui::Button("Paste"))
             {
                 Entity e;
-                e.pos = m_clipboard.pos;
-                e.orientation = m_clipboard.orientation;
-                e.scale = m_clipboard.scale;
-                if (m_clipboard.visual_component)
+                if (!m_clipboard.empty())
                 {
-                    e.visual_component = m_clipboard.visual_component->clone();
-                    e.visual_component->relink(*this);
+                    auto clipboard = file::FileIn::from_memory(m_clipboard);
+                    clipboard >> e;
+                    if (e.visual_component)
+                    {
+                        e.visual_component->relink(*this);
+                    }
                 }
                 m_entities.push_back(std::move(e));
             }
             ImGui::Checkbox("Show gizmos", &m_show_gizmos);
             ImGui::Text("Count: %d", (int)m_entities.size());
+            ImGui::Text("BVH nodes: %d, cost: %.1f", m_bvh.node_count(), m_bvh.cost());
+
+            if (m_selected >= 0 && m_selected < (int)m_entities.size())
+            {
+                auto& entity = m_entities[m_selected];
+                ImGui::Text("Selected: %d", m_selected);
+                ImGui::SameLine();
+                if (ImGui::Button("Deselect"))
+                {
+                    m_selected = -1;
+                }
+
+                auto transform = entity.transform();
+                if (m_show_gizmos && ImGuizmo::Manipulate(
+                    m_camera.view_matrix().values,
+                    m_camera.perspective_matrix().values,
+                    ImGuizmo::OPERATION::TRANSLATE | ImGuizmo::OPERATION::ROTATE,
+                    ImGuizmo::MODE::LOCAL,
+                    transform.values))
+                {
+                    entity.pos = transform.translation();
+                    entity.orientation = maths::Quaternion::from_euler(transform.euler());
+                }
+            }
 
             if (ImGui::CollapsingHeader("Entities"))
             {
@@ -140,19 +254,16 @@ namespace re
                     ImGui::SameLine();
                     if (ImGui::Button("Copy"))
                     {
-                        m_clipboard.pos = entity.pos;
-                        m_clipboard.orientation = entity.orientation;
-                        m_clipboard.scale = entity.scale;
-                        if (entity.visual_component)
-                        {
-                            m_clipboard.visual_component = entity.visual_component->clone();
-                        }
+                        m_clipboard.clear();
+                        auto clipboard = file::FileOut::to_memory(m_clipboard);
+                        clipboard << entity;
                     }
                     ImGui::DragFloat3("Pos", &entity.pos.x, 0.1f);
                     ImGui::DragFloat3("Scale", &entity.scale.x, 0.1f);
 
+                    //the selected entity's gizmo is already shown above
                     auto transform = entity.transform();
-                    if (m_show_gizmos && ImGuizmo::Manipulate(
+                    if (m_show_gizmos && i != m_selected && ImGuizmo::Manipulate(
                         m_camera.view_matrix().values,
                         m_camera.perspective_matrix().values,
                         ImGuizmo::OPERATION::TRANSLATE | ImGuizmo::OPERATION::ROTATE,
@@ -178,6 +289,14 @@ namespace re
                 if (to_remove != -1)
                 {
                     m_entities.erase(m_entities.begin() + to_remove);
+                    if (m_selected == to_remove)
+                    {
+                        m_selected = -1;
+                    }
+                    else if (m_selected > to_remove)
+                    {
+                        --m_selected;
+                    }
                 }
                 if (ImGui::Button("Add"))
                 {
@@ -186,14 +305,124 @@ namespace re
             }
         }
         ImGui::End();
+
+        pick_entity();
+    }
+
+    void Scene::pick_entity()
+    {
+        //the input manager already ignores clicks imgui wants, the gizmos don't count as imgui windows
+        if (!m_input_manager.snapshot().pressed(MouseButton::Left) || ImGuizmo::IsOver() || ImGuizmo::IsUsing())
+        {
+            return;
+        }
+
+        PROFILE_FUNCTION();
+        update_bvh();
+
+        const auto display = ImGui::GetIO().DisplaySize;
+        if (display.x <= 0.f || display.y <= 0.f)
+        {
+            return;
+        }
+        const auto mouse = m_input_manager.mouse_pos();
+        const maths::Vector2 ndc = {2.f * mouse.x / display.x - 1.f, 1.f - 2.f * mouse.y / display.y};
+
+        auto camera = m_camera;
+        camera.aspect = display.x / display.y;
+        const auto ray = camera.ray(ndc);
+
+        //the bvh only has loose world bounds, test the component's own bounds in the entity's space to be exact
+        auto hit = m_bvh.raycast(ray, camera.far, [&](int item) -> std::optional<float>
+        {
+            //nothing to see, so nothing to click on
+            if (!m_entities[item].visual_component)
+            {
+                return {};
+            }
+            const auto to_local = m_entities[item].transform().inverse();
+            const auto origin = to_local * ray.origin;
+            //not normalized, so distances along it are still world space distances
+            const phys::Ray local_ray = {origin, to_local * (ray.origin + ray.direction) - origin};
+            return phys::raycast(local_ray, m_entities[item].visual_component->local_bounds());
+        });
+        m_selected = hit ? hit->item : -1;
+    }
+
+    void Scene::update_bvh()
+    {
+        m_entity_bounds.resize(m_entities.size());
+        for (int i = 0; i < (int)m_entities.size(); ++i)
+        {
+            m_entity_bounds[i] = m_entities[i].bounds();
+        }
+
+        if (m_bvh.item_count() == (int)m_entity_bounds.size())
+        {
+            m_bvh.refit(m_entity_bounds);
+        }
+        else
+        {
+            m_bvh.build(m_entity_bounds);
+        }
     }
     
+    void Scene::save(const std::filesystem::path& path)
+    {
+        {
+            auto file = file::FileOut::from_absolute(path.string().c_str(), file::Compression::Blocks);
+            write(file);
+        }
+        remember_path(path);
+    }
+
+    void Scene::load(const std::filesystem::path& path)
+    {
+        {
+            auto file = file::FileIn::from_absolute(path.string().c_str());
+            read(file);
+        }
+        m_selected = -1;
+        reset_interpolation();
+        remember_path(path);
+        relink_assets();
+    }
+
+    bool Scene::reload_changed_file(const std::filesystem::path& path)
+    {
+        if (m_path.empty() || path.lexically_normal() != m_path)
+        {
+            return false;
+        }
+
+        std::error_code error;
+        auto write_time = std::filesystem::last_write_time(m_path, error);
+        if (error || write_time == m_write_time)
+        {
+            //deleted, or our own save
+            return false;
+        }
+
+        load(m_path);
+        return true;
+    }
+
+    void Scene::remember_path(const std::filesystem::path& path)
+    {
+        std::error_code error;
+        m_path = path.lexically_normal();
+        m_write_time = std::filesystem::last_write_time(m_path, error);
+    }
+
     void Scene::relink_assets()
     {
         m_batch_renderer.clear(true);
         for(auto& entity : m_entities)
         {
-            entity.visual_component->relink(*this);
+            if (entity.visual_component)
+            {
+                entity.visual_component->relink(*this);
+            }
         }
     }
 }
\ No newline at end of file
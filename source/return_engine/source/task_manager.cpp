@@ -1,7 +1,10 @@
 #include "task_manager.h"
 
+#include "profiler.h"
+
 #include <algorithm>
 #include <cassert>
+#include <string>
 
 namespace re
 {
@@ -26,7 +29,7 @@ namespace re
         m_thread_pool.reserve(thread_count);
         for (int i = 0; i < thread_count; ++i)
         {
-            m_thread_pool.push_back(std::thread(&TaskManager::task_thread_loop, this));
+            m_thread_pool.push_back(std::thread(&TaskManager::task_thread_loop, this, i));
         }
     }
 
@@ -37,10 +40,12 @@ namespace re
         {
             thread.join();
         }
+        m_thread_pool.clear();
     }
 
     void TaskManager::add_task(Task task)
     {
+        ++m_unfinished;
         m_task_mutex.lock();
         m_tasks.push(std::move(task));
         m_task_mutex.unlock();
@@ -48,26 +53,48 @@ namespace re
 
     void TaskManager::add_tasks(IndexedTask task, int start, int end)
     {
-        //m_task_mutex.lock();
-        //for (int i = start; i < end; ++i)
-        //{
-        //    m_tasks.push([task, i]() { task(i); });
-        //}
-        //m_task_mutex.unlock();
+        //only one indexed range at a time, finish the previous one first
+        assert(m_next == m_end);
 
+        m_task_mutex.lock();
+        m_unfinished += end - start;
+        m_indexed_unfinished += end - start;
         m_task = std::move(task);
         m_next = start;
         m_end = end;
+        m_task_mutex.unlock();
     }
 
     void TaskManager::finish_tasks()
     {
-        while (m_running && execute_tasks())
-        {}
+        while (m_unfinished > 0)
+        {
+            //help out, then wait for whatever other threads are still running
+            if (!execute_tasks())
+            {
+                std::this_thread::yield();
+            }
+        }
     }
 
-    void TaskManager::task_thread_loop()
+    void TaskManager::run_tasks(IndexedTask task, int start, int end)
     {
+        add_tasks(std::move(task), start, end);
+        while (m_indexed_unfinished > 0)
+        {
+            //queued tasks could take arbitrarily long, leave them to the pool
+            if (!execute_tasks(true))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void TaskManager::task_thread_loop(int index)
+    {
+        std::string thread_name = "Worker " + std::to_string(index);
+        profiler_set_thread_name(thread_name.c_str());
+
         while (m_running)
         {
             //take on a task. if none available, sleep for a bit
@@ -78,57 +105,43 @@ namespace re
             }
         }
     }
-    bool TaskManager::execute_tasks()
+
+    bool TaskManager::execute_tasks(bool indexed_only)
     {
+        //indexed tasks first, a batch at a time
         int start, end;
+        IndexedTask* indexed_task = nullptr;
+        Task task;
         m_task_mutex.lock();
         start = m_next;
         end = std::min(m_end, start + m_task_batch_count);
         m_next = end;
+        if (start != end)
+        {
+            indexed_task = &m_task;
+        }
+        else if (!indexed_only && m_tasks.count() > 0)
+        {
+            task = m_tasks.pop();
+        }
         m_task_mutex.unlock();
 
-        if (start == end)
+        if (indexed_task)
         {
-            return false;
+            for (int i = start; i < end; ++i)
+            {
+                (*indexed_task)(i);
+            }
+            m_indexed_unfinished -= end - start;
+            m_unfinished -= end - start;
+            return true;
         }
-        for (int i = start; i < end; ++i)
+        if (task)
         {
-            m_task(i);
+            task();
+            --m_unfinished;
+            return true;
         }
-        return true;
-
-        ////thread local to avoid re-allocating every time
-        ////could be part of the manager?
-        //thread_local std::vector<Task> local_tasks;
-        //
-        ////lock mutex and collect tasks
-        //m_task_mutex.lock();
-        //for (int i = 0; i < m_task_batch_count; ++i)
-        //{
-        //    if (m_tasks.count() == 0)
-        //    {
-        //        break;
-        //    }
-        //
-        //    local_tasks.push_back(m_tasks.pop());
-        //}
-        //m_task_mutex.unlock();
-        //
-        ////return false if we have no tasks to do
-        //if (local_tasks.empty())
-        //{
-        //    return false;
-        //}
-        //
-        ////run the tasks after unlocking the mutex
-        //for (auto& task : local_tasks)
-        //{
-        //    task();
-        //}
-        //
-        ////clear task list for next iteration
-        //local_tasks.clear();
-        //
-        //return true;
+        return false;
     }
 }
\ No newline at end of file
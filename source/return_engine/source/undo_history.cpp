@@ -0,0 +1,14 @@
+#include "undo_history.h"
+
+namespace re
+{
+    namespace
+    {
+        uint64_t g_next_revision = 1;
+    }
+
+    void Revisioned::new_revision()
+    {
+        m_revision = g_next_revision++;
+    }
+}
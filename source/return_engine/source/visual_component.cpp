@@ -1,9 +1,9 @@
 #include "visual_component.h"
 
+#include "render_packet.h"
 #include "scene.h"
 
 #include "maths/maths.h"
-#include "gfx/debug_lines.h"
 #include "gfx/graphics_manager.h"
 
 #include "imgui/imgui.h"
@@ -37,6 +37,7 @@ namespace re
         f >> valid;
         if (!valid)
         {
+            vc = nullptr;
             return f;
         }
 
@@ -71,121 +72,88 @@ namespace re
         return f;
     }
 
-    void VAOComponent::draw(
-        const maths::Matrix44& transform,
-        [[maybe_unused]] const maths::Matrix44& camera,
-        [[maybe_unused]] const Scene& scene,
-        [[maybe_unused]] gfx::BatchRenderer& batch_renderer) const
+    void VAOComponent::draw(const maths::Matrix44& transform, const Scene&, RenderPacket& packet) const
     {
-        if(m_vao == nullptr || m_program == nullptr) return;
-#if 1
-        batch_renderer.add_instance(*m_vao, *m_program, m_texture, transform);
-#else
-        auto& vao = *m_vao;
-        auto& program = *m_program;
-        
-        //texture
-        if(m_texture)
+        packet.add_instance(m_program, m_vao, m_texture, transform);
+    }
+
+    //combo listing every named resource of one type, returns true if a different one was picked
+    template<typename T>
+    static bool resource_combo(const char* label, const gfx::ResourceSlots<T>& resources, gfx::Handle<T>& handle, std::string& name)
+    {
+        bool changed = false;
+        if (ImGui::BeginCombo(label, name.c_str()))
         {
-            m_texture->use();
+            for (int i = 0; i < resources.slot_count(); ++i)
+            {
+                auto option = resources.handle_at(i);
+                if (!resources.get(option))
+                {
+                    continue;
+                }
+
+                const bool selected = option == handle;
+                if (ImGui::Selectable(resources.name(option).c_str(), selected) && !selected)
+                {
+                    handle = option;
+                    name = resources.name(option);
+                    changed = true;
+                }
+            }
+            ImGui::EndCombo();
         }
-        else
+        return changed;
+    }
+
+    //handles stay valid across recompiles, the name is only looked up if the handle has gone stale or was never found
+    template<typename T>
+    static void relink_handle(const gfx::GraphicsManager& manager, gfx::Handle<T>& handle, const std::string& name)
+    {
+        if (!manager.resources<T>().valid(handle))
         {
-            gfx::unbind_texture();
+            handle = manager.find<T>(name.c_str());
         }
-
-        //program
-        program.use();
-        gfx::set_uniform(program.uniform_location("tex"), 0);
-        gfx::set_uniform(program.uniform_location("time"), scene.time());
-        gfx::set_uniform(program.uniform_location("transform"), transform);
-        gfx::set_uniform(program.uniform_location("camera"), camera);
-        gfx::set_uniform(program.uniform_location("light_direction"), scene.directional_light().direction);
-        gfx::set_uniform(program.uniform_location("light_colour"), scene.directional_light().colour);
-        gfx::set_uniform(program.uniform_location("ambient_colour"), scene.ambient_light().colour);
-
-        //vao
-        vao.use();
-        vao.draw_triangles();
-#endif
     }
 
     void VAOComponent::edit(const Scene& scene)
     {
         auto& manager = scene.gfx_manager();
-        auto vaos = manager.vertex_array_names();
-        auto programs = manager.shader_program_names();
-        auto textures = manager.texture_names();
 
         if (ImGui::Button("Clear vao"))
         {
-            m_vao = nullptr;
+            m_vao = {};
             m_vao_name = "";
         }
         ImGui::SameLine();
-        if (ImGui::BeginCombo("VAO", m_vao_name.c_str()))
-        {
-            for (auto& vao : vaos)
-            {
-                const bool selected = vao == m_vao_name;
-                if (ImGui::Selectable(vao.c_str(), selected) && !selected)
-                {
-                    m_vao_name = vao;
-                    m_vao = manager.vertex_array(vao.c_str());
-                }
-            }
-            ImGui::EndCombo();
-        }
+        resource_combo("VAO", manager.resources<gfx::VertexArray>(), m_vao, m_vao_name);
+
         if (ImGui::Button("Clear program"))
         {
-            m_program = nullptr;
+            m_program = {};
             m_program_name = "";
         }
         ImGui::SameLine();
-        if (ImGui::BeginCombo("Program", m_program_name.c_str()))
-        {
-            for (auto& program : programs)
-            {
-                const bool selected = program == m_program_name;
-                if (ImGui::Selectable(program.c_str(), selected) && !selected)
-                {
-                    m_program_name = program;
-                    m_program = manager.shader_program(program.c_str());
-                }
-            }
-            ImGui::EndCombo();
-        }
+        resource_combo("Program", manager.resources<gfx::ShaderProgram>(), m_program, m_program_name);
+
         if (ImGui::Button("Clear texture"))
         {
-            m_texture = nullptr;
+            m_texture = {};
             m_texture_name = "";
         }
         ImGui::SameLine();
-        if (ImGui::BeginCombo("Texture", m_texture_name.c_str()))
-        {
-            for (auto& texture : textures)
-            {
-                const bool selected = texture == m_texture_name;
-                if (ImGui::Selectable(texture.c_str(), selected) && !selected)
-                {
-                    m_texture_name = texture;
-                    m_texture = manager.texture(texture.c_str());
-                }
-            }
-            ImGui::EndCombo();
-        }
+        resource_combo("Texture", manager.resources<gfx::Texture>(), m_texture, m_texture_name);
     }
     void VAOComponent::relink(const Scene& scene)
     {
         auto& manager = scene.gfx_manager();
-        m_vao = manager.vertex_array(m_vao_name.c_str());
-        m_program = manager.shader_program(m_program_name.c_str());
-        m_texture = manager.texture(m_texture_name.c_str());
+        relink_handle(manager, m_vao, m_vao_name);
+        relink_handle(manager, m_program, m_program_name);
+        relink_handle(manager, m_texture, m_texture_name);
     }
 
-    void SphereComponent::draw(const maths::Matrix44& transform, const maths::Matrix44& camera, const Scene&, gfx::BatchRenderer&) const
+    void SphereComponent::draw(const maths::Matrix44& transform, const Scene&, RenderPacket& packet) const
     {
-        gfx::draw_sphere(transform, m_radius, camera, m_colour, m_num_segments);
+        packet.add_sphere(transform, m_radius, m_colour, m_num_segments);
     }
 
     void SphereComponent::edit(const Scene&)
@@ -195,9 +163,9 @@ namespace re
         ImGui::SliderInt("Segments", &m_num_segments, 2, 64);
     }
     
-    void CubeComponent::draw(const maths::Matrix44& transform, const maths::Matrix44& camera, const Scene&, gfx::BatchRenderer&) const
+    void CubeComponent::draw(const maths::Matrix44& transform, const Scene&, RenderPacket& packet) const
     {
-        gfx::draw_cube(transform, m_dimensions, camera, m_colour);
+        packet.add_cube(transform, m_dimensions, m_colour);
     }
     
     void CubeComponent::edit(const Scene&)
@@ -1,8 +1,10 @@
 #include "window.h"
 
 #include "dockspace.h"
+#include "profiler.h"
 
 #include "gfx/graphics_core.h"
+#include "gfx/render_state.h"
 
 #include "GLFW/glfw3.h"
 
@@ -106,6 +108,8 @@ namespace re
         //having this here is probbably a bit weird and restrictive but can change that later
         if (!g_first_update)
         {
+            PROFILE_SCOPE("Present");
+
             //imgui
             re::end_dockspace();
             ImGui::Render();
@@ -134,6 +138,9 @@ namespace re
         ImGuizmo::SetRect(0, 0, io.DisplaySize.x, io.DisplaySize.y);
 
         //gfx
+        //imgui rendering binds its own objects, don't trust our shadowed state from last frame
+        gfx::invalidate_render_state();
+        gfx::begin_render_state_frame();
         gfx::clear(0.f, 0.f, 0.f, 0.f);
         re::begin_dockspace();
 
@@ -143,12 +150,17 @@ namespace re
         return true;
     }
 
+    void window_close()
+    {
+        glfwSetWindowShouldClose(g_window, GLFW_TRUE);
+    }
+
     float window_aspect()
     {
         return g_aspect;
     }
 
-    const InputManager& window_input_manager()
+    InputManager& window_input_manager()
     {
         assert(g_input_manager);
         return *g_input_manager;
@@ -0,0 +1,175 @@
+#include "physics/batch_collisions.h"
+
+#include <gtest/gtest.h>
+
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+    //coordinates on a coarse grid so plenty of shapes exactly touch
+    struct ShapeGenerator
+    {
+        std::mt19937 random{1234};
+        std::uniform_int_distribution<int> coordinate{-8, 8};
+        std::uniform_int_distribution<int> size{1, 4};
+
+        maths::Vector3 point()
+        {
+            return {0.5f * coordinate(random), 0.5f * coordinate(random), 0.5f * coordinate(random)};
+        }
+        phys::Sphere sphere()
+        {
+            return {point(), 0.5f * size(random)};
+        }
+        phys::AABB3 aabb()
+        {
+            auto min = point();
+            return {min, min + maths::Vector3{0.5f * size(random), 0.5f * size(random), 0.5f * size(random)}};
+        }
+    };
+
+    bool hit(const std::vector<uint32_t>& hits, int i)
+    {
+        return (hits[i / 32] >> (i % 32)) & 1;
+    }
+
+    double seconds_since(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+TEST(BatchCollisions, MatchScalarIntersects)
+{
+    ShapeGenerator generator;
+    std::vector<phys::Sphere> spheres;
+    std::vector<phys::AABB3> aabbs;
+    phys::SphereBatch sphere_batch;
+    phys::AABBBatch aabb_batch;
+    for (int i = 0; i < 1000; ++i)
+    {
+        spheres.push_back(generator.sphere());
+        sphere_batch.add(spheres.back());
+        aabbs.push_back(generator.aabb());
+        aabb_batch.add(aabbs.back());
+    }
+
+    //odd offsets and counts so the scalar tail and word boundaries are covered
+    const int first = 3;
+    const int count = 997;
+    std::vector<uint32_t> hits(phys::hit_mask_words(count));
+    std::vector<float> penetration(count);
+    int touching = 0;
+    for (int test = 0; test < 50; ++test)
+    {
+        const auto sphere = generator.sphere();
+        const auto aabb = generator.aabb();
+
+        phys::intersects(sphere, sphere_batch, first, count, hits.data(), penetration.data());
+        for (int i = 0; i < count; ++i)
+        {
+            ASSERT_EQ(hit(hits, i), phys::intersects(sphere, spheres[first + i])) << i;
+            if (hit(hits, i))
+            {
+                const float distance = (sphere.pos - spheres[first + i].pos).magnitude();
+                EXPECT_FLOAT_EQ(penetration[i], sphere.radius + spheres[first + i].radius - distance);
+            }
+        }
+
+        phys::intersects(sphere, aabb_batch, first, count, hits.data());
+        for (int i = 0; i < count; ++i)
+        {
+            ASSERT_EQ(hit(hits, i), phys::intersects(sphere, aabbs[first + i])) << i;
+        }
+
+        phys::intersects(aabb, aabb_batch, first, count, hits.data(), penetration.data());
+        for (int i = 0; i < count; ++i)
+        {
+            const bool scalar_hit = phys::intersects(aabb, aabbs[first + i]);
+            ASSERT_EQ(hit(hits, i), scalar_hit) << i;
+            EXPECT_EQ(scalar_hit, penetration[i] > 0.f);
+            touching += penetration[i] == 0.f;
+        }
+    }
+
+    //make sure the touching case was actually exercised
+    EXPECT_GT(touching, 0);
+}
+
+TEST(BatchCollisions, TouchingIsntIntersecting)
+{
+    phys::SphereBatch spheres;
+    spheres.add({{2.f, 0.f, 0.f}, 1.f});
+    spheres.add({{1.9f, 0.f, 0.f}, 1.f});
+    phys::AABBBatch aabbs;
+    aabbs.add({{1.f, -1.f, -1.f}, {2.f, 1.f, 1.f}});
+    aabbs.add({{0.9f, -1.f, -1.f}, {2.f, 1.f, 1.f}});
+
+    uint32_t hits = 0;
+    phys::intersects(phys::Sphere{{0.f, 0.f, 0.f}, 1.f}, spheres, 0, 2, &hits);
+    EXPECT_EQ(hits, 0b10u);
+    phys::intersects(phys::Sphere{{0.f, 0.f, 0.f}, 1.f}, aabbs, 0, 2, &hits);
+    EXPECT_EQ(hits, 0b10u);
+    phys::intersects(phys::AABB3{{-1.f, -1.f, -1.f}, {1.f, 1.f, 1.f}}, aabbs, 0, 2, &hits);
+    EXPECT_EQ(hits, 0b10u);
+}
+
+TEST(BatchCollisions, DISABLED_Benchmark)
+{
+    ShapeGenerator generator;
+    std::vector<phys::Sphere> spheres;
+    std::vector<phys::AABB3> aabbs;
+    phys::SphereBatch sphere_batch;
+    phys::AABBBatch aabb_batch;
+    constexpr int count = 4096;
+    for (int i = 0; i < count; ++i)
+    {
+        spheres.push_back(generator.sphere());
+        sphere_batch.add(spheres.back());
+        aabbs.push_back(generator.aabb());
+        aabb_batch.add(aabbs.back());
+    }
+    std::vector<uint32_t> hits(phys::hit_mask_words(count));
+    constexpr int repeats = 2000;
+
+    auto measure = [&](const char* name, auto scalar, auto batched)
+    {
+        int scalar_hits = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r)
+        {
+            scalar_hits += scalar(r);
+        }
+        const double scalar_seconds = seconds_since(start);
+
+        int batch_hits = 0;
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r)
+        {
+            batched(r);
+            for (auto word : hits)
+            {
+                batch_hits += std::popcount(word);
+            }
+        }
+        const double batch_seconds = seconds_since(start);
+
+        const double tests = (double)repeats * count;
+        std::printf("%-14s scalar %6.2f ns/test, batched %6.2f ns/test (x%d), %.1fx\n",
+            name, 1e9 * scalar_seconds / tests, 1e9 * batch_seconds / tests, phys::batch_collision_width(), scalar_seconds / batch_seconds);
+        EXPECT_EQ(scalar_hits, batch_hits);
+    };
+
+    measure("sphere-sphere",
+        [&](int r) { int n = 0; for (auto& s : spheres) n += phys::intersects(spheres[r % count], s); return n; },
+        [&](int r) { phys::intersects(spheres[r % count], sphere_batch, 0, count, hits.data()); });
+    measure("sphere-aabb",
+        [&](int r) { int n = 0; for (auto& a : aabbs) n += phys::intersects(spheres[r % count], a); return n; },
+        [&](int r) { phys::intersects(spheres[r % count], aabb_batch, 0, count, hits.data()); });
+    measure("aabb-aabb",
+        [&](int r) { int n = 0; for (auto& a : aabbs) n += phys::intersects(aabbs[r % count], a); return n; },
+        [&](int r) { phys::intersects(aabbs[r % count], aabb_batch, 0, count, hits.data()); });
+}
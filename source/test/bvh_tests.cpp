@@ -0,0 +1,257 @@
+#include "physics/bvh.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+    //small boxes scattered through a cube, with some clusters so splits aren't all even
+    std::vector<phys::AABB3> random_bounds(int count, float extent, uint32_t seed = 1234)
+    {
+        std::mt19937 random{seed};
+        std::uniform_real_distribution<float> position{-extent, extent};
+        std::uniform_real_distribution<float> size{0.1f, 1.f};
+        std::vector<phys::AABB3> bounds;
+        for (int i = 0; i < count; ++i)
+        {
+            maths::Vector3 min = {position(random), position(random), position(random)};
+            if (i % 4 == 0)
+            {
+                min = min * 0.1f;
+            }
+            bounds.push_back({min, min + maths::Vector3{size(random), size(random), size(random)}});
+        }
+        return bounds;
+    }
+
+    phys::Ray random_ray(std::mt19937& random, float extent)
+    {
+        std::uniform_real_distribution<float> position{-extent, extent};
+        maths::Vector3 direction = {position(random), position(random), position(random)};
+        return {{position(random), position(random), position(random)}, direction.normalized()};
+    }
+
+    std::vector<int> sorted(std::vector<int> items)
+    {
+        std::sort(items.begin(), items.end());
+        return items;
+    }
+
+    double seconds_since(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+TEST(BVH, QueriesMatchBruteForce)
+{
+    const auto bounds = random_bounds(2000, 20.f);
+    phys::BVH bvh;
+    bvh.build(bounds);
+    EXPECT_EQ(bvh.item_count(), 2000);
+
+    std::mt19937 random{99};
+    std::uniform_real_distribution<float> position{-20.f, 20.f};
+    for (int test = 0; test < 50; ++test)
+    {
+        const maths::Vector3 min = {position(random), position(random), position(random)};
+        const phys::AABB3 aabb = {min, min + maths::Vector3{4.f, 4.f, 4.f}};
+        const phys::Sphere sphere = {min, 3.f};
+
+        std::vector<int> aabb_expected;
+        std::vector<int> sphere_expected;
+        for (int i = 0; i < (int)bounds.size(); ++i)
+        {
+            if (phys::intersects(aabb, bounds[i]))
+            {
+                aabb_expected.push_back(i);
+            }
+            if (phys::intersects(sphere, bounds[i]))
+            {
+                sphere_expected.push_back(i);
+            }
+        }
+
+        std::vector<int> found;
+        bvh.query(aabb, found);
+        EXPECT_EQ(sorted(found), aabb_expected);
+        found.clear();
+        bvh.query(sphere, found);
+        EXPECT_EQ(sorted(found), sphere_expected);
+
+        const auto ray = random_ray(random, 20.f);
+        std::optional<float> nearest;
+        for (auto& item : bounds)
+        {
+            auto distance = phys::raycast(ray, item);
+            if (distance && (!nearest || *distance < *nearest))
+            {
+                nearest = distance;
+            }
+        }
+        auto hit = bvh.raycast(ray);
+        ASSERT_EQ(hit.has_value(), nearest.has_value());
+        if (hit)
+        {
+            EXPECT_FLOAT_EQ(hit->distance, *nearest);
+            EXPECT_FLOAT_EQ(*phys::raycast(ray, bounds[hit->item]), *nearest);
+        }
+    }
+}
+
+TEST(BVH, FindPairsMatchesBruteForce)
+{
+    const auto bounds = random_bounds(500, 8.f);
+    phys::BVH bvh;
+    bvh.build(bounds);
+
+    std::vector<phys::BodyPair> expected;
+    for (int a = 0; a < (int)bounds.size(); ++a)
+    {
+        for (int b = a + 1; b < (int)bounds.size(); ++b)
+        {
+            if (phys::intersects(bounds[a], bounds[b]))
+            {
+                expected.push_back({a, b});
+            }
+        }
+    }
+    ASSERT_FALSE(expected.empty());
+
+    std::vector<phys::BodyPair> pairs;
+    bvh.find_pairs(pairs);
+    EXPECT_EQ(pairs, expected);
+}
+
+TEST(BVH, RefitFollowsMovedItems)
+{
+    auto bounds = random_bounds(1000, 20.f);
+    phys::BVH bvh;
+    bvh.build(bounds);
+    const int nodes = bvh.node_count();
+
+    //move one item well outside everything else
+    bounds[123] = {{100.f, 100.f, 100.f}, {101.f, 101.f, 101.f}};
+    bvh.refit(bounds);
+    EXPECT_EQ(bvh.node_count(), nodes);
+
+    std::vector<int> found;
+    bvh.query(phys::Sphere{{100.5f, 100.5f, 100.5f}, 1.f}, found);
+    EXPECT_EQ(found, std::vector<int>{123});
+
+    auto hit = bvh.raycast({{100.5f, 100.5f, 90.f}, maths::Vector3::unit_z()});
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->item, 123);
+    EXPECT_FLOAT_EQ(hit->distance, 10.f);
+}
+
+TEST(BVH, RayTestPicksNearestExactHit)
+{
+    //a big box in front of a small one, but the exact test says the ray misses the big one
+    std::vector<phys::AABB3> bounds = {
+        {{-5.f, -5.f, 0.f}, {5.f, 5.f, 1.f}},
+        {{-1.f, -1.f, 5.f}, {1.f, 1.f, 6.f}},
+    };
+    phys::BVH bvh;
+    bvh.build(bounds);
+
+    const phys::Ray ray = {{0.f, 0.f, -10.f}, maths::Vector3::unit_z()};
+    EXPECT_EQ(bvh.raycast(ray)->item, 0);
+
+    auto hit = bvh.raycast(ray, INFINITY, [&](int item) -> std::optional<float>
+    {
+        if (item == 0)
+        {
+            return std::nullopt;
+        }
+        return phys::raycast(ray, bounds[item]);
+    });
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->item, 1);
+    EXPECT_FLOAT_EQ(hit->distance, 15.f);
+
+    EXPECT_FALSE(bvh.raycast(ray, 5.f).has_value());
+}
+
+TEST(BVH, Empty)
+{
+    phys::BVH bvh;
+    bvh.build({});
+    std::vector<int> found;
+    bvh.query(phys::AABB3{{-1.f, -1.f, -1.f}, {1.f, 1.f, 1.f}}, found);
+    EXPECT_TRUE(found.empty());
+    EXPECT_FALSE(bvh.raycast({}).has_value());
+}
+
+TEST(BVH, DISABLED_Benchmark)
+{
+    constexpr int count = 100000;
+    auto bounds = random_bounds(count, 200.f);
+    phys::BVH bvh;
+
+    auto start = std::chrono::steady_clock::now();
+    bvh.build(bounds);
+    const double build_seconds = seconds_since(start);
+
+    for (auto& item : bounds)
+    {
+        item.min += maths::Vector3{0.1f, 0.f, 0.f};
+        item.max += maths::Vector3{0.1f, 0.f, 0.f};
+    }
+    start = std::chrono::steady_clock::now();
+    bvh.refit(bounds);
+    const double refit_seconds = seconds_since(start);
+
+    std::mt19937 random{7};
+    constexpr int rays = 10000;
+    int ray_hits = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rays; ++i)
+    {
+        ray_hits += bvh.raycast(random_ray(random, 200.f)).has_value();
+    }
+    const double ray_seconds = seconds_since(start);
+
+    //brute force for comparison, fewer rays as it's so much slower
+    constexpr int brute_rays = 100;
+    int brute_hits = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < brute_rays; ++i)
+    {
+        const auto ray = random_ray(random, 200.f);
+        const maths::Vector3 inv_direction = {1.f / ray.direction.x, 1.f / ray.direction.y, 1.f / ray.direction.z};
+        float nearest = INFINITY;
+        for (auto& item : bounds)
+        {
+            nearest = std::min(nearest, phys::raycast(ray, inv_direction, item).value_or(INFINITY));
+        }
+        brute_hits += nearest != INFINITY;
+    }
+    const double brute_seconds = seconds_since(start);
+
+    std::vector<int> found;
+    constexpr int queries = 10000;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < queries; ++i)
+    {
+        found.clear();
+        bvh.query(phys::Sphere{random_ray(random, 200.f).origin, 5.f}, found);
+    }
+    const double query_seconds = seconds_since(start);
+
+    std::vector<phys::BodyPair> pairs;
+    start = std::chrono::steady_clock::now();
+    bvh.find_pairs(pairs);
+    const double pair_seconds = seconds_since(start);
+
+    std::printf("%d items, %d nodes, cost %.1f\n", count, bvh.node_count(), bvh.cost());
+    std::printf("build %.2f ms, refit %.2f ms\n", 1e3 * build_seconds, 1e3 * refit_seconds);
+    std::printf("raycast %.2f us (%d hits), brute force %.2f us, %.0fx\n",
+        1e6 * ray_seconds / rays, ray_hits, 1e6 * brute_seconds / brute_rays, (brute_seconds / brute_rays) / (ray_seconds / rays));
+    std::printf("sphere query %.2f us, find pairs %.2f ms (%d pairs)\n", 1e6 * query_seconds / queries, 1e3 * pair_seconds, (int)pairs.size());
+    EXPECT_GT(brute_hits, 0);
+}
@@ -0,0 +1,156 @@
+#include "file/compression.h"
+#include "file/file.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::vector<uint8_t> random_bytes(size_t count, unsigned seed)
+    {
+        std::mt19937 random{seed};
+        std::vector<uint8_t> bytes(count);
+        for (auto& byte : bytes)
+        {
+            byte = (uint8_t)random();
+        }
+        return bytes;
+    }
+
+    //repeats with small changes, like serialized tags, lengths and nearby floats
+    std::vector<uint8_t> structured_bytes(size_t count)
+    {
+        std::vector<uint8_t> bytes;
+        for (uint32_t i = 0; bytes.size() < count; ++i)
+        {
+            const uint64_t tag = i % 3;
+            const float value = 0.25f * (float)(i % 17);
+            bytes.insert(bytes.end(), (const uint8_t*)&tag, (const uint8_t*)&tag + sizeof(tag));
+            bytes.insert(bytes.end(), (const uint8_t*)&value, (const uint8_t*)&value + sizeof(value));
+        }
+        bytes.resize(count);
+        return bytes;
+    }
+
+    std::vector<uint8_t> block_round_trip(const std::vector<uint8_t>& input)
+    {
+        std::vector<uint8_t> compressed;
+        file::compress_block(input, compressed);
+        std::vector<uint8_t> output(input.size());
+        EXPECT_TRUE(file::decompress_block(compressed, output));
+        return output;
+    }
+}
+
+TEST(Compression, BlocksRoundTrip)
+{
+    EXPECT_TRUE(block_round_trip({}).empty());
+    for (size_t size : {1, 3, 4, 5, 15, 16, 300, 4096, (int)file::c_max_block_size})
+    {
+        auto structured = structured_bytes(size);
+        EXPECT_EQ(block_round_trip(structured), structured) << size;
+        auto random = random_bytes(size, (unsigned)size);
+        EXPECT_EQ(block_round_trip(random), random) << size;
+    }
+
+    //long runs overlap the bytes they copy and need extended lengths
+    std::vector<uint8_t> run(file::c_max_block_size, 9);
+    EXPECT_EQ(block_round_trip(run), run);
+}
+
+TEST(Compression, RepetitiveDataShrinks)
+{
+    auto input = structured_bytes(file::c_max_block_size);
+    std::vector<uint8_t> compressed;
+    file::compress_block(input, compressed);
+    EXPECT_LT(compressed.size(), input.size() / 4);
+}
+
+TEST(Compression, CorruptBlocksAreRejected)
+{
+    auto input = structured_bytes(1000);
+    std::vector<uint8_t> compressed;
+    file::compress_block(input, compressed);
+
+    std::vector<uint8_t> output(input.size());
+    EXPECT_FALSE(file::decompress_block(std::span(compressed).first(compressed.size() / 2), output));
+    std::vector<uint8_t> too_small(input.size() - 1);
+    EXPECT_FALSE(file::decompress_block(compressed, too_small));
+
+    //a match reaching back before the start of the block
+    const uint8_t bad_offset[] = {0x10, 'a', 0x05, 0x00};
+    uint8_t bytes[5];
+    EXPECT_FALSE(file::decompress_block(bad_offset, bytes));
+}
+
+TEST(Compression, StreamsSpanBlocks)
+{
+    //more than a few blocks, written in pieces that straddle block boundaries
+    auto structured = structured_bytes(5 * file::c_max_block_size + 123);
+    auto random = random_bytes(file::c_max_block_size + 7, 3);
+    std::vector<uint8_t> stream;
+    {
+        auto out = file::FileOut::to_memory(stream, file::Compression::Blocks);
+        for (size_t offset = 0; offset < structured.size(); offset += 1000)
+        {
+            out.write(structured.data() + offset, std::min<size_t>(1000, structured.size() - offset));
+        }
+        out.write(random.data(), random.size());
+        out << std::string("end");
+    }
+    ASSERT_TRUE(file::is_compressed_stream(stream));
+    EXPECT_LT(stream.size(), structured.size() / 2 + random.size() + 1024);
+
+    auto in = file::FileIn::from_memory(stream);
+    std::vector<uint8_t> structured_read(structured.size());
+    std::vector<uint8_t> random_read(random.size());
+    std::string end;
+    in.read(structured_read.data(), structured_read.size());
+    in.read(random_read.data(), random_read.size());
+    in >> end;
+    EXPECT_TRUE(in.valid());
+    EXPECT_EQ(structured_read, structured);
+    EXPECT_EQ(random_read, random);
+    EXPECT_EQ(end, "end");
+}
+
+TEST(Compression, ParallelDecompressionMatches)
+{
+    auto input = structured_bytes(8 * file::c_max_block_size + 1);
+    std::vector<uint8_t> stream;
+    file::begin_compressed_stream(stream);
+    for (size_t offset = 0; offset < input.size(); offset += file::c_max_block_size)
+    {
+        file::append_compressed_block(std::span(input).subspan(offset, std::min(file::c_max_block_size, input.size() - offset)), stream);
+    }
+
+    //every block on its own thread, last first
+    auto parallel_for = [](int count, const std::function<void(int)>& task)
+    {
+        std::vector<std::thread> threads;
+        for (int i = count - 1; i >= 0; --i)
+        {
+            threads.emplace_back(task, i);
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    };
+    auto serial = file::decompress_stream(stream);
+    auto parallel = file::decompress_stream(stream, parallel_for);
+    ASSERT_TRUE(serial && parallel);
+    EXPECT_EQ(*serial, input);
+    EXPECT_EQ(*parallel, input);
+
+    //a truncated stream gives nothing back rather than part of the data
+    EXPECT_FALSE(file::decompress_stream(std::span(stream).first(stream.size() - 1)));
+    auto in = file::FileIn::from_memory(std::span(stream).first(stream.size() - 1));
+    EXPECT_FALSE(in.valid());
+}
@@ -0,0 +1,241 @@
+#include "editor_support/content_index.h"
+#include "editor_support/fuzzy_search.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    //fresh directory of generated files per test, removed afterwards
+    class ContentIndexTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            auto* test = ::testing::UnitTest::GetInstance()->current_test_info();
+            m_directory = std::filesystem::temp_directory_path() / "return_content_index_tests" / test->name();
+            std::filesystem::remove_all(m_directory);
+            std::filesystem::create_directories(m_directory);
+        }
+        void TearDown() override
+        {
+            std::filesystem::remove_all(m_directory);
+        }
+
+        void create(const std::string& relative_path)
+        {
+            auto path = m_directory / relative_path;
+            std::filesystem::create_directories(path.parent_path());
+            std::ofstream(path).put('x');
+        }
+
+        //paths like a project's data folder, returns them relative
+        std::vector<std::string> create_project(int count)
+        {
+            static const char* c_folders[] = {"models", "textures", "shaders", "scenes", "levels", "props"};
+            static const char* c_words[] = {"rock", "tree", "player", "enemy", "light", "wall", "floor", "door", "crate", "barrel"};
+            static const char* c_extensions[] = {".obj", ".png", ".vert", ".scene"};
+            std::mt19937 random{3};
+            std::vector<std::string> paths;
+            for (int i = 0; i < count; ++i)
+            {
+                std::string path = std::string(c_folders[random() % 6]) + "/" + c_folders[random() % 6] + "/" +
+                    c_words[random() % 10] + "_" + c_words[random() % 10] + std::to_string(i) + c_extensions[random() % 4];
+                create(path);
+                paths.push_back(path);
+            }
+            return paths;
+        }
+
+        std::filesystem::path m_directory;
+    };
+
+    void wait_until_ready(const re::ContentIndex& index)
+    {
+        auto end = std::chrono::steady_clock::now() + 10s;
+        while (!index.ready() && std::chrono::steady_clock::now() < end)
+        {
+            std::this_thread::sleep_for(1ms);
+        }
+        ASSERT_TRUE(index.ready());
+    }
+
+    //every entry scored, the way searching worked before the index
+    std::vector<re::ContentResult> score_everything(const std::filesystem::path& root, const re::ContentQuery& query)
+    {
+        re::FuzzyMatcher matcher(query.term);
+        std::vector<re::ContentResult> results;
+        for (auto& entry : std::filesystem::recursive_directory_iterator(root / query.directory))
+        {
+            const bool directory = entry.is_directory();
+            if (!directory && !entry.path().string().ends_with(query.extension))
+            {
+                continue;
+            }
+            auto relative_path = entry.path().lexically_relative(root).generic_string();
+            auto text = query.filenames_only ? entry.path().filename().string() : relative_path;
+            results.push_back({relative_path, matcher.score(text), directory});
+        }
+        std::sort(results.begin(), results.end(), [](auto& lhs, auto& rhs)
+        {
+            return lhs.score != rhs.score ? lhs.score < rhs.score : lhs.relative_path < rhs.relative_path;
+        });
+        results.resize(std::min<size_t>(results.size(), query.max_results));
+        return results;
+    }
+
+    void expect_same(const std::vector<re::ContentResult>& actual, const std::vector<re::ContentResult>& expected)
+    {
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < actual.size(); ++i)
+        {
+            EXPECT_EQ(actual[i].relative_path, expected[i].relative_path) << i;
+            EXPECT_FLOAT_EQ(actual[i].score, expected[i].score) << i;
+            EXPECT_EQ(actual[i].directory, expected[i].directory) << i;
+        }
+    }
+}
+
+TEST_F(ContentIndexTest, SearchMatchesScoringEverything)
+{
+    create_project(600);
+    re::ContentIndex index(m_directory);
+    wait_until_ready(index);
+
+    for (const char* term : {"door", "PlayerWall", "textures/rock", "brl", "sc", "models/props/enemy_crate12.obj", "zzzzzz"})
+    {
+        for (bool filenames_only : {false, true})
+        {
+            re::ContentQuery query;
+            query.term = term;
+            query.max_results = 20;
+            query.filenames_only = filenames_only;
+            SCOPED_TRACE(term);
+            expect_same(index.search(query), score_everything(m_directory, query));
+        }
+    }
+}
+
+TEST_F(ContentIndexTest, SearchWithinDirectoryAndExtension)
+{
+    create_project(300);
+    re::ContentIndex index(m_directory);
+    wait_until_ready(index);
+
+    re::ContentQuery query;
+    query.term = "rock";
+    query.max_results = 15;
+    query.directory = "models";
+    query.extension = ".png";
+    query.filenames_only = true;
+    auto results = index.search(query);
+    ASSERT_FALSE(results.empty());
+    for (auto& result : results)
+    {
+        EXPECT_TRUE(result.relative_path.starts_with("models/"));
+        EXPECT_TRUE(result.directory || result.relative_path.ends_with(".png"));
+    }
+    expect_same(results, score_everything(m_directory, query));
+
+    query.directory = "missing";
+    EXPECT_TRUE(index.search(query).empty());
+}
+
+TEST_F(ContentIndexTest, UpdatesIncrementally)
+{
+    create("a/one.txt");
+    create("a/b/two.txt");
+    create("c/three.txt");
+    re::ContentIndex index(m_directory);
+    wait_until_ready(index);
+    EXPECT_EQ(index.entry_count(), 6);
+
+    //new file in a new directory, a deleted directory whose files were reported, and a directory moved in
+    create("d/four.txt");
+    std::filesystem::remove_all(m_directory / "a/b");
+    create("moved/five.txt");
+    std::filesystem::rename(m_directory / "moved", m_directory / "c/moved");
+    index.update({m_directory / "d/four.txt", m_directory / "a/b/two.txt", m_directory / "c/moved", m_directory / "../elsewhere.txt"});
+
+    auto names = [&](std::string_view directory)
+    {
+        std::vector<std::string> paths;
+        for (auto& entry : index.list(directory))
+        {
+            paths.push_back(entry.relative_path);
+        }
+        return paths;
+    };
+    EXPECT_EQ(names(""), (std::vector<std::string>{"a", "c", "d"}));
+    EXPECT_EQ(names("a"), (std::vector<std::string>{"a/one.txt"}));
+    EXPECT_EQ(names("c"), (std::vector<std::string>{"c/moved", "c/three.txt"}));
+    EXPECT_EQ(names("c/moved"), (std::vector<std::string>{"c/moved/five.txt"}));
+    EXPECT_EQ(index.entry_count(), 8);
+
+    re::ContentQuery query;
+    query.term = "five";
+    query.max_results = 1;
+    auto found = index.search(query);
+    ASSERT_EQ(found.size(), 1u);
+    EXPECT_EQ(found[0].relative_path, "c/moved/five.txt");
+
+    query.term = "two.txt";
+    query.filenames_only = true;
+    found = index.search(query);
+    ASSERT_EQ(found.size(), 1u);
+    EXPECT_NE(found[0].relative_path, "a/b/two.txt");
+}
+
+TEST_F(ContentIndexTest, DISABLED_Benchmark)
+{
+    constexpr int count = 20000;
+    create_project(count);
+
+    auto start = std::chrono::steady_clock::now();
+    re::ContentIndex index(m_directory);
+    wait_until_ready(index);
+    const double build_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    re::ContentQuery query;
+    query.term = "player_door";
+    query.max_results = 50;
+    auto time = [&](auto function)
+    {
+        constexpr int repeats = 10;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeats; ++i)
+        {
+            function();
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / repeats;
+    };
+
+    const double index_seconds = time([&] { index.search(query); });
+    //scoring every entry, without the disk walk
+    std::vector<std::string> paths;
+    for (auto& entry : std::filesystem::recursive_directory_iterator(m_directory))
+    {
+        paths.push_back(entry.path().lexically_relative(m_directory).generic_string());
+    }
+    re::FuzzyMatcher matcher(query.term);
+    const double linear_seconds = time([&]
+    {
+        std::vector<float> scores(paths.size());
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            scores[i] = matcher.score(paths[i]);
+        }
+    });
+
+    std::printf("%d entries, scan and index %.1f ms, search %.2f ms, scoring everything %.2f ms\n",
+        index.entry_count(), 1e3 * build_seconds, 1e3 * index_seconds, 1e3 * linear_seconds);
+}
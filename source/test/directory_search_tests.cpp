@@ -0,0 +1,125 @@
+#include "editor_support/directory_search.h"
+#include "editor_support/fuzzy_search.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    //fresh directory of generated files per test, removed afterwards
+    class DirectorySearchTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            auto* test = ::testing::UnitTest::GetInstance()->current_test_info();
+            m_directory = std::filesystem::temp_directory_path() / "return_directory_search_tests" / test->name();
+            std::filesystem::remove_all(m_directory);
+            for (int folder = 0; folder < 10; ++folder)
+            {
+                for (int file = 0; file < 50; ++file)
+                {
+                    auto path = m_directory / ("folder" + std::to_string(folder)) / ("file_" + std::to_string(file) + (file % 2 ? ".scene" : ".png"));
+                    std::filesystem::create_directories(path.parent_path());
+                    std::ofstream(path).put('x');
+                }
+            }
+        }
+        void TearDown() override
+        {
+            std::filesystem::remove_all(m_directory);
+        }
+
+        std::filesystem::path m_directory;
+    };
+
+    //takes results until the search finishes
+    std::vector<re::DirectorySearchResult> wait_for_results(re::DirectorySearch& search, int* batches = nullptr)
+    {
+        std::vector<re::DirectorySearchResult> results;
+        auto end = std::chrono::steady_clock::now() + 10s;
+        bool searching = true;
+        while (searching && std::chrono::steady_clock::now() < end)
+        {
+            //read before taking, so nothing published after it finished can be missed
+            searching = search.searching();
+            if (search.take_results(results) && batches)
+            {
+                ++*batches;
+            }
+            EXPECT_TRUE(std::is_sorted(results.begin(), results.end(), [](auto& lhs, auto& rhs) { return lhs.score < rhs.score; }));
+            std::this_thread::sleep_for(1ms);
+        }
+        EXPECT_FALSE(search.searching());
+        return results;
+    }
+}
+
+TEST_F(DirectorySearchTest, FindsEverythingSortedByScore)
+{
+    re::DirectorySearch search;
+    search.start(m_directory, "file_13", true, ".scene");
+    auto results = wait_for_results(search);
+
+    //10 folders, plus the 25 .scene files in each
+    ASSERT_EQ(results.size(), 10u + 250u);
+    re::FuzzyMatcher matcher("file_13");
+    for (auto& result : results)
+    {
+        EXPECT_FLOAT_EQ(result.score, matcher.score(result.path.filename().string()));
+        EXPECT_TRUE(result.directory || result.path.extension() == ".scene");
+    }
+    EXPECT_EQ(results.front().path.filename(), "file_13.scene");
+
+    search.start(m_directory / "folder3", "file", false);
+    results = wait_for_results(search);
+    EXPECT_EQ(results.size(), 50u);
+}
+
+TEST_F(DirectorySearchTest, RestartingDropsOldResults)
+{
+    re::DirectorySearch search;
+    std::vector<re::DirectorySearchResult> results;
+    search.start(m_directory, "aaaa", true);
+    std::this_thread::sleep_for(2ms);
+    search.take_results(results);
+    const auto first_generation = search.generation();
+
+    //whatever the first search had found is cleared on the next take
+    search.start(m_directory, "file_7", true, ".png");
+    EXPECT_GT(search.generation(), first_generation);
+    results = wait_for_results(search);
+    ASSERT_EQ(results.size(), 10u + 250u);
+    for (auto& result : results)
+    {
+        EXPECT_TRUE(result.directory || result.path.extension() == ".png");
+    }
+
+    //the same listing again is rescored from the last walk, files since added aren't seen until the listing changes
+    std::ofstream(m_directory / "folder0" / "new_file.png").put('x');
+    search.start(m_directory, "file_8", true, ".png");
+    EXPECT_EQ(wait_for_results(search).size(), 10u + 250u);
+    search.start(m_directory, "file_8", true, "");
+    EXPECT_EQ(wait_for_results(search).size(), 10u + 501u);
+}
+
+TEST_F(DirectorySearchTest, CancelStops)
+{
+    re::DirectorySearch search;
+    search.start(m_directory, "file", true);
+    search.cancel();
+    EXPECT_FALSE(search.searching());
+
+    std::vector<re::DirectorySearchResult> results = {{"stale", 0.f, false}};
+    search.take_results(results);
+    std::this_thread::sleep_for(20ms);
+    search.take_results(results);
+    EXPECT_TRUE(results.empty());
+}
@@ -0,0 +1,149 @@
+#include "file/file.h"
+#include "file/file_watcher.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    //fresh empty directory per test, removed afterwards
+    class FileWatcherTest : public ::testing::TestWithParam<bool>
+    {
+    protected:
+        void SetUp() override
+        {
+            auto* test = ::testing::UnitTest::GetInstance()->current_test_info();
+            m_directory = std::filesystem::temp_directory_path() / "return_file_watcher_tests" / std::to_string(std::hash<std::string>()(test->name()));
+            std::filesystem::remove_all(m_directory);
+            std::filesystem::create_directories(m_directory);
+        }
+        void TearDown() override
+        {
+            std::filesystem::remove_all(m_directory);
+        }
+
+        file::FileWatcherSettings settings() const
+        {
+            file::FileWatcherSettings settings;
+            settings.debounce = 50ms;
+            settings.force_polling = GetParam();
+            settings.poll_interval = 20ms;
+            return settings;
+        }
+
+        void write(const char* relative_path, const char* contents)
+        {
+            file::write_string_to_absolute((m_directory / relative_path).string().c_str(), contents);
+        }
+
+        std::filesystem::path path(const char* relative_path) const
+        {
+            return (m_directory / relative_path).lexically_normal();
+        }
+
+        std::filesystem::path m_directory;
+    };
+
+    //collects changes until some arrive and then nothing more for a while, or the timeout passes
+    std::vector<std::filesystem::path> wait_for_changes(file::FileWatcher& watcher, std::chrono::milliseconds timeout = 3000ms)
+    {
+        std::vector<std::filesystem::path> changes;
+        auto end = std::chrono::steady_clock::now() + timeout;
+        auto quiet_until = end;
+        while (std::chrono::steady_clock::now() < std::min(end, quiet_until))
+        {
+            auto taken = watcher.take_changes();
+            if (!taken.empty())
+            {
+                changes.insert(changes.end(), taken.begin(), taken.end());
+                quiet_until = std::chrono::steady_clock::now() + 200ms;
+            }
+            std::this_thread::sleep_for(5ms);
+        }
+        return changes;
+    }
+
+    //gives the watcher time to take its first look at the directory
+    void settle()
+    {
+        std::this_thread::sleep_for(100ms);
+    }
+}
+
+TEST_P(FileWatcherTest, ReportsNewFiles)
+{
+    file::FileWatcher watcher(m_directory, settings());
+    if (GetParam())
+    {
+        EXPECT_TRUE(watcher.polling());
+    }
+    settle();
+
+    write("texture.png", "pixels");
+
+    auto changes = wait_for_changes(watcher);
+    ASSERT_EQ(changes.size(), 1u);
+    EXPECT_EQ(changes[0], path("texture.png"));
+}
+
+TEST_P(FileWatcherTest, RepeatedWritesAreReportedOnce)
+{
+    write("level.scene", "0");
+    file::FileWatcher watcher(m_directory, settings());
+    settle();
+
+    for (int i = 0; i < 5; ++i)
+    {
+        write("level.scene", std::to_string(i * 100).c_str());
+        std::this_thread::sleep_for(5ms);
+    }
+
+    auto changes = wait_for_changes(watcher);
+    ASSERT_EQ(changes.size(), 1u);
+    EXPECT_EQ(changes[0], path("level.scene"));
+}
+
+TEST_P(FileWatcherTest, WatchesSubdirectories)
+{
+    std::filesystem::create_directories(m_directory / "existing");
+    file::FileWatcher watcher(m_directory, settings());
+    settle();
+
+    write("existing/a.txt", "a");
+    std::filesystem::create_directories(m_directory / "new");
+    settle();
+    write("new/b.txt", "b");
+
+    auto changes = wait_for_changes(watcher);
+    EXPECT_NE(std::find(changes.begin(), changes.end(), path("existing/a.txt")), changes.end());
+    EXPECT_NE(std::find(changes.begin(), changes.end(), path("new/b.txt")), changes.end());
+}
+
+TEST_P(FileWatcherTest, ReportsRemovedFiles)
+{
+    write("old.txt", "old");
+    file::FileWatcher watcher(m_directory, settings());
+    settle();
+
+    std::filesystem::remove(m_directory / "old.txt");
+
+    auto changes = wait_for_changes(watcher);
+    ASSERT_EQ(changes.size(), 1u);
+    EXPECT_EQ(changes[0], path("old.txt"));
+}
+
+TEST_P(FileWatcherTest, NothingReportedWithoutChanges)
+{
+    write("still.txt", "still");
+    file::FileWatcher watcher(m_directory, settings());
+
+    EXPECT_TRUE(wait_for_changes(watcher, 300ms).empty());
+}
+
+INSTANTIATE_TEST_SUITE_P(, FileWatcherTest, ::testing::Values(false, true), [](auto& info) { return info.param ? "Polling" : "Native"; });
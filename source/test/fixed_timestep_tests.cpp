@@ -0,0 +1,86 @@
+#include "return_engine/fixed_timestep.h"
+#include "return_engine/task_manager.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+TEST(FixedTimestep, CarriesRemainderToNextFrame)
+{
+    re::FixedTimestep timestep(0.01, 5);
+
+    EXPECT_EQ(timestep.advance(0.025), 2);
+    EXPECT_NEAR(timestep.alpha(), 0.5f, 1e-4f);
+
+    EXPECT_EQ(timestep.advance(0.004), 0);
+    EXPECT_NEAR(timestep.alpha(), 0.9f, 1e-4f);
+
+    EXPECT_EQ(timestep.advance(0.001), 1);
+    EXPECT_NEAR(timestep.alpha(), 0.f, 1e-4f);
+}
+
+TEST(FixedTimestep, StepCountMatchesElapsedTime)
+{
+    re::FixedTimestep timestep(1.0 / 60.0, 5);
+
+    //uneven frame times still add up to one step per 60th of a second
+    int steps = 0;
+    const double frames[] = {0.007, 0.013, 0.021, 0.016, 0.033, 0.002};
+    for (int i = 0; i < 100; ++i)
+    {
+        steps += timestep.advance(frames[i % std::size(frames)]);
+    }
+    const double elapsed = (0.007 + 0.013 + 0.021 + 0.016 + 0.033 + 0.002) * 100.0 / 6.0;
+    EXPECT_NEAR(steps, elapsed * 60.0, 1.0);
+}
+
+TEST(FixedTimestep, StallIsCappedAtMaxSteps)
+{
+    re::FixedTimestep timestep(0.01, 4);
+
+    EXPECT_EQ(timestep.advance(10.0), 4);
+    EXPECT_LT(timestep.alpha(), 1.f);
+
+    //the dropped time isn't made up later
+    EXPECT_EQ(timestep.advance(0.01), 1);
+}
+
+TEST(FixedTimestep, NegativeTimeIsIgnored)
+{
+    re::FixedTimestep timestep(0.01, 4);
+
+    EXPECT_EQ(timestep.advance(-1.0), 0);
+    EXPECT_EQ(timestep.alpha(), 0.f);
+}
+
+TEST(TaskManager, FinishTasksWaitsForQueuedAndIndexedTasks)
+{
+    re::TaskManager tasks(3);
+
+    for (int frame = 0; frame < 50; ++frame)
+    {
+        std::atomic<int> single = 0;
+        std::atomic<int> indexed = 0;
+        for (int i = 0; i < 10; ++i)
+        {
+            tasks.add_task([&]() { ++single; });
+        }
+        tasks.add_tasks([&](int i) { indexed += i; }, 0, 100);
+        tasks.finish_tasks();
+
+        ASSERT_EQ(single, 10);
+        ASSERT_EQ(indexed, 4950);
+    }
+}
+
+TEST(TaskManager, RunsTasksWithoutThreads)
+{
+    re::TaskManager tasks;
+
+    int count = 0;
+    tasks.add_task([&]() { ++count; });
+    tasks.add_tasks([&](int) { ++count; }, 0, 5);
+    tasks.finish_tasks();
+
+    EXPECT_EQ(count, 6);
+}
@@ -0,0 +1,202 @@
+#include "editor_support/fuzzy_search.h"
+#include "return_engine/task_manager.h"
+
+#include <gtest/gtest.h>
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    //the full matrix version levenshtein_distance used to be, to check against and time against
+    int reference_distance(const std::string& s1, const std::string& s2)
+    {
+        const size_t columns = s1.size() + 1;
+        std::vector<int> distances(columns * (s2.size() + 1));
+        auto distance = [&](size_t column, size_t row) -> int& { return distances[column + row * columns]; };
+        for (size_t column = 0; column < columns; ++column)
+        {
+            distance(column, 0) = (int)column;
+        }
+        for (size_t row = 0; row <= s2.size(); ++row)
+        {
+            distance(0, row) = (int)row;
+        }
+        for (size_t column = 1; column < columns; ++column)
+        {
+            for (size_t row = 1; row <= s2.size(); ++row)
+            {
+                const bool match = tolower(s1[column - 1]) == tolower(s2[row - 1]);
+                distance(column, row) = std::min({distance(column, row - 1) + 1, distance(column - 1, row) + 1,
+                    distance(column - 1, row - 1) + (match ? 0 : 1)});
+            }
+        }
+        return distances.back();
+    }
+
+    std::string random_string(std::mt19937& random, int max_length)
+    {
+        //small alphabet with both cases so there are plenty of matches
+        static constexpr char c_alphabet[] = "abcdeABCDE_/.";
+        std::uniform_int_distribution<int> length(0, max_length);
+        std::uniform_int_distribution<int> letter(0, (int)sizeof(c_alphabet) - 2);
+        std::string result(length(random), ' ');
+        for (auto& c : result)
+        {
+            c = c_alphabet[letter(random)];
+        }
+        return result;
+    }
+
+    //paths like a project's data folder
+    std::vector<std::string> make_paths(int count)
+    {
+        static const char* c_folders[] = {"models", "textures", "shaders", "scenes", "sounds", "levels", "ui", "props"};
+        static const char* c_words[] = {"rock", "tree", "player", "enemy", "light", "wall", "floor", "door", "crate", "barrel", "grass", "water"};
+        static const char* c_extensions[] = {".obj", ".png", ".vert", ".frag", ".scene", ".wav"};
+        std::mt19937 random{42};
+        std::vector<std::string> paths;
+        for (int i = 0; i < count; ++i)
+        {
+            std::string path = c_folders[random() % 8];
+            path += "/";
+            path += c_folders[random() % 8];
+            path += "/";
+            path += c_words[random() % 12];
+            path += "_";
+            path += c_words[random() % 12];
+            path += std::to_string(random() % 100);
+            path += c_extensions[random() % 6];
+            paths.push_back(std::move(path));
+        }
+        return paths;
+    }
+
+    double seconds_since(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+TEST(FuzzySearch, DistanceMatchesReference)
+{
+    std::mt19937 random{1};
+    for (int test = 0; test < 2000; ++test)
+    {
+        //terms past 64 characters take the two row path
+        const auto term = random_string(random, test % 10 == 0 ? 100 : 20);
+        const auto text = random_string(random, 40);
+        const int expected = reference_distance(text, term);
+
+        re::FuzzyMatcher matcher(term);
+        ASSERT_EQ(matcher.distance(text), expected) << text << " / " << term;
+        ASSERT_EQ((int)re::levenshtein_distance(text.c_str(), term.c_str()), expected);
+
+        //capped distances are exact up to the cap and only say they're over it beyond
+        const int cap = test % 8;
+        const int capped = matcher.distance(text, cap);
+        if (expected <= cap)
+        {
+            ASSERT_EQ(capped, expected);
+        }
+        else
+        {
+            ASSERT_EQ(capped, cap + 1);
+        }
+    }
+}
+
+TEST(FuzzySearch, ScoreIgnoresCase)
+{
+    re::FuzzyMatcher matcher("Scene");
+    EXPECT_FLOAT_EQ(matcher.score("level.SCENE"), 1.f - 5.f / 11.f);
+    EXPECT_FLOAT_EQ(matcher.score("scene"), 0.f);
+    EXPECT_FLOAT_EQ(matcher.score("scone"), 1.f);
+
+    //matches the old scoring where that was already case insensitive
+    EXPECT_FLOAT_EQ(re::FuzzyMatcher("scene").score("level.scene"), re::adjusted_levenshtein_distance("level.scene", "scene"));
+    EXPECT_FLOAT_EQ(matcher.score("cones"), re::adjusted_levenshtein_distance("cones", "Scene"));
+
+    //far away texts are cut off
+    EXPECT_EQ(matcher.score("textures/brick_wall_normal.png", 3.f), INFINITY);
+    EXPECT_FLOAT_EQ(matcher.score("scenes", 3.f), 1.f - 5.f / 6.f);
+}
+
+TEST(FuzzySearch, ScoreAllOnTasksMatchesSerial)
+{
+    const auto paths = make_paths(10000);
+    std::vector<std::string_view> texts(paths.begin(), paths.end());
+    re::FuzzyMatcher matcher("plyr_wal");
+
+    std::vector<float> serial;
+    matcher.score_all(texts, serial);
+    ASSERT_EQ(serial.size(), paths.size());
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_FLOAT_EQ(serial[i], matcher.score(paths[i]));
+    }
+
+    re::TaskManager tasks(3);
+    std::vector<float> parallel;
+    matcher.score_all(texts, parallel, INFINITY, [&tasks](int count, const std::function<void(int)>& task)
+    {
+        tasks.run_tasks(task, 0, count);
+    });
+    EXPECT_EQ(parallel, serial);
+}
+
+TEST(FuzzySearch, DISABLED_Benchmark)
+{
+    constexpr int count = 100000;
+    const auto paths = make_paths(count);
+    std::vector<std::string_view> texts(paths.begin(), paths.end());
+    const char* term = "player_door";
+
+    auto start = std::chrono::steady_clock::now();
+    int reference_sum = 0;
+    for (auto& path : paths)
+    {
+        reference_sum += reference_distance(path, term);
+    }
+    const double reference_seconds = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    float two_row_sum = 0.f;
+    for (auto& path : paths)
+    {
+        two_row_sum += re::levenshtein_distance(path.c_str(), term);
+    }
+    const double two_row_seconds = seconds_since(start);
+
+    re::FuzzyMatcher matcher(term);
+    start = std::chrono::steady_clock::now();
+    int myers_sum = 0;
+    for (auto& path : paths)
+    {
+        myers_sum += matcher.distance(path);
+    }
+    const double myers_seconds = seconds_since(start);
+
+    std::vector<float> scores;
+    start = std::chrono::steady_clock::now();
+    matcher.score_all(texts, scores, 8.f);
+    const double capped_seconds = seconds_since(start);
+
+    re::TaskManager tasks(std::max(1, (int)std::thread::hardware_concurrency() - 1));
+    start = std::chrono::steady_clock::now();
+    matcher.score_all(texts, scores, 8.f, [&tasks](int task_count, const std::function<void(int)>& task)
+    {
+        tasks.run_tasks(task, 0, task_count);
+    });
+    const double parallel_seconds = seconds_since(start);
+
+    std::printf("%d paths, per path: full matrix %.0f ns, two rows %.0f ns, bit parallel %.0f ns\n",
+        count, 1e9 * reference_seconds / count, 1e9 * two_row_seconds / count, 1e9 * myers_seconds / count);
+    std::printf("score_all capped at 8: %.2f ms, on %d workers %.2f ms\n", 1e3 * capped_seconds, tasks.thread_count(), 1e3 * parallel_seconds);
+    EXPECT_EQ(reference_sum, myers_sum);
+    EXPECT_EQ((float)reference_sum, two_row_sum);
+}
@@ -0,0 +1,133 @@
+#include "gfx/batch_renderer.h"
+#include "gfx/debug_lines.h"
+#include "gfx/element_buffer.h"
+#include "gfx/gl_recorder.h"
+#include "gfx/shader.h"
+#include "gfx/vertex_array_object.h"
+#include "gfx/vertex_buffer.h"
+
+#include "maths/maths.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+
+namespace
+{
+    int count_commands(const gfx::GLRecorder& recorder, gfx::GLCommandType type)
+    {
+        auto& commands = recorder.commands();
+        return (int)std::count_if(commands.begin(), commands.end(), [type](auto& command) { return command.type == type; });
+    }
+
+    struct TestMesh
+    {
+        maths::Vector3 vertices[3] = { {0.f, 0.f, 0.f}, {1.f, 0.f, 0.f}, {0.f, 1.f, 0.f} };
+        gfx::VertexBuffer vertex_buffer{vertices, 3, {gfx::BufferAttributeType::Translation}};
+        gfx::VertexArray vertex_array{vertex_buffer, nullptr, gfx::PrimitiveType::Triangle};
+        gfx::VertexShader vertex_shader{"vertex"};
+        gfx::FragmentShader fragment_shader{"fragment"};
+        gfx::ShaderProgram program{vertex_shader, fragment_shader};
+    };
+}
+
+TEST(GLRecorder, VertexBufferUploadIsMeasured)
+{
+    gfx::GLRecorder recorder;
+    maths::Vector3 vertices[4] = {};
+    gfx::VertexBuffer buffer(vertices, 4, {gfx::BufferAttributeType::Translation});
+
+    EXPECT_EQ(recorder.stats().bytes_uploaded, sizeof(vertices));
+    EXPECT_EQ(recorder.stats().objects_created, 1);
+    EXPECT_EQ(count_commands(recorder, gfx::GLCommandType::BufferUpload), 1);
+}
+
+TEST(GLRecorder, BatchRendererDrawsEachBatchOnce)
+{
+    gfx::GLRecorder recorder;
+    TestMesh mesh;
+    gfx::BatchRenderer renderer;
+    for(int i = 0; i < 10; ++i)
+    {
+        renderer.add_instance(mesh.vertex_array, mesh.program, nullptr, maths::Matrix44::identity());
+    }
+
+    recorder.begin_frame();
+    renderer.draw_all(0.f, maths::Matrix44::identity(), maths::Matrix44::identity());
+
+    EXPECT_EQ(recorder.stats().draw_calls, 1);
+    EXPECT_EQ(recorder.stats().instances, 10);
+    EXPECT_EQ(recorder.stats().bytes_uploaded, 10 * sizeof(maths::Matrix44));
+    EXPECT_EQ(count_commands(recorder, gfx::GLCommandType::UseProgram), 1);
+
+    //the second frame has nothing new to bind except the fresh instance buffer
+    renderer.clear();
+    renderer.add_instance(mesh.vertex_array, mesh.program, nullptr, maths::Matrix44::identity());
+    recorder.begin_frame();
+    renderer.draw_all(0.f, maths::Matrix44::identity(), maths::Matrix44::identity());
+
+    EXPECT_EQ(recorder.stats().draw_calls, 1);
+    EXPECT_EQ(count_commands(recorder, gfx::GLCommandType::UseProgram), 0);
+    EXPECT_EQ(count_commands(recorder, gfx::GLCommandType::BindVertexArray), 0);
+}
+
+TEST(GLRecorder, IndexedDrawUsesElementCount)
+{
+    gfx::GLRecorder recorder;
+    maths::Vector3 vertices[4] = {};
+    unsigned indices[6] = { 0, 1, 2, 0, 2, 3 };
+    gfx::VertexBuffer vertex_buffer(vertices, 4, {gfx::BufferAttributeType::Translation});
+    gfx::ElementBuffer element_buffer(indices, 6);
+    gfx::VertexArray vertex_array(vertex_buffer, &element_buffer, gfx::PrimitiveType::Triangle);
+
+    recorder.begin_frame();
+    vertex_array.draw();
+
+    ASSERT_EQ(recorder.stats().draw_calls, 1);
+    EXPECT_EQ(recorder.commands().back().type, gfx::GLCommandType::Draw);
+    EXPECT_EQ(recorder.commands().back().object, 6u);
+}
+
+TEST(GLRecorder, DebugLinesCreateAndDestroyTheirBuffers)
+{
+    gfx::GLRecorder recorder;
+    gfx::draw_cube(maths::Matrix44::identity(), maths::Vector3::one(), maths::Matrix44::identity(), {1.f, 0.f, 0.f});
+
+    //first use also compiles the debug lines program
+    recorder.begin_frame();
+    gfx::draw_cube(maths::Matrix44::identity(), maths::Vector3::one(), maths::Matrix44::identity(), {1.f, 0.f, 0.f});
+
+    EXPECT_EQ(recorder.stats().draw_calls, 1);
+    EXPECT_EQ(recorder.stats().bytes_uploaded, 24 * sizeof(maths::Vector3));
+    EXPECT_EQ(recorder.stats().objects_created, recorder.stats().objects_deleted);
+}
+
+TEST(GLRecorder, FailureLogsReachEveryPoll)
+{
+    gfx::GLRecorder recorder;
+    recorder.failure_log = "0:1: syntax error";
+    gfx::VertexShader vertex_shader{"vertex"};
+    gfx::FragmentShader fragment_shader{"fragment"};
+    gfx::ShaderProgram program{vertex_shader, fragment_shader};
+
+    //the renderer checks readiness without a log before the editor polls with one
+    EXPECT_FALSE(program.ready());
+    std::string log;
+    EXPECT_EQ(program.poll(&log), gfx::CompileStatus::Failed);
+    EXPECT_EQ(log, "0:1: syntax error");
+    std::string waited_log;
+    EXPECT_EQ(program.wait(&waited_log), gfx::CompileStatus::Failed);
+    EXPECT_EQ(waited_log, log);
+
+    EXPECT_EQ(vertex_shader.poll(), gfx::CompileStatus::Failed);
+    std::string shader_log;
+    EXPECT_EQ(vertex_shader.poll(&shader_log), gfx::CompileStatus::Failed);
+    EXPECT_EQ(shader_log, "0:1: syntax error");
+
+    //moving keeps the log with the program
+    gfx::ShaderProgram moved = std::move(program);
+    std::string moved_log;
+    EXPECT_EQ(moved.poll(&moved_log), gfx::CompileStatus::Failed);
+    EXPECT_EQ(moved_log, log);
+}
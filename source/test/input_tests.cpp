@@ -0,0 +1,240 @@
+#include "return_engine/input_manager.h"
+#include "return_engine/input_recording.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+namespace
+{
+    re::InputEvent key(re::InputEventType type, re::Key key, double time = 0.0)
+    {
+        return {type, (int)key, {0.f, 0.f}, time};
+    }
+
+    re::InputEvent button(re::InputEventType type, re::MouseButton button, double time = 0.0)
+    {
+        return {type, (int)button, {0.f, 0.f}, time};
+    }
+
+    re::InputEvent move(float x, float y, double time = 0.0)
+    {
+        return {re::InputEventType::CursorMove, 0, {x, y}, time};
+    }
+}
+
+TEST(Input, EdgesLastOneFrame)
+{
+    re::InputManager input;
+    input.push_event(key(re::InputEventType::KeyDown, re::Key::W));
+    input.update();
+    EXPECT_TRUE(input.snapshot().pressed(re::Key::W));
+    EXPECT_TRUE(input.snapshot().down(re::Key::W));
+    EXPECT_TRUE(input.get_key(re::Key::W));
+    EXPECT_FALSE(input.snapshot().released(re::Key::W));
+
+    //held, no new edge
+    input.update();
+    EXPECT_FALSE(input.snapshot().pressed(re::Key::W));
+    EXPECT_TRUE(input.snapshot().down(re::Key::W));
+
+    input.push_event(key(re::InputEventType::KeyUp, re::Key::W));
+    input.update();
+    EXPECT_TRUE(input.snapshot().released(re::Key::W));
+    EXPECT_FALSE(input.snapshot().down(re::Key::W));
+    EXPECT_FALSE(input.get_key(re::Key::A));
+}
+
+TEST(Input, TapWithinAFrameIsntLost)
+{
+    //polling at the end of the frame would never have seen these
+    re::InputManager input;
+    input.push_event(key(re::InputEventType::KeyDown, re::Key::F, 0.001));
+    input.push_event(key(re::InputEventType::KeyUp, re::Key::F, 0.004));
+    input.push_event(button(re::InputEventType::MouseDown, re::MouseButton::Left, 0.005));
+    input.push_event(button(re::InputEventType::MouseUp, re::MouseButton::Left, 0.006));
+    input.update();
+
+    const auto& snapshot = input.snapshot();
+    EXPECT_TRUE(snapshot.pressed(re::Key::F));
+    EXPECT_TRUE(snapshot.released(re::Key::F));
+    EXPECT_FALSE(snapshot.down(re::Key::F));
+    EXPECT_TRUE(snapshot.pressed(re::MouseButton::Left));
+    EXPECT_FALSE(snapshot.down(re::MouseButton::Left));
+}
+
+TEST(Input, CursorMovesAddUp)
+{
+    re::InputManager input;
+    input.push_event(move(10.f, 20.f));
+    input.update();
+    input.push_event(move(12.f, 25.f));
+    input.push_event(move(15.f, 21.f));
+    input.update();
+    EXPECT_EQ(input.mouse_pos(), (maths::Vector2{15.f, 21.f}));
+    EXPECT_EQ(input.mouse_delta(), (maths::Vector2{5.f, 1.f}));
+
+    input.update();
+    EXPECT_EQ(input.mouse_delta(), maths::Vector2::zero());
+}
+
+TEST(Input, OverflowingTheQueueKeepsEveryEvent)
+{
+    //many more events than the ring holds in one frame
+    re::InputManager input;
+    for (int i = 0; i < 1000; ++i)
+    {
+        input.push_event(key(i % 2 ? re::InputEventType::KeyUp : re::InputEventType::KeyDown, re::Key::Q));
+        input.push_event(move((float)i, 0.f));
+    }
+    input.push_event(key(re::InputEventType::KeyDown, re::Key::Z));
+    input.update();
+
+    const auto& snapshot = input.snapshot();
+    EXPECT_TRUE(snapshot.pressed(re::Key::Q));
+    EXPECT_TRUE(snapshot.released(re::Key::Q));
+    EXPECT_FALSE(snapshot.down(re::Key::Q));
+    EXPECT_TRUE(snapshot.down(re::Key::Z));
+    EXPECT_EQ(snapshot.mouse_delta(), (maths::Vector2{999.f, 0.f}));
+}
+
+TEST(Input, SnapshotsMergeUntilConsumed)
+{
+    //what the simulation sees when frames go by without a step
+    re::InputManager input;
+    re::InputSnapshot sim;
+
+    input.push_event(key(re::InputEventType::KeyDown, re::Key::E));
+    input.push_event(move(3.f, 4.f));
+    input.update();
+    sim.merge(input.snapshot());
+
+    input.push_event(key(re::InputEventType::KeyUp, re::Key::E));
+    input.push_event(move(4.f, 4.f));
+    input.update();
+    sim.merge(input.snapshot());
+
+    EXPECT_TRUE(sim.pressed(re::Key::E));
+    EXPECT_TRUE(sim.released(re::Key::E));
+    EXPECT_FALSE(sim.down(re::Key::E));
+    EXPECT_EQ(sim.mouse_delta(), (maths::Vector2{4.f, 4.f}));
+
+    sim.clear_edges();
+    EXPECT_FALSE(sim.pressed(re::Key::E));
+    EXPECT_EQ(sim.mouse_delta(), maths::Vector2::zero());
+    EXPECT_EQ(sim.mouse_pos(), (maths::Vector2{4.f, 4.f}));
+}
+
+TEST(Input, RecordingPlaysBackFrameForFrame)
+{
+    const auto path = std::filesystem::temp_directory_path() / "return_input_tests" / "recording.input";
+    std::vector<re::InputSnapshot> recorded;
+    std::vector<float> dts;
+    {
+        re::InputManager input;
+        re::InputRecorder recorder(path);
+        ASSERT_TRUE(recorder.valid());
+        for (int frame = 0; frame < 100; ++frame)
+        {
+            //held for a while, with a tap and the right button dragging now and then
+            if (frame == 10) input.push_event(key(re::InputEventType::KeyDown, re::Key::W));
+            if (frame == 60) input.push_event(key(re::InputEventType::KeyUp, re::Key::W));
+            if (frame % 7 == 0)
+            {
+                input.push_event(key(re::InputEventType::KeyDown, re::Key::E));
+                input.push_event(key(re::InputEventType::KeyUp, re::Key::E));
+            }
+            input.push_event(button(frame % 20 < 10 ? re::InputEventType::MouseDown : re::InputEventType::MouseUp, re::MouseButton::Right));
+            input.push_event(move((float)frame, 0.5f * frame));
+            input.update();
+
+            const float dt = 1.f / 60.f + 0.001f * (frame % 5);
+            recorder.record(dt, input.snapshot());
+            recorded.push_back(input.snapshot());
+            dts.push_back(dt);
+        }
+        EXPECT_EQ(recorder.frame_count(), 100);
+    }
+
+    re::InputPlayback playback(path);
+    ASSERT_TRUE(playback.valid());
+    ASSERT_EQ(playback.frame_count(), 100);
+    re::InputManager replayed;
+    for (int frame = 0; frame < 100; ++frame)
+    {
+        auto* played = playback.next();
+        ASSERT_TRUE(played);
+        replayed.replay(played->input);
+        EXPECT_EQ(played->dt, dts[frame]);
+
+        const auto& expected = recorded[frame];
+        const auto& actual = replayed.snapshot();
+        for (auto k : {re::Key::W, re::Key::E, re::Key::A})
+        {
+            EXPECT_EQ(actual.down(k), expected.down(k)) << frame;
+            EXPECT_EQ(actual.pressed(k), expected.pressed(k)) << frame;
+            EXPECT_EQ(actual.released(k), expected.released(k)) << frame;
+        }
+        EXPECT_EQ(actual.down(re::MouseButton::Right), expected.down(re::MouseButton::Right)) << frame;
+        EXPECT_EQ(actual.pressed(re::MouseButton::Right), expected.pressed(re::MouseButton::Right)) << frame;
+        EXPECT_EQ(actual.mouse_pos(), expected.mouse_pos()) << frame;
+        EXPECT_EQ(actual.mouse_delta(), expected.mouse_delta()) << frame;
+    }
+    EXPECT_EQ(playback.next(), nullptr);
+
+    //anything else isn't taken for a recording
+    std::filesystem::remove(path);
+    EXPECT_FALSE(re::InputPlayback(path).valid());
+}
+
+TEST(Input, FrameTimeSummary)
+{
+    //one slow frame in a hundred doesn't show in the 99th percentile, two do
+    std::vector<float> frames(100, 0.010f);
+    frames[3] = 0.005f;
+    frames[50] = 0.100f;
+    auto summary = re::summarize_frame_times(frames);
+    EXPECT_EQ(summary.count, 100);
+    EXPECT_FLOAT_EQ(summary.min, 0.005f);
+    EXPECT_FLOAT_EQ(summary.average, (98 * 0.010f + 0.005f + 0.100f) / 100.f);
+    EXPECT_FLOAT_EQ(summary.p99, 0.010f);
+
+    //summarizing reorders them
+    frames.assign(100, 0.010f);
+    frames[50] = 0.100f;
+    frames[70] = 0.050f;
+    EXPECT_FLOAT_EQ(re::summarize_frame_times(frames).p99, 0.050f);
+    std::vector<float> none;
+    EXPECT_EQ(re::summarize_frame_times(none).count, 0);
+}
+
+TEST(RingBuffer, WrapsAndRefusesWhenFull)
+{
+    re::RingBuffer<int, 4> ring;
+    int next_in = 0;
+    int next_out = 0;
+    //three in two out, so the front walks round the storage
+    for (int round = 0; round < 3; ++round)
+    {
+        for (int i = 0; i < 3 && !ring.full(); ++i)
+        {
+            EXPECT_TRUE(ring.push(next_in++));
+        }
+        for (int i = 0; i < 2; ++i)
+        {
+            EXPECT_EQ(ring.pop(), next_out++);
+        }
+    }
+    EXPECT_EQ(ring.count(), next_in - next_out);
+
+    while (ring.push(next_in))
+    {
+        ++next_in;
+    }
+    EXPECT_TRUE(ring.full());
+    while (!ring.empty())
+    {
+        EXPECT_EQ(ring.pop(), next_out++);
+    }
+    EXPECT_EQ(next_out, next_in);
+}
@@ -0,0 +1,111 @@
+#include "return_engine/profiler.h"
+
+#include "gfx/gl_recorder.h"
+#include "gfx/gpu_timer.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+    const re::ProfileZone* find_zone(const re::ProfilerFrame& frame, const char* name)
+    {
+        auto it = std::find_if(frame.zones.begin(), frame.zones.end(), [name](auto& zone) { return std::strcmp(zone.name, name) == 0; });
+        return it == frame.zones.end() ? nullptr : &*it;
+    }
+}
+
+TEST(Profiler, NestedZonesRecordDepth)
+{
+    re::profiler_next_frame();
+    {
+        PROFILE_SCOPE("Outer");
+        {
+            PROFILE_SCOPE("Inner");
+        }
+    }
+    re::profiler_next_frame();
+
+    auto& frame = re::profiler_history().back();
+    auto* outer = find_zone(frame, "Outer");
+    auto* inner = find_zone(frame, "Inner");
+    ASSERT_NE(outer, nullptr);
+    ASSERT_NE(inner, nullptr);
+    EXPECT_EQ(outer->depth, 0);
+    EXPECT_EQ(inner->depth, 1);
+    EXPECT_LE(outer->start_ns, inner->start_ns);
+    EXPECT_GE(outer->end_ns, inner->end_ns);
+    EXPECT_LE(frame.start_ns, outer->start_ns);
+    EXPECT_GE(frame.end_ns, outer->end_ns);
+}
+
+TEST(Profiler, ZonesAreOnlyCollectedOnce)
+{
+    re::profiler_next_frame();
+    {
+        PROFILE_SCOPE("Once");
+    }
+    re::profiler_next_frame();
+    re::profiler_next_frame();
+
+    auto& history = re::profiler_history();
+    ASSERT_GE(history.size(), 2u);
+    EXPECT_NE(find_zone(history[history.size() - 2], "Once"), nullptr);
+    EXPECT_EQ(find_zone(history.back(), "Once"), nullptr);
+}
+
+TEST(Profiler, ZonesFromOtherThreadsAreGathered)
+{
+    re::profiler_next_frame();
+    std::thread worker([]()
+    {
+        re::profiler_set_thread_name("Worker");
+        PROFILE_SCOPE("Worker zone");
+    });
+    worker.join();
+    re::profiler_next_frame();
+
+    auto* zone = find_zone(re::profiler_history().back(), "Worker zone");
+    ASSERT_NE(zone, nullptr);
+    EXPECT_EQ(zone->depth, 0);
+    EXPECT_EQ(re::profiler_thread_names()[zone->thread], "Worker");
+}
+
+TEST(Profiler, ChromeTraceContainsEveryZone)
+{
+    re::ProfilerFrame frame;
+    frame.start_ns = 1000000;
+    frame.end_ns = 3000000;
+    frame.zones.push_back({"Update", 1000000, 2000000, 0, 0});
+    frame.zones.push_back({"Quote \"zone\"", 1500000, 1600000, 0, 1});
+    frame.gpu_zones.push_back({"Draw", 0.0005});
+
+    auto json = re::chrome_trace_json({frame}, {"Main"});
+
+    EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Main\"}}"), std::string::npos);
+    EXPECT_NE(json.find("{\"name\":\"Update\",\"cat\":\"cpu\",\"ph\":\"X\",\"ts\":0.000,\"dur\":1000.000,\"pid\":1,\"tid\":0}"), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"Quote \\\"zone\\\"\""), std::string::npos);
+    EXPECT_NE(json.find("{\"name\":\"Draw\",\"cat\":\"gpu\",\"ph\":\"X\",\"ts\":0.000,\"dur\":500.000,\"pid\":1,\"tid\":2}"), std::string::npos);
+    EXPECT_NE(json.find("{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":0.000,\"dur\":2000.000,\"pid\":1,\"tid\":1}"), std::string::npos);
+}
+
+TEST(GpuTimer, ResultsAreReadBackWithoutWaiting)
+{
+    gfx::GLRecorder recorder;
+    gfx::GpuTimer timer;
+
+    //each query's result is only read the next time it is reused, two frames later
+    timer.begin();
+    timer.end();
+    timer.begin();
+    timer.end();
+    EXPECT_LT(timer.seconds(), 0.0);
+
+    timer.begin();
+    timer.end();
+    EXPECT_DOUBLE_EQ(timer.seconds(), 0.001);
+}
@@ -0,0 +1,143 @@
+#include "return_engine/containers.h"
+#include "return_engine/render_packet.h"
+
+#include "gfx/batch_renderer.h"
+#include "gfx/gl_recorder.h"
+#include "gfx/graphics_manager.h"
+#include "gfx/shader.h"
+#include "gfx/vertex_array_object.h"
+#include "gfx/vertex_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace
+{
+    maths::Matrix44 translation(float x)
+    {
+        return maths::Matrix44::from_translation({x, 0.f, 0.f});
+    }
+}
+
+TEST(TripleBuffer, ReaderKeepsBufferUntilSomethingIsPublished)
+{
+    re::TripleBuffer<int> buffer;
+    buffer.read_buffer() = -1;
+    EXPECT_FALSE(buffer.take_latest());
+    EXPECT_EQ(buffer.read_buffer(), -1);
+
+    buffer.write_buffer() = 1;
+    buffer.publish();
+    buffer.write_buffer() = 2;
+    buffer.publish();
+
+    //only the latest is seen
+    EXPECT_TRUE(buffer.take_latest());
+    EXPECT_EQ(buffer.read_buffer(), 2);
+    EXPECT_FALSE(buffer.take_latest());
+    EXPECT_EQ(buffer.read_buffer(), 2);
+}
+
+TEST(TripleBuffer, ValuesArriveWholeAndInOrderAcrossThreads)
+{
+    struct Value
+    {
+        int a = 0;
+        int b = 0;
+    };
+    re::TripleBuffer<Value> buffer;
+    constexpr int count = 200000;
+
+    std::thread writer([&]()
+    {
+        for (int i = 1; i <= count; ++i)
+        {
+            auto& value = buffer.write_buffer();
+            value.a = i;
+            value.b = -i;
+            buffer.publish();
+        }
+    });
+
+    int last = 0;
+    while (last < count)
+    {
+        if (buffer.take_latest())
+        {
+            auto& value = buffer.read_buffer();
+            ASSERT_EQ(value.a, -value.b);
+            ASSERT_GT(value.a, last);
+            last = value.a;
+        }
+    }
+    writer.join();
+}
+
+TEST(RenderPacket, InstancesAreGroupedIntoBatches)
+{
+    using ProgramHandle = gfx::Handle<gfx::ShaderProgram>;
+    using VaoHandle = gfx::Handle<gfx::VertexArray>;
+    using TextureHandle = gfx::Handle<gfx::Texture>;
+
+    re::RenderPacket packet;
+    packet.add_instance(ProgramHandle{0, 0}, VaoHandle{0, 0}, TextureHandle{}, translation(0.f));
+    packet.add_instance(ProgramHandle{1, 0}, VaoHandle{0, 0}, TextureHandle{}, translation(1.f));
+    packet.add_instance(ProgramHandle{0, 0}, VaoHandle{0, 0}, TextureHandle{}, translation(2.f));
+    packet.add_instance(ProgramHandle{0, 0}, VaoHandle{1, 0}, TextureHandle{}, translation(3.f));
+    packet.add_instance(ProgramHandle{1, 0}, VaoHandle{0, 0}, TextureHandle{}, translation(4.f));
+    packet.finish();
+
+    auto& batches = packet.batches();
+    ASSERT_EQ(batches.size(), 3u);
+    EXPECT_EQ(batches[0].count, 2);
+    EXPECT_EQ(batches[1].count, 1);
+    EXPECT_EQ(batches[2].count, 2);
+
+    //transforms of a batch are contiguous and keep the order they were added in
+    auto& transforms = packet.transforms();
+    EXPECT_EQ(transforms[batches[0].first + 0].translation().x, 0.f);
+    EXPECT_EQ(transforms[batches[0].first + 1].translation().x, 2.f);
+    EXPECT_EQ(transforms[batches[1].first].translation().x, 3.f);
+    EXPECT_EQ(transforms[batches[2].first + 0].translation().x, 1.f);
+    EXPECT_EQ(transforms[batches[2].first + 1].translation().x, 4.f);
+
+    packet.clear();
+    packet.finish();
+    EXPECT_TRUE(packet.batches().empty());
+}
+
+TEST(RenderPacket, DrawSkipsResourcesThatNoLongerExist)
+{
+    gfx::GLRecorder recorder;
+    gfx::GraphicsManager manager;
+
+    maths::Vector3 vertices[3] = {};
+    gfx::VertexBuffer vertex_buffer(vertices, 3, {gfx::BufferAttributeType::Translation});
+    gfx::VertexShader vertex_shader("vertex");
+    gfx::FragmentShader fragment_shader("fragment");
+    auto vao = manager.add("vao", std::make_unique<gfx::VertexArray>(vertex_buffer, nullptr, gfx::PrimitiveType::Triangle));
+    auto program = manager.add("program", std::make_unique<gfx::ShaderProgram>(vertex_shader, fragment_shader));
+    auto removed = manager.add("removed", std::make_unique<gfx::ShaderProgram>(vertex_shader, fragment_shader));
+
+    re::RenderPacket packet;
+    for (int i = 0; i < 5; ++i)
+    {
+        packet.add_instance(program, vao, {}, translation((float)i));
+        packet.add_instance(removed, vao, {}, translation((float)i));
+    }
+    packet.finish();
+
+    //recompiling without "removed" between building and drawing the packet
+    manager.clear();
+    manager.add("vao", std::make_unique<gfx::VertexArray>(vertex_buffer, nullptr, gfx::PrimitiveType::Triangle));
+    manager.add("program", std::make_unique<gfx::ShaderProgram>(vertex_shader, fragment_shader));
+    manager.remove_empty();
+
+    gfx::BatchRenderer renderer;
+    recorder.begin_frame();
+    re::draw_render_packet(packet, manager, renderer);
+
+    EXPECT_EQ(recorder.stats().draw_calls, 1);
+    EXPECT_EQ(recorder.stats().instances, 5);
+}
@@ -0,0 +1,130 @@
+#include "gfx/render_state.h"
+
+#include "glad/glad.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+//replaces the glad function pointers so the state tracker can be tested without a context
+
+namespace
+{
+    struct MockCall
+    {
+        const char* function;
+        GLuint a;
+        GLuint b;
+    };
+    std::vector<MockCall> g_calls;
+
+    class RenderStateTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            m_use_program = glad_glUseProgram;
+            m_bind_vertex_array = glad_glBindVertexArray;
+            m_active_texture = glad_glActiveTexture;
+            m_bind_texture = glad_glBindTexture;
+            m_bind_buffer = glad_glBindBuffer;
+
+            glad_glUseProgram = [](GLuint program) { g_calls.push_back({"UseProgram", program, 0}); };
+            glad_glBindVertexArray = [](GLuint vao) { g_calls.push_back({"BindVertexArray", vao, 0}); };
+            glad_glActiveTexture = [](GLenum unit) { g_calls.push_back({"ActiveTexture", unit, 0}); };
+            glad_glBindTexture = [](GLenum target, GLuint texture) { g_calls.push_back({"BindTexture", target, texture}); };
+            glad_glBindBuffer = [](GLenum target, GLuint buffer) { g_calls.push_back({"BindBuffer", target, buffer}); };
+
+            g_calls.clear();
+            gfx::invalidate_render_state();
+            gfx::begin_render_state_frame();
+        }
+
+        void TearDown() override
+        {
+            glad_glUseProgram = m_use_program;
+            glad_glBindVertexArray = m_bind_vertex_array;
+            glad_glActiveTexture = m_active_texture;
+            glad_glBindTexture = m_bind_texture;
+            glad_glBindBuffer = m_bind_buffer;
+        }
+
+    private:
+        PFNGLUSEPROGRAMPROC m_use_program;
+        PFNGLBINDVERTEXARRAYPROC m_bind_vertex_array;
+        PFNGLACTIVETEXTUREPROC m_active_texture;
+        PFNGLBINDTEXTUREPROC m_bind_texture;
+        PFNGLBINDBUFFERPROC m_bind_buffer;
+    };
+}
+
+TEST_F(RenderStateTest, RedundantBindsAreSkipped)
+{
+    gfx::bind_program(3);
+    gfx::bind_program(3);
+    gfx::bind_vertex_array(5);
+    gfx::bind_vertex_array(5);
+    gfx::bind_vertex_array(5);
+
+    ASSERT_EQ(g_calls.size(), 2u);
+    EXPECT_STREQ(g_calls[0].function, "UseProgram");
+    EXPECT_STREQ(g_calls[1].function, "BindVertexArray");
+    EXPECT_EQ(gfx::render_state_counters().issued, 2);
+    EXPECT_EQ(gfx::render_state_counters().skipped, 3);
+}
+
+TEST_F(RenderStateTest, TexturesAreTrackedPerUnit)
+{
+    gfx::bind_texture(0, 7);
+    gfx::bind_texture(1, 7);
+    gfx::bind_texture(0, 7);
+    gfx::bind_texture(1, 8);
+
+    //active texture is only switched when the unit changes
+    ASSERT_EQ(g_calls.size(), 5u);
+    EXPECT_STREQ(g_calls[0].function, "ActiveTexture");
+    EXPECT_EQ(g_calls[0].a, (GLuint)GL_TEXTURE0);
+    EXPECT_STREQ(g_calls[2].function, "ActiveTexture");
+    EXPECT_EQ(g_calls[2].a, (GLuint)GL_TEXTURE1);
+    EXPECT_STREQ(g_calls[4].function, "BindTexture");
+    EXPECT_EQ(g_calls[4].b, 8u);
+    EXPECT_EQ(gfx::render_state_counters().skipped, 1);
+}
+
+TEST_F(RenderStateTest, ElementBufferIsForgottenWhenVertexArrayChanges)
+{
+    gfx::bind_vertex_array(1);
+    gfx::bind_buffer(gfx::BufferTarget::Element, 4);
+    gfx::bind_buffer(gfx::BufferTarget::Array, 9);
+    gfx::bind_vertex_array(2);
+    gfx::bind_buffer(gfx::BufferTarget::Element, 4);
+    gfx::bind_buffer(gfx::BufferTarget::Array, 9);
+
+    ASSERT_EQ(g_calls.size(), 5u);
+    EXPECT_STREQ(g_calls[4].function, "BindBuffer");
+    EXPECT_EQ(g_calls[4].a, (GLuint)GL_ELEMENT_ARRAY_BUFFER);
+}
+
+TEST_F(RenderStateTest, DeletedObjectsAreRebound)
+{
+    gfx::bind_texture(0, 7);
+    gfx::forget_texture(7);
+    gfx::bind_texture(0, 7);
+    gfx::bind_program(2);
+    gfx::forget_program(2);
+    gfx::bind_program(2);
+
+    EXPECT_EQ(gfx::render_state_counters().skipped, 0);
+}
+
+TEST_F(RenderStateTest, CountersAreKeptPerFrame)
+{
+    gfx::bind_program(1);
+    gfx::bind_program(1);
+    gfx::begin_render_state_frame();
+
+    EXPECT_EQ(gfx::last_frame_render_state_counters().issued, 1);
+    EXPECT_EQ(gfx::last_frame_render_state_counters().skipped, 1);
+    EXPECT_EQ(gfx::render_state_counters().issued, 0);
+    EXPECT_EQ(gfx::render_state_counters().skipped, 0);
+}
@@ -0,0 +1,61 @@
+#include "gfx/resource_slots.h"
+
+#include <gtest/gtest.h>
+
+TEST(ResourceSlots, HandlesResolveToTheirObject)
+{
+    gfx::ResourceSlots<int> slots;
+    auto a = slots.add("a", std::make_unique<int>(1));
+    auto b = slots.add("b", std::make_unique<int>(2));
+
+    ASSERT_NE(slots.get(a), nullptr);
+    ASSERT_NE(slots.get(b), nullptr);
+    EXPECT_EQ(*slots.get(a), 1);
+    EXPECT_EQ(*slots.get(b), 2);
+    EXPECT_EQ(slots.find("b"), b);
+    EXPECT_EQ(slots.name(a), "a");
+    EXPECT_EQ(slots.find("c"), gfx::Handle<int>());
+    EXPECT_EQ(slots.get(gfx::Handle<int>()), nullptr);
+}
+
+TEST(ResourceSlots, FirstObjectAddedUnderANameIsKept)
+{
+    gfx::ResourceSlots<int> slots;
+    auto first = slots.add("a", std::make_unique<int>(1));
+    auto second = slots.add("a", std::make_unique<int>(2));
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(*slots.get(first), 1);
+}
+
+TEST(ResourceSlots, HandlesSurviveClearingAndReadding)
+{
+    gfx::ResourceSlots<int> slots;
+    auto handle = slots.add("a", std::make_unique<int>(1));
+
+    slots.clear_objects();
+    EXPECT_TRUE(slots.valid(handle));
+    EXPECT_EQ(slots.get(handle), nullptr);
+
+    slots.add("a", std::make_unique<int>(2));
+    slots.remove_empty();
+    ASSERT_NE(slots.get(handle), nullptr);
+    EXPECT_EQ(*slots.get(handle), 2);
+}
+
+TEST(ResourceSlots, RemovedHandlesDontResolveToReusedSlots)
+{
+    gfx::ResourceSlots<int> slots;
+    auto old_handle = slots.add("old", std::make_unique<int>(1));
+
+    slots.clear_objects();
+    slots.remove_empty();
+    auto new_handle = slots.add("new", std::make_unique<int>(2));
+
+    EXPECT_EQ(new_handle.index, old_handle.index);
+    EXPECT_FALSE(slots.valid(old_handle));
+    EXPECT_EQ(slots.get(old_handle), nullptr);
+    EXPECT_EQ(*slots.get(new_handle), 2);
+    EXPECT_EQ(slots.find("old"), gfx::Handle<int>());
+    EXPECT_EQ(slots.handle_at(new_handle.index), new_handle);
+}
@@ -0,0 +1,297 @@
+#include "physics/contacts.h"
+#include "physics/rigid_body_world.h"
+#include "physics/spatial_hash.h"
+#include "return_engine/task_manager.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+    constexpr float c_dt = 1.f / 60.f;
+
+    //static floor, 1 thick with its top at y = 0
+    int add_floor(phys::RigidBodyWorld& world, float half_size = 20.f)
+    {
+        return world.add_box({{-half_size, -1.f, -half_size}, {half_size, 0.f, half_size}}, 0.f);
+    }
+
+    //N spheres launched into a walled box holding a stack of cubes
+    void build_launch_scene(phys::RigidBodyWorld& world, int sphere_count, int cubes_per_side)
+    {
+        constexpr float half_size = 10.f;
+        add_floor(world, half_size);
+        world.add_box({{-half_size - 1.f, 0.f, -half_size}, {-half_size, 20.f, half_size}}, 0.f);
+        world.add_box({{half_size, 0.f, -half_size}, {half_size + 1.f, 20.f, half_size}}, 0.f);
+        world.add_box({{-half_size, 0.f, -half_size - 1.f}, {half_size, 20.f, -half_size}}, 0.f);
+        world.add_box({{-half_size, 0.f, half_size}, {half_size, 20.f, half_size + 1.f}}, 0.f);
+
+        for (int x = 0; x < cubes_per_side; ++x)
+        {
+            for (int y = 0; y < cubes_per_side; ++y)
+            {
+                for (int z = 0; z < cubes_per_side; ++z)
+                {
+                    const maths::Vector3 min = {(float)x - 0.5f * cubes_per_side, (float)y, (float)z - 0.5f * cubes_per_side};
+                    world.add_box({min, min + maths::Vector3::one()}, 1.f);
+                }
+            }
+        }
+
+        for (int i = 0; i < sphere_count; ++i)
+        {
+            const maths::Vector3 pos = {-half_size + 1.f + (float)(i % 5), 2.f + (float)(i / 25), -4.f + 2.f * (float)((i / 5) % 5)};
+            world.add_sphere({pos, 0.4f}, 2.f, {15.f, 2.f, 0.f});
+        }
+    }
+
+    void use_task_manager(phys::RigidBodyWorld& world, re::TaskManager& tasks)
+    {
+        world.set_parallel_for([&tasks](int count, const std::function<void(int)>& task)
+        {
+            tasks.run_tasks(task, 0, count);
+        });
+    }
+
+    template<typename T>
+    bool bitwise_equal(const T& lhs, const T& rhs)
+    {
+        return std::memcmp(&lhs, &rhs, sizeof(T)) == 0;
+    }
+}
+
+TEST(Contacts, SpheresTouchingDontCollide)
+{
+    phys::ContactManifold manifold;
+    EXPECT_FALSE(phys::collide(phys::Sphere{{0.f, 0.f, 0.f}, 1.f}, phys::Sphere{{2.f, 0.f, 0.f}, 1.f}, manifold));
+
+    ASSERT_TRUE(phys::collide(phys::Sphere{{0.f, 0.f, 0.f}, 1.f}, phys::Sphere{{1.5f, 0.f, 0.f}, 1.f}, manifold));
+    EXPECT_EQ(manifold.point_count, 1);
+    EXPECT_EQ(manifold.normal, maths::Vector3::unit_x());
+    EXPECT_FLOAT_EQ(manifold.points[0].penetration, 0.5f);
+    EXPECT_FLOAT_EQ(manifold.points[0].position.x, 0.75f);
+}
+
+TEST(Contacts, SphereInsideBoxLeavesThroughNearestFace)
+{
+    phys::ContactManifold manifold;
+    const phys::AABB3 box = {{-1.f, -1.f, -1.f}, {1.f, 1.f, 1.f}};
+
+    ASSERT_TRUE(phys::collide(phys::Sphere{{0.f, 0.8f, 0.f}, 0.5f}, box, manifold));
+    EXPECT_EQ(manifold.normal, -maths::Vector3::unit_y());
+    EXPECT_FLOAT_EQ(manifold.points[0].penetration, 0.7f);
+
+    //box first flips the normal
+    ASSERT_TRUE(phys::collide(box, phys::Sphere{{0.f, 1.2f, 0.f}, 0.5f}, manifold));
+    EXPECT_EQ(manifold.normal, maths::Vector3::unit_y());
+    EXPECT_NEAR(manifold.points[0].penetration, 0.3f, 1e-6f);
+}
+
+TEST(Contacts, BoxesGiveCornersOfOverlappingFace)
+{
+    phys::ContactManifold manifold;
+    const phys::AABB3 a = {{0.f, 0.f, 0.f}, {2.f, 1.f, 2.f}};
+    const phys::AABB3 b = {{1.f, 0.9f, 1.f}, {3.f, 2.f, 3.f}};
+
+    ASSERT_TRUE(phys::collide(a, b, manifold));
+    EXPECT_EQ(manifold.normal, maths::Vector3::unit_y());
+    ASSERT_EQ(manifold.point_count, 4);
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_NEAR(manifold.points[i].penetration, 0.1f, 1e-6f);
+        EXPECT_NEAR(manifold.points[i].position.y, 0.95f, 1e-6f);
+    }
+
+    //sharing a face only
+    EXPECT_FALSE(phys::collide(a, phys::AABB3{{2.f, 0.f, 0.f}, {3.f, 1.f, 1.f}}, manifold));
+}
+
+TEST(RigidBodyWorld, SphereComesToRestOnFloor)
+{
+    phys::RigidBodyWorld world;
+    add_floor(world);
+    const int sphere = world.add_sphere({{0.f, 3.f, 0.f}, 0.5f}, 1.f);
+
+    for (int i = 0; i < 300; ++i)
+    {
+        world.step(c_dt);
+    }
+
+    EXPECT_NEAR(world.position(sphere).y, 0.5f, world.settings().penetration_slop * 2.f);
+    EXPECT_NEAR(world.velocity(sphere).magnitude(), 0.f, 1e-2f);
+
+    //at rest the warm started impulse is what holds it up against a step of gravity
+    ASSERT_EQ(world.contacts().size(), 1u);
+    EXPECT_NEAR(world.contacts()[0].points[0].normal_impulse, 9.81f * c_dt, 0.05f * 9.81f * c_dt);
+}
+
+TEST(RigidBodyWorld, EqualSpheresSwapVelocitiesWithFullRestitution)
+{
+    phys::WorldSettings settings;
+    settings.gravity = maths::Vector3::zero();
+    settings.restitution = 1.f;
+    settings.friction = 0.f;
+    phys::RigidBodyWorld world(settings);
+    const int a = world.add_sphere({{-1.f, 0.f, 0.f}, 0.5f}, 1.f, {5.f, 0.f, 0.f});
+    const int b = world.add_sphere({{1.f, 0.f, 0.f}, 0.5f}, 1.f, {-5.f, 0.f, 0.f});
+
+    for (int i = 0; i < 30; ++i)
+    {
+        world.step(c_dt);
+    }
+
+    EXPECT_NEAR(world.velocity(a).x, -5.f, 0.1f);
+    EXPECT_NEAR(world.velocity(b).x, 5.f, 0.1f);
+    EXPECT_NEAR(world.velocity(a).x + world.velocity(b).x, 0.f, 1e-4f);
+}
+
+TEST(RigidBodyWorld, BoxStackSettles)
+{
+    phys::RigidBodyWorld world;
+    add_floor(world);
+    int top = -1;
+    for (int i = 0; i < 5; ++i)
+    {
+        top = world.add_box({{-0.5f, (float)i, -0.5f}, {0.5f, (float)i + 1.f, 0.5f}}, 1.f);
+    }
+
+    for (int i = 0; i < 600; ++i)
+    {
+        world.step(c_dt);
+    }
+
+    EXPECT_NEAR(world.position(top).y, 4.5f, 0.05f);
+    EXPECT_NEAR(world.position(top).x, 0.f, 1e-3f);
+    EXPECT_LT(world.kinetic_energy(), 1e-3f);
+}
+
+TEST(RigidBodyWorld, FrictionStopsSlidingAndSpinsSpheres)
+{
+    phys::RigidBodyWorld world;
+    add_floor(world);
+    const int sphere = world.add_sphere({{0.f, 0.5f, 0.f}, 0.5f}, 1.f, {3.f, 0.f, 0.f});
+
+    for (int i = 0; i < 120; ++i)
+    {
+        world.step(c_dt);
+    }
+
+    //rolling without slipping, contact point at rest so v = w x r
+    const float speed = world.velocity(sphere).x;
+    EXPECT_GT(speed, 0.f);
+    EXPECT_NEAR(-world.angular_velocity(sphere).z * 0.5f, speed, 0.05f);
+}
+
+TEST(RigidBodyWorld, SeparateStacksAreSeparateIslands)
+{
+    phys::RigidBodyWorld world;
+    add_floor(world);
+    for (float x : {-3.f, 3.f})
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            world.add_box({{x - 0.5f, (float)i, -0.5f}, {x + 0.5f, (float)i + 1.f, 0.5f}}, 1.f);
+        }
+    }
+
+    for (int i = 0; i < 60; ++i)
+    {
+        world.step(c_dt);
+    }
+
+    //both stacks touch the floor, but static bodies don't join islands
+    EXPECT_EQ(world.island_count(), 2);
+}
+
+TEST(RigidBodyWorld, ThreadCountDoesntChangeResults)
+{
+    auto simulate = [](int thread_count)
+    {
+        auto world = std::make_unique<phys::RigidBodyWorld>();
+        //low enough that the big pile is coloured as well
+        world->settings().colouring_threshold = 32;
+        build_launch_scene(*world, 100, 4);
+
+        re::TaskManager tasks(thread_count);
+        use_task_manager(*world, tasks);
+        for (int i = 0; i < 120; ++i)
+        {
+            world->step(c_dt);
+        }
+        world->set_parallel_for({});
+        return world;
+    };
+
+    auto single = simulate(0);
+    auto multi = simulate(4);
+
+    ASSERT_EQ(single->body_count(), multi->body_count());
+    ASSERT_GT(single->contacts().size(), 0u);
+    for (int i = 0; i < single->body_count(); ++i)
+    {
+        ASSERT_TRUE(bitwise_equal(single->position(i), multi->position(i))) << "body " << i;
+        ASSERT_TRUE(bitwise_equal(single->velocity(i), multi->velocity(i))) << "body " << i;
+        ASSERT_TRUE(bitwise_equal(single->angular_velocity(i), multi->angular_velocity(i))) << "body " << i;
+        ASSERT_TRUE(bitwise_equal(single->orientation(i), multi->orientation(i))) << "body " << i;
+    }
+}
+
+TEST(RigidBodyWorld, BroadphaseDoesntChangeResults)
+{
+    //pairs are sorted whichever broadphase finds them, so contacts and results are identical
+    auto simulate = [](std::unique_ptr<phys::Broadphase> broadphase)
+    {
+        auto world = std::make_unique<phys::RigidBodyWorld>();
+        if (broadphase)
+        {
+            world->set_broadphase(std::move(broadphase));
+        }
+        build_launch_scene(*world, 100, 4);
+        for (int i = 0; i < 120; ++i)
+        {
+            world->step(c_dt);
+        }
+        return world;
+    };
+
+    auto bvh = simulate(nullptr);
+    auto hash = simulate(std::make_unique<phys::SpatialHash>(1.f));
+
+    ASSERT_GT(bvh->contacts().size(), 0u);
+    ASSERT_EQ(bvh->contacts().size(), hash->contacts().size());
+    for (int i = 0; i < bvh->body_count(); ++i)
+    {
+        ASSERT_TRUE(bitwise_equal(bvh->position(i), hash->position(i))) << "body " << i;
+        ASSERT_TRUE(bitwise_equal(bvh->velocity(i), hash->velocity(i))) << "body " << i;
+    }
+}
+
+TEST(RigidBodyWorld, DISABLED_LaunchBenchmark)
+{
+    const int max_threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    for (int sphere_count : {100, 400})
+    for (int thread_count : {0, std::max(max_threads - 1, 1)})
+    {
+        phys::RigidBodyWorld world;
+        build_launch_scene(world, sphere_count, 5);
+        re::TaskManager tasks(thread_count);
+        use_task_manager(world, tasks);
+
+        constexpr int steps = 300;
+        auto start = std::chrono::steady_clock::now();
+        size_t contacts = 0;
+        for (int i = 0; i < steps; ++i)
+        {
+            world.step(c_dt);
+            contacts += world.contacts().size();
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::printf("%d bodies, %d threads: %.3f ms/step, %.1f manifolds/step, %d islands\n",
+            world.body_count(), thread_count + 1, 1000.0 * seconds / steps, (double)contacts / steps, world.island_count());
+    }
+}
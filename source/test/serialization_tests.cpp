@@ -0,0 +1,387 @@
+#include "return_engine/graphics_test.h"
+#include "return_engine/input_manager.h"
+#include "return_engine/scene.h"
+#include "return_engine/task_manager.h"
+#include "return_engine/visual_component.h"
+
+#include "gfx/gl_recorder.h"
+#include "gfx/graphics_manager.h"
+#include "file/compression.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    //fresh directory per test, removed afterwards
+    class SerializationTest : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            auto* test = ::testing::UnitTest::GetInstance()->current_test_info();
+            m_directory = std::filesystem::temp_directory_path() / "return_serialization_tests" / test->name();
+            std::filesystem::remove_all(m_directory);
+            std::filesystem::create_directories(m_directory);
+        }
+        void TearDown() override
+        {
+            std::filesystem::remove_all(m_directory);
+        }
+
+        std::filesystem::path m_directory;
+    };
+
+    std::string read_bytes(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    //every component type with varied settings and transforms
+    void fill_scene(re::Scene& scene, int count)
+    {
+        std::mt19937 random{17};
+        std::uniform_real_distribution<float> value{-100.f, 100.f};
+        std::uniform_real_distribution<float> unit{0.f, 1.f};
+        for (int i = 0; i < count; ++i)
+        {
+            re::Entity entity;
+            entity.pos = {value(random), value(random), value(random)};
+            entity.scale = {unit(random) + 0.1f, unit(random) + 0.1f, unit(random) + 0.1f};
+            entity.orientation = maths::Quaternion::from_euler({value(random), value(random), value(random)});
+            switch (i % 3)
+            {
+            case 0:
+                entity.visual_component = std::make_unique<re::VAOComponent>("mesh_" + std::to_string(i % 7), "material_" + std::to_string(i % 11), i % 2 ? "wall" : "");
+                break;
+            case 1:
+                entity.visual_component = std::make_unique<re::SphereComponent>(unit(random), maths::Vector3{unit(random), unit(random), unit(random)}, 3 + i % 40);
+                break;
+            case 2:
+                entity.visual_component = std::make_unique<re::CubeComponent>(maths::Vector3{unit(random), unit(random), unit(random)}, maths::Vector3{unit(random), unit(random), unit(random)});
+                break;
+            }
+            scene.add_entity(std::move(entity));
+        }
+    }
+
+    void expect_same_entities(const re::Scene& loaded, const re::Scene& original)
+    {
+        ASSERT_EQ(loaded.entity_count(), original.entity_count());
+        for (int i = 0; i < original.entity_count(); ++i)
+        {
+            auto& a = loaded.entity(i);
+            auto& b = original.entity(i);
+            ASSERT_TRUE(a.pos == b.pos) << i;
+            ASSERT_TRUE(a.scale == b.scale) << i;
+            ASSERT_TRUE(a.orientation == b.orientation) << i;
+            ASSERT_EQ(a.visual_component->type(), b.visual_component->type()) << i;
+            auto a_bounds = a.visual_component->local_bounds();
+            auto b_bounds = b.visual_component->local_bounds();
+            ASSERT_TRUE(a_bounds.min == b_bounds.min && a_bounds.max == b_bounds.max) << i;
+        }
+    }
+
+    double seconds_since(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+TEST_F(SerializationTest, SceneRoundTrips)
+{
+    gfx::GLRecorder recorder;
+    gfx::GraphicsManager manager;
+    re::InputManager input;
+
+    re::Scene original(manager, input);
+    fill_scene(original, 1000);
+    const auto path = m_directory / "original.scene";
+    original.save(path);
+
+    re::Scene loaded(manager, input);
+    loaded.load(path);
+    expect_same_entities(loaded, original);
+
+    //saving what was loaded gives back the same bytes, covering what the entity checks can't see
+    const auto resaved = m_directory / "resaved.scene";
+    loaded.save(resaved);
+    EXPECT_EQ(read_bytes(resaved), read_bytes(path));
+}
+
+TEST_F(SerializationTest, MissingVisualComponentStaysMissing)
+{
+    const auto path = m_directory / "components";
+    {
+        auto file = file::FileOut::from_absolute(path.string().c_str());
+        std::unique_ptr<re::VisualComponent> none;
+        std::unique_ptr<re::VisualComponent> cube = std::make_unique<re::CubeComponent>(maths::Vector3{1.f, 2.f, 3.f}, maths::Vector3::one());
+        file << none << cube;
+    }
+
+    //read over components that already exist, as loading into a default entity does
+    auto file = file::FileIn::from_absolute(path.string().c_str());
+    std::unique_ptr<re::VisualComponent> first = std::make_unique<re::VAOComponent>();
+    std::unique_ptr<re::VisualComponent> second = std::make_unique<re::SphereComponent>();
+    file >> first >> second;
+    EXPECT_EQ(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(second->type(), re::VisualComponentType::Cube);
+    EXPECT_TRUE(second->local_bounds().max == (maths::Vector3{0.5f, 1.f, 1.5f}));
+}
+
+TEST_F(SerializationTest, EntitiesWithoutComponentsLoadAndDraw)
+{
+    gfx::GLRecorder recorder;
+    gfx::GraphicsManager manager;
+    re::InputManager input;
+    re::TaskManager tasks(1);
+
+    re::Scene original(manager, input);
+    fill_scene(original, 10);
+    re::Entity empty;
+    empty.visual_component = nullptr;
+    original.add_entity(std::move(empty));
+    const auto path = m_directory / "empty.scene";
+    original.save(path);
+
+    //loading relinks, then a frame is simulated and drawn
+    re::Scene loaded(manager, input);
+    loaded.load(path);
+    ASSERT_EQ(loaded.entity_count(), 11);
+    EXPECT_EQ(loaded.entity(10).visual_component, nullptr);
+    loaded.begin_simulation(1.f / 60.f, tasks);
+    tasks.finish_tasks();
+    loaded.draw(1.f);
+}
+
+TEST_F(SerializationTest, EditorDataRoundTrips)
+{
+    re::GraphicsTestEditor::Data data;
+    data.m_vertex_buffers = {re::VertexBuffer::create_triangle_buffer(), re::VertexBuffer::create_triangle_buffer()};
+    data.m_element_buffers.resize(2);
+    data.m_vertex_shaders = {re::VertexShader::create_triangle_shader()};
+    data.m_fragment_shaders = {re::FragmentShader::create_triangle_shader()};
+    data.m_shader_programs = {re::ShaderProgram::create_default_triangle_program()};
+    data.m_vertex_array_objects = {re::VertexArrayObject::create_default_triangle_vao()};
+    data.m_textures = {re::Texture::default_wall_texture()};
+
+    const auto path = m_directory / "editor_state";
+    {
+        auto file = file::FileOut::from_absolute(path.string().c_str());
+        data.write(file);
+    }
+    re::GraphicsTestEditor::Data loaded;
+    {
+        auto file = file::FileIn::from_absolute(path.string().c_str());
+        loaded.read(file);
+    }
+
+    ASSERT_EQ(loaded.m_vertex_buffers.size(), 2u);
+    EXPECT_EQ(loaded.m_vertex_buffers[1].name(), data.m_vertex_buffers[1].name());
+    //not saved itself, has to come back from the data
+    EXPECT_EQ(loaded.m_vertex_buffers[1].num_vertices(), 3);
+    EXPECT_EQ(loaded.m_vertex_buffers[1].total_size(), data.m_vertex_buffers[1].total_size());
+    EXPECT_EQ(loaded.m_element_buffers.size(), 2u);
+    ASSERT_EQ(loaded.m_vertex_shaders.size(), 1u);
+    EXPECT_EQ(loaded.m_vertex_shaders[0].source(), data.m_vertex_shaders[0].source());
+    ASSERT_EQ(loaded.m_shader_programs.size(), 1u);
+    EXPECT_EQ(loaded.m_shader_programs[0].vertex_shader(), data.m_shader_programs[0].vertex_shader());
+    ASSERT_EQ(loaded.m_vertex_array_objects.size(), 1u);
+    EXPECT_EQ(loaded.m_vertex_array_objects[0].vertex_buffer_name(), data.m_vertex_array_objects[0].vertex_buffer_name());
+    ASSERT_EQ(loaded.m_textures.size(), 1u);
+    EXPECT_EQ(loaded.m_textures[0].texture_filename(), data.m_textures[0].texture_filename());
+
+    const auto resaved = m_directory / "resaved";
+    {
+        auto file = file::FileOut::from_absolute(resaved.string().c_str());
+        loaded.write(file);
+    }
+    EXPECT_EQ(read_bytes(resaved), read_bytes(path));
+}
+
+TEST_F(SerializationTest, StringWritesCreateMissingDirectories)
+{
+    const auto path = m_directory / "profiler" / "nested" / "capture.json";
+    ASSERT_TRUE(file::write_string_to_absolute(path.string().c_str(), "{}"));
+    EXPECT_EQ(file::read_string_from_absolute(path.string().c_str()), "{}");
+}
+
+TEST_F(SerializationTest, SceneRoundTripsThroughMemory)
+{
+    gfx::GLRecorder recorder;
+    gfx::GraphicsManager manager;
+    re::InputManager input;
+
+    re::Scene original(manager, input);
+    fill_scene(original, 1000);
+    std::vector<uint8_t> bytes;
+    {
+        auto out = file::FileOut::to_memory(bytes);
+        original.write(out);
+        EXPECT_TRUE(out.valid());
+    }
+
+    re::Scene loaded(manager, input);
+    auto in = file::FileIn::from_memory(bytes);
+    loaded.read(in);
+    EXPECT_TRUE(in.valid());
+    expect_same_entities(loaded, original);
+
+    //the same format either way, saves are compressed
+    std::vector<uint8_t> compressed;
+    {
+        auto out = file::FileOut::to_memory(compressed, file::Compression::Blocks);
+        original.write(out);
+    }
+    const auto path = m_directory / "original.scene";
+    original.save(path);
+    EXPECT_EQ(read_bytes(path), std::string(compressed.begin(), compressed.end()));
+    EXPECT_LT(compressed.size(), bytes.size());
+}
+
+TEST_F(SerializationTest, UncompressedScenesStillLoad)
+{
+    gfx::GLRecorder recorder;
+    gfx::GraphicsManager manager;
+    re::InputManager input;
+
+    re::Scene original(manager, input);
+    fill_scene(original, 100);
+    const auto path = m_directory / "uncompressed.scene";
+    {
+        auto file = file::FileOut::from_absolute(path.string().c_str());
+        original.write(file);
+    }
+
+    re::Scene loaded(manager, input);
+    loaded.load(path);
+    expect_same_entities(loaded, original);
+}
+
+TEST_F(SerializationTest, MemoryReadsStopAtTheEnd)
+{
+    std::vector<uint8_t> bytes = {7};
+    {
+        //appends to what's already there
+        auto out = file::FileOut::to_memory(bytes);
+        out << (int32_t)-5 << std::string("text");
+    }
+    ASSERT_EQ(bytes.size(), 1u + 4u + sizeof(size_t) + 4u);
+
+    auto in = file::FileIn::from_memory(std::span(bytes).subspan(1));
+    int32_t number = 0;
+    std::string text;
+    in >> number >> text;
+    EXPECT_EQ(number, -5);
+    EXPECT_EQ(text, "text");
+    EXPECT_TRUE(in.valid());
+
+    //past the end reads as default and leaves it invalid, as a file does
+    int32_t missing = 3;
+    in >> missing;
+    EXPECT_EQ(missing, 0);
+    EXPECT_FALSE(in.valid());
+}
+
+TEST_F(SerializationTest, DISABLED_SceneBenchmark)
+{
+    gfx::GLRecorder recorder;
+    gfx::GraphicsManager manager;
+    re::InputManager input;
+    re::TaskManager tasks(std::max(1, (int)std::thread::hardware_concurrency() - 1));
+
+    for (int count : {1000, 100000, 1000000})
+    {
+        re::Scene original(manager, input);
+        fill_scene(original, count);
+        const auto path = m_directory / "benchmark.scene";
+
+        //write and read alone, save and load also relink and check the file's time
+        auto start = std::chrono::steady_clock::now();
+        {
+            auto file = file::FileOut::from_absolute(path.string().c_str());
+            original.write(file);
+        }
+        const double file_write_seconds = seconds_since(start);
+        const double megabytes = std::filesystem::file_size(path) / (1024.0 * 1024.0);
+
+        re::Scene from_file(manager, input);
+        start = std::chrono::steady_clock::now();
+        {
+            auto file = file::FileIn::from_absolute(path.string().c_str());
+            from_file.read(file);
+        }
+        const double file_read_seconds = seconds_since(start);
+
+        std::vector<uint8_t> bytes;
+        start = std::chrono::steady_clock::now();
+        {
+            auto memory = file::FileOut::to_memory(bytes);
+            original.write(memory);
+        }
+        const double memory_write_seconds = seconds_since(start);
+
+        re::Scene from_memory(manager, input);
+        start = std::chrono::steady_clock::now();
+        {
+            auto memory = file::FileIn::from_memory(bytes);
+            from_memory.read(memory);
+        }
+        const double memory_read_seconds = seconds_since(start);
+
+        //compressed, speeds are of the uncompressed size
+        const auto compressed_path = m_directory / "compressed.scene";
+        start = std::chrono::steady_clock::now();
+        {
+            auto file = file::FileOut::from_absolute(compressed_path.string().c_str(), file::Compression::Blocks);
+            original.write(file);
+        }
+        const double compressed_write_seconds = seconds_since(start);
+        const double compressed_megabytes = std::filesystem::file_size(compressed_path) / (1024.0 * 1024.0);
+
+        re::Scene from_compressed(manager, input);
+        start = std::chrono::steady_clock::now();
+        {
+            auto file = file::FileIn::from_absolute(compressed_path.string().c_str());
+            from_compressed.read(file);
+        }
+        const double compressed_read_seconds = seconds_since(start);
+
+        //decompression alone, on one thread and across the task manager's
+        const auto stream = read_bytes(compressed_path);
+        const std::span<const uint8_t> stream_bytes((const uint8_t*)stream.data(), stream.size());
+        start = std::chrono::steady_clock::now();
+        auto serial = file::decompress_stream(stream_bytes);
+        const double serial_seconds = seconds_since(start);
+        start = std::chrono::steady_clock::now();
+        auto parallel = file::decompress_stream(stream_bytes, [&tasks](int count, const std::function<void(int)>& task)
+        {
+            tasks.run_tasks(task, 0, count);
+        });
+        const double parallel_seconds = seconds_since(start);
+        ASSERT_TRUE(serial && parallel && *serial == bytes && *parallel == bytes);
+
+        std::printf("%7d entities, %6.2f MB: file write %6.1f MB/s, read %6.1f MB/s. memory write %6.1f MB/s, read %6.1f MB/s\n",
+            count, megabytes, megabytes / file_write_seconds, megabytes / file_read_seconds,
+            megabytes / memory_write_seconds, megabytes / memory_read_seconds);
+        std::printf("%7s compressed %6.2f MB, ratio %.2f: write %6.1f MB/s, read %6.1f MB/s. decompress %6.1f MB/s, %d threads %6.1f MB/s\n",
+            "", compressed_megabytes, megabytes / compressed_megabytes, megabytes / compressed_write_seconds, megabytes / compressed_read_seconds,
+            megabytes / serial_seconds, tasks.thread_count() + 1, megabytes / parallel_seconds);
+        expect_same_entities(from_file, original);
+        expect_same_entities(from_memory, original);
+        expect_same_entities(from_compressed, original);
+    }
+}
@@ -0,0 +1,200 @@
+#include "physics/bvh.h"
+#include "physics/spatial_hash.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+
+namespace
+{
+    //similar sized boxes, the workload the grid is meant for
+    std::vector<phys::AABB3> random_bounds(int count, float extent, uint32_t seed = 4321)
+    {
+        std::mt19937 random{seed};
+        std::uniform_real_distribution<float> position{-extent, extent};
+        std::uniform_real_distribution<float> size{0.2f, 1.f};
+        std::vector<phys::AABB3> bounds;
+        for (int i = 0; i < count; ++i)
+        {
+            const maths::Vector3 min = {position(random), position(random), position(random)};
+            bounds.push_back({min, min + maths::Vector3{size(random), size(random), size(random)}});
+        }
+        return bounds;
+    }
+
+    std::vector<phys::BodyPair> brute_force_pairs(const std::vector<phys::AABB3>& bounds)
+    {
+        std::vector<phys::BodyPair> pairs;
+        for (int a = 0; a < (int)bounds.size(); ++a)
+        {
+            for (int b = a + 1; b < (int)bounds.size(); ++b)
+            {
+                if (phys::intersects(bounds[a], bounds[b]))
+                {
+                    pairs.push_back({a, b});
+                }
+            }
+        }
+        return pairs;
+    }
+
+    double seconds_since(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+TEST(SpatialHash, PairsMatchBruteForce)
+{
+    //cells smaller than some items so pairs meet in several cells
+    auto bounds = random_bounds(800, 8.f);
+    phys::SpatialHash grid(0.5f);
+    grid.build(bounds);
+
+    auto expected = brute_force_pairs(bounds);
+    ASSERT_FALSE(expected.empty());
+    std::vector<phys::BodyPair> pairs;
+    grid.find_pairs(pairs);
+    EXPECT_EQ(pairs, expected);
+
+    //items straddling negative coordinates and cell boundaries after moving
+    std::mt19937 random{5};
+    std::uniform_real_distribution<float> offset{-0.6f, 0.6f};
+    for (auto& item : bounds)
+    {
+        const maths::Vector3 move = {offset(random), offset(random), offset(random)};
+        item.min += move;
+        item.max += move;
+    }
+    grid.refit(bounds);
+    grid.find_pairs(pairs);
+    EXPECT_EQ(pairs, brute_force_pairs(bounds));
+}
+
+TEST(SpatialHash, QueryMatchesBruteForce)
+{
+    const auto bounds = random_bounds(800, 8.f);
+    phys::SpatialHash grid(1.f);
+    grid.build(bounds);
+
+    std::mt19937 random{8};
+    std::uniform_real_distribution<float> position{-8.f, 8.f};
+    for (int test = 0; test < 50; ++test)
+    {
+        const maths::Vector3 min = {position(random), position(random), position(random)};
+        const phys::AABB3 aabb = {min, min + maths::Vector3{3.f, 2.f, 1.f}};
+
+        std::vector<int> expected;
+        for (int i = 0; i < (int)bounds.size(); ++i)
+        {
+            if (phys::intersects(aabb, bounds[i]))
+            {
+                expected.push_back(i);
+            }
+        }
+
+        std::vector<int> found;
+        grid.query(aabb, found);
+        std::sort(found.begin(), found.end());
+        EXPECT_EQ(found, expected);
+    }
+}
+
+TEST(SpatialHash, RefitOnlyMovesItemsChangingCell)
+{
+    std::vector<phys::AABB3> bounds = {
+        {{0.1f, 0.1f, 0.1f}, {0.4f, 0.4f, 0.4f}},
+        {{2.1f, 0.1f, 0.1f}, {2.4f, 0.4f, 0.4f}},
+        {{4.1f, 0.1f, 0.1f}, {4.4f, 0.4f, 0.4f}},
+    };
+    phys::SpatialHash grid(1.f);
+    grid.build(bounds);
+    EXPECT_EQ(grid.cell_count(), 3);
+
+    //first moves within its cell, second into the third's
+    bounds[0].max.x = 0.9f;
+    bounds[1] = {{4.2f, 0.2f, 0.2f}, {4.5f, 0.5f, 0.5f}};
+    grid.refit(bounds);
+    EXPECT_EQ(grid.moved_count(), 1);
+    EXPECT_EQ(grid.cell_count(), 2);
+
+    std::vector<phys::BodyPair> pairs;
+    grid.find_pairs(pairs);
+    EXPECT_EQ(pairs, (std::vector<phys::BodyPair>{{1, 2}}));
+}
+
+TEST(SpatialHash, SwapsWithBVH)
+{
+    const auto bounds = random_bounds(500, 6.f);
+    std::unique_ptr<phys::Broadphase> broadphases[] = {
+        std::make_unique<phys::BVH>(),
+        std::make_unique<phys::SpatialHash>(1.f),
+    };
+
+    std::vector<phys::BodyPair> pairs[2];
+    for (int i = 0; i < 2; ++i)
+    {
+        broadphases[i]->build(bounds);
+        broadphases[i]->find_pairs(pairs[i]);
+    }
+    EXPECT_EQ(pairs[0], pairs[1]);
+}
+
+TEST(SpatialHash, DISABLED_BenchmarkAgainstBVH)
+{
+    //boxes drifting a little each frame, refit and find pairs as a world step would
+    constexpr int count = 20000;
+    constexpr int frames = 20;
+    const auto start_bounds = random_bounds(count, 40.f);
+    std::mt19937 random{11};
+    std::uniform_real_distribution<float> speed{-0.05f, 0.05f};
+    std::vector<maths::Vector3> velocities(count);
+    for (auto& velocity : velocities)
+    {
+        velocity = {speed(random), speed(random), speed(random)};
+    }
+
+    auto measure = [&](const char* name, phys::Broadphase& broadphase)
+    {
+        auto bounds = start_bounds;
+        std::vector<phys::BodyPair> pairs;
+
+        auto start = std::chrono::steady_clock::now();
+        broadphase.build(bounds);
+        const double build_seconds = seconds_since(start);
+
+        double refit_seconds = 0.0;
+        double pair_seconds = 0.0;
+        size_t pair_count = 0;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                bounds[i].min += velocities[i];
+                bounds[i].max += velocities[i];
+            }
+            start = std::chrono::steady_clock::now();
+            broadphase.refit(bounds);
+            refit_seconds += seconds_since(start);
+
+            start = std::chrono::steady_clock::now();
+            broadphase.find_pairs(pairs);
+            pair_seconds += seconds_since(start);
+            pair_count += pairs.size();
+        }
+        std::printf("%-12s build %7.2f ms, refit %6.2f ms/frame, find pairs %7.2f ms/frame, %zu pairs\n",
+            name, 1e3 * build_seconds, 1e3 * refit_seconds / frames, 1e3 * pair_seconds / frames, pair_count);
+        return pair_count;
+    };
+
+    phys::BVH bvh;
+    phys::SpatialHash grid(1.f);
+    const auto bvh_pairs = measure("bvh", bvh);
+    const auto grid_pairs = measure("spatial hash", grid);
+    std::printf("grid moved %d of %d items last frame\n", grid.moved_count(), count);
+    EXPECT_EQ(bvh_pairs, grid_pairs);
+}
@@ -0,0 +1,91 @@
+#include "return_engine/undo_history.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+    struct TestAsset : re::Revisioned
+    {
+        std::vector<uint8_t> bytes;
+    };
+
+    size_t memory_size(const TestAsset& asset)
+    {
+        return asset.bytes.size();
+    }
+
+    std::vector<TestAsset> make_assets(int count, size_t size)
+    {
+        std::vector<TestAsset> assets(count);
+        for (auto& asset : assets)
+        {
+            asset.bytes.resize(size);
+        }
+        return assets;
+    }
+}
+
+TEST(UndoHistory, UnchangedAssetsAreShared)
+{
+    auto assets = make_assets(4, 1000);
+    re::AssetNodes<TestAsset> first, second;
+
+    EXPECT_EQ(re::record_assets(assets, {}, first), 4000u);
+
+    assets[2].bytes.push_back(1);
+    assets[2].new_revision();
+    EXPECT_EQ(re::record_assets(assets, first, second), 1001u);
+
+    EXPECT_EQ(first[0], second[0]);
+    EXPECT_EQ(first[1], second[1]);
+    EXPECT_NE(first[2], second[2]);
+    EXPECT_EQ(first[3], second[3]);
+    EXPECT_EQ(second[2]->bytes.size(), 1001u);
+    EXPECT_EQ(first[2]->bytes.size(), 1000u);
+}
+
+TEST(UndoHistory, MovedAndAddedAssetsAreFound)
+{
+    auto assets = make_assets(3, 10);
+    re::AssetNodes<TestAsset> first, second;
+    re::record_assets(assets, {}, first);
+
+    std::swap(assets[0], assets[2]);
+    assets.push_back({});
+    EXPECT_EQ(re::record_assets(assets, first, second), 0u);
+
+    EXPECT_EQ(second[0], first[2]);
+    EXPECT_EQ(second[2], first[0]);
+    EXPECT_NE(assets[3].revision(), 0u);
+}
+
+TEST(UndoHistory, RestoreOnlyCopiesChangedAssets)
+{
+    auto assets = make_assets(2, 10);
+    re::AssetNodes<TestAsset> recorded;
+    re::record_assets(assets, {}, recorded);
+
+    assets[1].bytes.clear();
+    assets[1].new_revision();
+    assets.push_back({});
+    const uint8_t* untouched = assets[0].bytes.data();
+
+    re::restore_assets(recorded, assets);
+
+    ASSERT_EQ(assets.size(), 2u);
+    EXPECT_EQ(assets[0].bytes.data(), untouched);
+    EXPECT_EQ(assets[1].bytes.size(), 10u);
+    EXPECT_EQ(assets[1].revision(), recorded[1]->revision());
+}
+
+TEST(UndoHistory, ReleaseOnlyCountsUnsharedNodes)
+{
+    auto assets = make_assets(2, 100);
+    re::AssetNodes<TestAsset> first, second;
+    re::record_assets(assets, {}, first);
+    assets[0].new_revision();
+    re::record_assets(assets, first, second);
+
+    EXPECT_EQ(re::release_assets(first), 100u);
+    EXPECT_EQ(re::release_assets(second), 200u);
+}